@@ -6,8 +6,13 @@ TEMPLATE = app
 TARGET = 
 DEPENDPATH += .
 INCLUDEPATH += .
+QMAKE_CXXFLAGS += -std=c++11
+
+# Game engine static library - build engine/engine.pro first
+LIBS += -Lengine -lengine
+PRE_TARGETDEPS += engine/libengine.a
 
 # Input
-HEADERS += blackjack.h card.h deck.h hand.h handview.h
-SOURCES += blackjack.cpp card.cpp deck.cpp hand.cpp handview.cpp main.cpp
+HEADERS += blackjack.h card.h hand.h handview.h
+SOURCES += blackjack.cpp card.cpp hand.cpp handview.cpp main.cpp
 RESOURCES += Blackjack.qrc
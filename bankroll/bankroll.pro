@@ -0,0 +1,19 @@
+######################################################################
+# Command line bankroll and risk of ruin simulator - no Qt dependency
+######################################################################
+
+TEMPLATE = app
+CONFIG += console thread
+CONFIG -= qt app_bundle
+TARGET = blackjack-bankroll
+DEPENDPATH += . ../sim
+INCLUDEPATH += . ..
+QMAKE_CXXFLAGS += -std=c++11
+
+# Game engine static library - build ../engine/engine.pro first
+LIBS += -L../engine -lengine -lpthread
+PRE_TARGETDEPS += ../engine/libengine.a
+
+# Input
+HEADERS += ../sim/basicstrategy.h bankrollsimulator.h
+SOURCES += ../sim/basicstrategy.cpp bankrollsimulator.cpp main.cpp
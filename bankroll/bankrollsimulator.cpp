@@ -0,0 +1,280 @@
+#include <math.h>
+#include <algorithm>
+#include <thread>
+#include "engine/rng.h"
+#include "engine/round.h"
+#include "engine/rules.h"
+#include "sim/basicstrategy.h"
+#include "bankrollsimulator.h"
+
+// Normal quantile of the 95% confidence intervals
+static const double Z95 = 1.959964;
+
+/**
+ * The BankrollResult struct constructor.
+ * All tallies start at zero.
+ */
+BankrollResult::BankrollResult() : trajectories(0), ruined(0), rounds(0), balanceSum(0.0),
+                                   balanceSquares(0.0), converged(false)
+{}
+
+/**
+ * Member function that adds one trajectory to the tally.
+ * @param trajectory How the trajectory ended
+ */
+void BankrollResult::add(const Trajectory &trajectory)
+{
+	++trajectories;
+	rounds += trajectory.rounds;
+	if(trajectory.ruined)
+	{
+		++ruined;
+		ruinRounds.push_back(trajectory.rounds);
+	}
+	double balance = static_cast<double>(trajectory.balance);
+	balanceSum += balance;
+	balanceSquares += balance * balance;
+	finalBalances.push_back(trajectory.balance);
+}
+
+/**
+ * Member function that returns the risk of ruin.
+ * @return Fraction of trajectories that went broke
+ */
+double BankrollResult::riskOfRuin() const
+{
+	if(trajectories == 0) return 0.0;
+	return static_cast<double>(ruined) / trajectories;
+}
+
+/**
+ * Member function that returns the half-width of the 95% confidence
+ * interval of the risk of ruin.
+ * This is the Wilson score interval, which unlike the normal one does not
+ * shrink to nothing when no or every trajectory went broke.
+ * @return Half-width of the interval around riskOfRuin()
+ */
+double BankrollResult::riskOfRuinError() const
+{
+	if(trajectories == 0) return 1.0;
+	double n = static_cast<double>(trajectories);
+	double p = riskOfRuin();
+	double z2 = Z95 * Z95;
+	return Z95 / (1.0 + z2 / n) * sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n));
+}
+
+/**
+ * Member function that returns the mean final balance.
+ * @return Money left on average, ruined trajectories included
+ */
+double BankrollResult::meanBalance() const
+{
+	if(trajectories == 0) return 0.0;
+	return balanceSum / trajectories;
+}
+
+/**
+ * Member function that returns the half-width of the 95% confidence
+ * interval of the mean final balance.
+ * @return Half-width of the interval around meanBalance()
+ */
+double BankrollResult::meanBalanceError() const
+{
+	if(trajectories < 2) return HUGE_VAL;
+	double mean = meanBalance();
+	double variance = (balanceSquares / trajectories - mean * mean) * trajectories / (trajectories - 1);
+	return Z95 * sqrt(variance > 0.0 ? variance / trajectories : 0.0);
+}
+
+/**
+ * Member function that returns a quantile of the rounds to ruin.
+ * Only the trajectories that went broke count.
+ * @param fraction The quantile, 0.5 for the median
+ * @return Rounds played until ruin, 0 if no trajectory went broke
+ */
+uint64_t BankrollResult::roundsToRuin(double fraction) const
+{
+	if(ruinRounds.empty()) return 0;
+	size_t i = static_cast<size_t>(fraction * (ruinRounds.size() - 1) + 0.5);
+	return ruinRounds[std::min(i, ruinRounds.size() - 1)];
+}
+
+/**
+ * Member function that returns a quantile of the final balance.
+ * @param fraction The quantile, 0.5 for the median
+ * @return Money left at that quantile
+ */
+int64_t BankrollResult::balanceAt(double fraction) const
+{
+	if(finalBalances.empty()) return 0;
+	size_t i = static_cast<size_t>(fraction * (finalBalances.size() - 1) + 0.5);
+	return finalBalances[std::min(i, finalBalances.size() - 1)];
+}
+
+/**
+ * The BankrollSimulator class constructor.
+ * @param bankroll Money each trajectory starts with
+ * @param betRamp Bet at each Hi-Lo true count, starting at 0 or below; the
+ * last bet is kept for higher counts. Must not be empty
+ * @param horizon Rounds each trajectory plays unless it goes broke first
+ * @param variant Rules played, an engine::VariantId
+ * @param numDecks Number of decks in each trajectory's shoe, 0 for the variant's
+ * @param penetration Fraction of the shoe dealt before reshuffling
+ */
+BankrollSimulator::BankrollSimulator(int bankroll, const std::vector<int> &betRamp, uint64_t horizon,
+                                     int variant, int numDecks, double penetration) :
+m_bankroll(bankroll), m_betRamp(betRamp), m_horizon(horizon), m_variant(variant),
+m_numDecks(numDecks), m_penetration(penetration), m_ruinTolerance(0.005), m_balanceTolerance(0.02)
+{}
+
+/**
+ * Member function that returns the bet at a true count.
+ * @param trueCount The Hi-Lo true count, rounded down
+ * @return Bet of the ramp at that count
+ */
+int BankrollSimulator::betAt(int trueCount) const
+{
+	int i = std::max(0, std::min(trueCount, static_cast<int>(m_betRamp.size()) - 1));
+	return m_betRamp[i];
+}
+
+/**
+ * Struct that picks the trajectory body specialized for a variant.
+ */
+struct BankrollSimulator::PlayPicker
+{
+	typedef PlayFunction Result;
+	
+	template<class Rules>
+	Result visit() {return &BankrollSimulator::play<Rules>;}
+};
+
+/**
+ * Member function that runs the simulation.
+ * Trajectories are played a wave at a time until the confidence intervals
+ * are within the tolerances or maxTrajectories have been played.
+ * @param maxTrajectories Most trajectories to play
+ * @param numThreads Number of worker threads, at least 1
+ * @param seed Seed of the simulation
+ * @return Tally of all trajectories played
+ */
+BankrollResult BankrollSimulator::run(uint64_t maxTrajectories, int numThreads, uint64_t seed) const
+{
+	if(numThreads < 1) numThreads = 1;
+	
+	BankrollResult result;
+	PlayPicker picker;
+	PlayFunction play = engine::visitVariant(m_variant, picker);
+	std::vector<Trajectory> wave(WaveSize);
+	
+	for(uint64_t first = 0; first < maxTrajectories; first += WaveSize)
+	{
+		uint64_t count = std::min(WaveSize, maxTrajectories - first);
+		std::atomic<uint64_t> next(0);
+		std::vector<std::thread> workers;
+		
+		for(int i = 0; i < numThreads; ++i)
+		{
+			workers.push_back(std::thread(&BankrollSimulator::work, this, play, first, count,
+			                              seed, &next, wave.data()));
+		}
+		for(int i = 0; i < numThreads; ++i)
+		{
+			workers[i].join();
+		}
+		
+		// Tally in trajectory order, so that the result is the same for
+		// any number of threads
+		for(uint64_t i = 0; i < count; ++i)
+		{
+			result.add(wave[i]);
+		}
+		
+		if(result.riskOfRuinError() <= m_ruinTolerance &&
+		   result.meanBalanceError() <= m_balanceTolerance * m_bankroll)
+		{
+			result.converged = true;
+			break;
+		}
+	}
+	
+	std::sort(result.ruinRounds.begin(), result.ruinRounds.end());
+	std::sort(result.finalBalances.begin(), result.finalBalances.end());
+	return result;
+}
+
+/**
+ * Worker thread body.
+ * Claims the trajectories of a wave one at a time until none are left.
+ * @param play Trajectory body specialized for the variant
+ * @param first Index of the wave's first trajectory
+ * @param count Number of trajectories in the wave
+ * @param seed Seed of the simulation
+ * @param next Index within the wave of the next unclaimed trajectory
+ * @param wave Where to store how each trajectory of the wave ended
+ */
+void BankrollSimulator::work(PlayFunction play, uint64_t first, uint64_t count, uint64_t seed,
+                             std::atomic<uint64_t> *next, Trajectory *wave) const
+{
+	uint64_t i;
+	while((i = next->fetch_add(1, std::memory_order_relaxed)) < count)
+	{
+		(this->*play)(first + i, seed, &wave[i]);
+	}
+}
+
+/**
+ * Member function that plays one bankroll trajectory.
+ * @param index Index of the trajectory, which picks its random stream
+ * @param seed Seed of the simulation
+ * @param trajectory Where to store how the trajectory ended
+ * @tparam Rules RuleSet of the variant played
+ */
+template<class Rules>
+void BankrollSimulator::play(uint64_t index, uint64_t seed, Trajectory *trajectory) const
+{
+	engine::Rng rng(seed ^ engine::SplitMix64(index)());
+	engine::Shoe shoe(m_numDecks > 0 ? m_numDecks : Rules::NumDecks, m_penetration);
+	engine::Round round(shoe, rng);
+	const int minBet = *std::min_element(m_betRamp.begin(), m_betRamp.end());
+	int balance = m_bankroll;
+	int bet = 0;
+	uint64_t i = 0;
+	
+	shoe.shuffle(rng);
+	
+	while(i < m_horizon && balance + bet >= minBet)
+	{
+		// Pick the bet up and put down the ramp's bet for the count, or
+		// whatever is left
+		int trueCount = shoe.needsShuffle() ? 0 : static_cast<int>(floor(shoe.trueCount()));
+		balance += bet;
+		bet = std::min(betAt(trueCount), balance);
+		balance -= bet;
+		
+		round.deal();
+		++i;
+		
+		// The dealer checks for Blackjack under an Ace or a ten, so the
+		// player only acts when he has none
+		int extraWager = 0;
+		while(!round.dealer().isBlackjack() && !round.done())
+		{
+			switch(basicStrategy<Rules>(round, balance - extraWager >= bet))
+			{
+			case engine::Hit:        round.hit(); break;
+			case engine::DoubleDown: extraWager += bet; round.doubleDown(); break;
+			case engine::Split:      extraWager += bet; round.split(); break;
+			case engine::Surrender:  round.surrender(); break;
+			default:                 round.next(); break;
+			}
+		}
+		
+		round.stand<Rules>();
+		engine::settleNet(round.net<Rules>(bet), bet, balance);
+	}
+	
+	trajectory->rounds = i;
+	trajectory->balance = static_cast<int64_t>(balance) + bet;
+	trajectory->ruined = balance + bet < minBet;
+}
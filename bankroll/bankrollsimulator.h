@@ -0,0 +1,111 @@
+#ifndef BANKROLLSIMULATOR_H
+#define BANKROLLSIMULATOR_H
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+#include "engine/ruleset.h"
+#include "engine/shoe.h"
+
+/**
+ * Struct that holds how one bankroll trajectory ended.
+ */
+struct Trajectory
+{
+	uint64_t rounds;  /**< rounds played. */
+	int64_t balance;  /**< money left, on the table or not. */
+	bool ruined;      /**< the money left cannot cover the smallest bet, also when the last round left it so. */
+};
+
+/**
+ * Struct that holds the tally of simulated bankroll trajectories.
+ * Once BankrollSimulator::run() returns, the rounds to ruin and the final
+ * balances are sorted, so medians and percentiles are plain lookups.
+ */
+struct BankrollResult
+{
+	uint64_t trajectories;              /**< trajectories played. */
+	uint64_t ruined;                    /**< trajectories that went broke. */
+	uint64_t rounds;                    /**< rounds played by all trajectories. */
+	double balanceSum;                  /**< sum of the final balances. */
+	double balanceSquares;              /**< sum of the squared final balances. */
+	bool converged;                     /**< the run stopped early on the tolerances. */
+	std::vector<uint64_t> ruinRounds;   /**< rounds played by each ruined trajectory. */
+	std::vector<int64_t> finalBalances; /**< final balance of each trajectory. */
+	
+	BankrollResult();
+	
+	void add(const Trajectory &trajectory);
+	double riskOfRuin() const;
+	double riskOfRuinError() const;
+	double meanBalance() const;
+	double meanBalanceError() const;
+	uint64_t roundsToRuin(double fraction) const;
+	int64_t balanceAt(double fraction) const;
+};
+
+/**
+ * Class that simulates many independent bankroll trajectories.
+ * Each trajectory starts with the same roll and a fresh shoe, bets by the
+ * Hi-Lo true count and plays basic strategy until it is broke or has
+ * played the given number of rounds. Money is handled as in the game:
+ * the bet is taken from the balance as Blackjack::updateBet() does,
+ * doubles and splits need the money for them, and settleNet() settles
+ * the round. A trajectory is ruined when it cannot cover the smallest
+ * bet of the ramp, where the game would declare the player bankrupt.
+ *
+ * Trajectories are played in waves spread over worker threads, which
+ * claim them one at a time so that early ruins do not leave a worker
+ * idle. After every wave the confidence intervals are checked and the
+ * run stops once they are tight enough. Trajectory i always gets the
+ * same random stream for a seed, so results do not depend on the number
+ * of threads.
+ */
+class BankrollSimulator
+{
+public:
+	static const uint64_t WaveSize = 1024; /**< trajectories between convergence checks. */
+	
+	BankrollSimulator(int bankroll, const std::vector<int> &betRamp, uint64_t horizon,
+	                  int variant = engine::HouseVariant, int numDecks = 0,
+	                  double penetration = engine::Shoe::DefaultPenetration);
+	
+	/**
+	 * Member function that sets when a run may stop early.
+	 * Both 95% confidence intervals must be this narrow.
+	 * @param riskOfRuin Half-width of the risk of ruin interval, e.g. 0.005
+	 * @param balance Half-width of the mean final balance interval, as a
+	 * fraction of the starting roll
+	 */
+	void setTolerance(double riskOfRuin, double balance)
+	{
+		m_ruinTolerance = riskOfRuin;
+		m_balanceTolerance = balance;
+	}
+	
+	int betAt(int trueCount) const;
+	BankrollResult run(uint64_t maxTrajectories, int numThreads, uint64_t seed) const;
+
+private:
+	typedef void (BankrollSimulator::*PlayFunction)(uint64_t index, uint64_t seed,
+	                                                Trajectory *trajectory) const;
+	struct PlayPicker;
+	
+	template<class Rules>
+	void play(uint64_t index, uint64_t seed, Trajectory *trajectory) const;
+	
+	void work(PlayFunction play, uint64_t first, uint64_t count, uint64_t seed,
+	          std::atomic<uint64_t> *next, Trajectory *wave) const;
+
+private:
+	int m_bankroll;
+	std::vector<int> m_betRamp;
+	uint64_t m_horizon;
+	int m_variant;
+	int m_numDecks;
+	double m_penetration;
+	double m_ruinTolerance;
+	double m_balanceTolerance;
+};
+
+#endif
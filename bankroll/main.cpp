@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "bankrollsimulator.h"
+
+/**
+ * Helper function that prints the command line usage.
+ */
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+	        "Usage: %s [-m money] [-b ramp] [-a rounds] [-n trajectories] [-e tolerance] [-v tolerance] [-t threads] [-s seed] [-r rules] [-d decks] [-c penetration]\n"
+	        "  -m  money each trajectory starts with (default 1000)\n"
+	        "  -b  bets at Hi-Lo true count 0 or below, 1, 2, ... separated by commas;\n"
+	        "      the last bet is kept for higher counts (default 10)\n"
+	        "  -a  rounds each trajectory plays unless broke first (default 10000)\n"
+	        "  -n  most trajectories to play (default 1000000)\n"
+	        "  -e  stop once the risk of ruin is known to within this (default 0.005)\n"
+	        "  -v  ... and the mean final balance to within this fraction of -m (default 0.02)\n"
+	        "  -t  number of worker threads (default: all cores)\n"
+	        "  -s  random seed (default: current time)\n"
+	        "  -r  rules played: house, strip, downtown, atlantic or 6to5 (default house)\n"
+	        "  -d  number of decks in the shoe, 1 to 8 (default: as the rules say)\n"
+	        "  -c  fraction of the shoe dealt before reshuffling (default 0.8)\n",
+	        prog);
+}
+
+/**
+ * Helper function that reads a bet ramp.
+ * @param text Comma separated bets, e.g. "10,10,20,40"
+ * @param ramp Where to store the bets
+ * @return true: every bet is positive; false: the ramp is invalid
+ */
+static bool parseRamp(const char *text, std::vector<int> &ramp)
+{
+	ramp.clear();
+	while(*text != '\0')
+	{
+		char *end;
+		long bet = strtol(text, &end, 10);
+		if(end == text || bet <= 0 || (*end != ',' && *end != '\0'))
+		{
+			return false;
+		}
+		ramp.push_back(static_cast<int>(bet));
+		text = *end == ',' ? end + 1 : end;
+	}
+	return !ramp.empty();
+}
+
+int main(int argc, char *argv[])
+{
+	int bankroll = 1000;
+	std::vector<int> ramp;
+	uint64_t horizon = 10000;
+	uint64_t maxTrajectories = 1000000;
+	double ruinTolerance = 0.005;
+	double balanceTolerance = 0.02;
+	int numThreads = std::thread::hardware_concurrency();
+	uint64_t seed = time(0);
+	int variant = engine::HouseVariant;
+	int numDecks = 0;
+	double penetration = engine::Shoe::DefaultPenetration;
+	const char *rampText = "10";
+	int opt;
+	
+	while((opt = getopt(argc, argv, "m:b:a:n:e:v:t:s:r:d:c:h")) != -1)
+	{
+		switch(opt)
+		{
+		case 'm': bankroll = atoi(optarg); break;
+		case 'b': rampText = optarg; break;
+		case 'a': horizon = strtoull(optarg, 0, 10); break;
+		case 'n': maxTrajectories = strtoull(optarg, 0, 10); break;
+		case 'e': ruinTolerance = atof(optarg); break;
+		case 'v': balanceTolerance = atof(optarg); break;
+		case 't': numThreads = atoi(optarg); break;
+		case 's': seed = strtoull(optarg, 0, 10); break;
+		case 'r': variant = engine::findVariant(optarg); break;
+		case 'd': numDecks = atoi(optarg); break;
+		case 'c': penetration = atof(optarg); break;
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	
+	if(numThreads < 1) numThreads = 1;
+	if(variant < 0 || bankroll <= 0 || !parseRamp(rampText, ramp))
+	{
+		usage(argv[0]);
+		return 1;
+	}
+	if(numDecks == 0)
+	{
+		numDecks = engine::Variants[variant].numDecks;
+	}
+	
+	BankrollSimulator simulator(bankroll, ramp, horizon, variant, numDecks, penetration);
+	simulator.setTolerance(ruinTolerance, balanceTolerance);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	BankrollResult result = simulator.run(maxTrajectories, numThreads, seed);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	
+	printf("trajectories  %llu%s\n", static_cast<unsigned long long>(result.trajectories),
+	       result.converged ? " (converged)" : "");
+	printf("threads       %d\n", numThreads);
+	printf("rules         %s\n", engine::Variants[variant].name);
+	printf("decks         %d\n", numDecks);
+	printf("seed          %llu\n", static_cast<unsigned long long>(seed));
+	printf("money         %d\n", bankroll);
+	printf("bet ramp      %s\n", rampText);
+	printf("rounds        %llu at most per trajectory\n", static_cast<unsigned long long>(horizon));
+	printf("risk of ruin  %.4f%% +/- %.4f%%\n", 100.0 * result.riskOfRuin(),
+	                                          100.0 * result.riskOfRuinError());
+	if(result.ruined > 0)
+	{
+		printf("rounds to ruin  median %llu, quartiles %llu to %llu (broke trajectories only)\n",
+		       static_cast<unsigned long long>(result.roundsToRuin(0.5)),
+		       static_cast<unsigned long long>(result.roundsToRuin(0.25)),
+		       static_cast<unsigned long long>(result.roundsToRuin(0.75)));
+	}
+	printf("final balance mean %.1f +/- %.1f\n", result.meanBalance(), result.meanBalanceError());
+	
+	printf("\npercentile    balance\n");
+	static const double Percentiles[] = {0.0, 0.05, 0.25, 0.5, 0.75, 0.95, 1.0};
+	for(size_t i = 0; i < sizeof(Percentiles) / sizeof(Percentiles[0]); ++i)
+	{
+		printf("%5.0f%%     %10lld\n", 100.0 * Percentiles[i],
+		       static_cast<long long>(result.balanceAt(Percentiles[i])));
+	}
+	
+	printf("\nrounds/sec    %.0f\n", seconds > 0 ? result.rounds / seconds : 0.0);
+	
+	return 0;
+}
@@ -0,0 +1,37 @@
+#include <stdlib.h>
+#include <new>
+#include "benchmark.h"
+
+std::atomic<uint64_t> AllocationCount(0);
+
+/**
+ * Replacement of the global operator new that counts allocations.
+ * The array and nothrow forms forward to it by default.
+ */
+void *operator new(size_t size)
+{
+	++AllocationCount;
+	
+	void *p = malloc(size ? size : 1);
+	if(p == 0)
+	{
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+/**
+ * Replacement of the global operator delete matching operator new.
+ */
+void operator delete(void *p) noexcept
+{
+	free(p);
+}
+
+/**
+ * Replacement of the sized global operator delete matching operator new.
+ */
+void operator delete(void *p, size_t) noexcept
+{
+	free(p);
+}
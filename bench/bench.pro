@@ -0,0 +1,19 @@
+######################################################################
+# Engine benchmarks - no Qt dependency
+######################################################################
+
+TEMPLATE = app
+CONFIG += console
+CONFIG -= qt app_bundle
+TARGET = blackjack-bench
+DEPENDPATH += .
+INCLUDEPATH += . ..
+QMAKE_CXXFLAGS += -std=c++11
+
+# Game engine static library - build ../engine/engine.pro first
+LIBS += -L../engine -lengine
+PRE_TARGETDEPS += ../engine/libengine.a
+
+# Input
+HEADERS += benchmark.h
+SOURCES += alloccount.cpp main.cpp
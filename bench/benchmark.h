@@ -0,0 +1,80 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+
+/**
+ * Number of calls to the global operator new so far.
+ * Defined in alloccount.cpp, which replaces operator new.
+ */
+extern std::atomic<uint64_t> AllocationCount;
+
+/**
+ * Function that keeps the optimizer from dropping a computed value.
+ * @param value Value to keep
+ */
+template<class T>
+inline void keep(const T &value)
+{
+	asm volatile("" : : "g"(&value) : "memory");
+}
+
+/**
+ * Class that times benchmark bodies and prints the results.
+ * Each result is one JSON object per line on the output stream:
+ * name, iterations, ns_per_op, ops_per_sec and allocs_per_op. The number 
+ * of iterations doubles until a run takes at least the minimum time.
+ */
+class Benchmark
+{
+public:
+	/**
+	 * The Benchmark class constructor.
+	 * @param out Stream the results are printed to
+	 * @param minSeconds Minimum duration of the measured run
+	 */
+	Benchmark(FILE *out, double minSeconds = 0.25) : m_out(out), m_minSeconds(minSeconds)
+	{}
+	
+	/**
+	 * Member function that measures one benchmark.
+	 * @param name Name of the benchmark in the output
+	 * @param body Callable taking the number of operations to perform
+	 */
+	template<class Body>
+	void run(const char *name, Body body)
+	{
+		uint64_t iterations = 1;
+		
+		for(;;)
+		{
+			uint64_t allocations = AllocationCount.load();
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			body(iterations);
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			allocations = AllocationCount.load() - allocations;
+			
+			if(seconds >= m_minSeconds || iterations >= (static_cast<uint64_t>(1) << 40))
+			{
+				double n = static_cast<double>(iterations);
+				fprintf(m_out, "{\"name\":\"%s\",\"iterations\":%llu,\"ns_per_op\":%.3f,"
+				               "\"ops_per_sec\":%.0f,\"allocs_per_op\":%.4f}\n",
+				        name, static_cast<unsigned long long>(iterations), 
+				        seconds * 1e9 / n, n / seconds, allocations / n);
+				fflush(m_out);
+				return;
+			}
+			
+			iterations *= 2;
+		}
+	}
+	
+private:
+	FILE *m_out;
+	double m_minSeconds;
+};
+
+#endif
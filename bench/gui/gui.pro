@@ -0,0 +1,19 @@
+######################################################################
+# Widget benchmarks - runs offscreen where Qt supports it
+######################################################################
+
+TEMPLATE = app
+CONFIG += console
+TARGET = blackjack-guibench
+DEPENDPATH += . ../..
+INCLUDEPATH += . ../..
+QMAKE_CXXFLAGS += -std=c++11
+
+# Game engine static library - build ../../engine/engine.pro first
+LIBS += -L../../engine -lengine
+PRE_TARGETDEPS += ../../engine/libengine.a
+
+# Input
+HEADERS += ../benchmark.h ../../card.h ../../hand.h ../../handview.h
+SOURCES += ../alloccount.cpp main.cpp ../../card.cpp ../../hand.cpp ../../handview.cpp
+RESOURCES += ../../Blackjack.qrc
@@ -0,0 +1,98 @@
+#include <QApplication>
+#include <QByteArray>
+#include <QList>
+#include <stdio.h>
+#include <thread>
+#include "card.h"
+#include "hand.h"
+#include "handview.h"
+#include "engine/tablethread.h"
+#include "../benchmark.h"
+
+int main(int argc, char *argv[])
+{
+	// Widgets are never shown on screen; run without a display where the 
+	// Qt version supports the offscreen platform (Qt 5 and later)
+	if(qgetenv("QT_QPA_PLATFORM").isEmpty())
+	{
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	}
+	
+	QApplication app(argc, argv);
+	Benchmark bench(stdout);
+	
+	// Decode the card images before timing anything
+	Card::preloadCardImages();
+	for(int i = 0; i <= Card::CardBackIndex; ++i)
+	{
+		Card::cardPixmap(i);
+	}
+	
+	bench.run("card_construct", [&](uint64_t n) {
+		for(uint64_t i = 0; i < n; ++i)
+		{
+			Card *c = new Card(engine::Card(static_cast<int>(i % engine::Card::NumCards)));
+			delete c;
+		}
+	});
+	
+	Card card;
+	bench.run("card_bind", [&](uint64_t n) {
+		for(uint64_t i = 0; i < n; ++i)
+		{
+			card.bind(engine::Card(static_cast<int>(i % engine::Card::NumCards)), 
+			          (i & 1) ? Card::CardFaceDown : Card::CardFaceUp);
+		}
+	});
+	
+	// One op is a click as the window makes it: a command posted to the 
+	// engine thread and its snapshot polled back. Bets are placed and 
+	// cleared in turn, so the balance never runs out
+	engine::TableThread engine;
+	int seat = engine.addSeat(engine::SeatOptions());
+	engine::TableSnapshot snapshot;
+	engine.start();
+	engine.poll(seat, snapshot);
+	
+	bench.run("engine_round_trip", [&](uint64_t n) {
+		for(uint64_t i = 0; i < n; ++i)
+		{
+			engine::Request request = {engine::CommandBet, (i & 1) ? 0 : 5};
+			engine.post(seat, request);
+			while(!engine.poll(seat, snapshot))
+			{
+				std::this_thread::yield();
+			}
+		}
+		keep(snapshot.sequence);
+	});
+	engine.stop();
+	
+	Hand hand;
+	bench.run("hand_append", [&](uint64_t n) {
+		for(uint64_t i = 0; i < n; ++i)
+		{
+			if((i & 3) == 0) hand.clear();
+			hand << engine::Card(static_cast<int>(i % engine::Card::NumCards));
+		}
+	});
+	
+	// One op is dealing a card into a shown hand and letting the view 
+	// catch up, as one click on the hit button does
+	QWidget parent;
+	parent.resize(400, 120);
+	HandView view(&hand, &parent);
+	QObject::connect(&hand, SIGNAL(handChanged()), &view, SLOT(refresh()));
+	parent.show();
+	
+	bench.run("handview_refresh", [&](uint64_t n) {
+		for(uint64_t i = 0; i < n; ++i)
+		{
+			if(hand.numCards() == 6) hand.clear();
+			hand << engine::Card(static_cast<int>(i % engine::Card::NumCards));
+			app.processEvents();
+		}
+	});
+	
+	return 0;
+}
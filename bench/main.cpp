@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "engine/hand.h"
+#include "engine/handbatch.h"
+#include "engine/rng.h"
+#include "engine/round.h"
+#include "engine/rules.h"
+#include "engine/ruleset.h"
+#include "engine/shoe.h"
+#include "benchmark.h"
+
+/**
+ * Helper function that prints the command line usage.
+ */
+static void usage(const char *prog)
+{
+	fprintf(stderr, 
+	        "Usage: %s [-m seconds] [-s seed]\n"
+	        "  -m  minimum measured time per benchmark (default 0.25)\n"
+	        "  -s  random seed (default 1)\n", 
+	        prog);
+}
+
+int main(int argc, char *argv[])
+{
+	double minSeconds = 0.25;
+	uint64_t seed = 1;
+	int opt;
+	
+	while((opt = getopt(argc, argv, "m:s:h")) != -1)
+	{
+		switch(opt)
+		{
+		case 'm': minSeconds = atof(optarg); break;
+		case 's': seed = strtoull(optarg, 0, 10); break;
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	
+	Benchmark bench(stdout, minSeconds);
+	engine::Rng rng(seed);
+	
+	// A fixed sequence of cards to build hands from
+	engine::Shoe cards(8);
+	cards.shuffle(rng);
+	engine::Card sequence[256];
+	for(int i = 0; i < 256; ++i)
+	{
+		sequence[i] = cards.deal();
+	}
+	
+	bench.run("hand_score", [&](uint64_t n) {
+		engine::Hand hand;
+		int sum = 0;
+		for(uint64_t i = 0; i < n; ++i)
+		{
+			if((i & 3) == 0) hand.clear();
+			hand << sequence[i & 255];
+			sum += hand.score() + hand.busted() + hand.isBlackjack();
+		}
+		keep(sum);
+	});
+	
+	for(int decks = 1; decks <= 8; decks += 5)
+	{
+		engine::Shoe shoe(decks);
+		char name[32];
+		
+		snprintf(name, sizeof(name), "shoe_shuffle_%dd", decks);
+		bench.run(name, [&](uint64_t n) {
+			for(uint64_t i = 0; i < n; ++i)
+			{
+				shoe.shuffle(rng);
+			}
+			keep(shoe);
+		});
+		
+		snprintf(name, sizeof(name), "shoe_deal_%dd", decks);
+		bench.run(name, [&](uint64_t n) {
+			int sum = 0;
+			for(uint64_t i = 0; i < n; ++i)
+			{
+				if(shoe.cardsLeft() == 0) shoe.reset();
+				sum += shoe.deal().id();
+			}
+			keep(sum);
+		});
+	}
+	
+	// Resolve and settle pairs of hands dealt from the sequence
+	engine::Hand players[64];
+	engine::Hand dealers[64];
+	for(int i = 0; i < 64; ++i)
+	{
+		int k = i * 4;
+		players[i] << sequence[k & 255] << sequence[(k + 1) & 255];
+		dealers[i] << sequence[(k + 2) & 255] << sequence[(k + 3) & 255];
+		while(engine::dealerMustHit(dealers[i]))
+		{
+			k += 7;
+			dealers[i] << sequence[k & 255];
+		}
+	}
+	
+	bench.run("resolve_settle", [&](uint64_t n) {
+		int bet = 10;
+		int balance = 1000000;
+		for(uint64_t i = 0; i < n; ++i)
+		{
+			engine::Outcome outcome = engine::resolve(players[i & 63], dealers[(i >> 6) & 63]);
+			engine::settle(outcome, bet, balance);
+			if(bet == 0) bet = 10;
+		}
+		keep(balance);
+	});
+	
+	// The same pairs settled a batch at a time, one op per round
+	{
+		const size_t BatchSize = 4096;
+		engine::HandBatch batchPlayers(BatchSize);
+		engine::HandBatch batchDealers(BatchSize);
+		static int32_t net[BatchSize];
+		for(size_t i = 0; i < BatchSize; ++i)
+		{
+			batchPlayers.set(i, players[i & 63]);
+			batchPlayers.setWager(i, 10);
+			batchDealers.set(i, dealers[(i >> 6) & 63]);
+		}
+		
+		static const char *Names[] = {"settle_batch_scalar", "settle_batch_sse2", "settle_batch_avx2"};
+		for(int level = engine::SimdScalar; level <= engine::bestSimdLevel(); ++level)
+		{
+			bench.run(Names[level], [&](uint64_t n) {
+				int64_t sum = 0;
+				for(uint64_t i = 0; i < n; i += BatchSize)
+				{
+					sum += engine::settleBatch<engine::HouseRules>(batchPlayers, batchDealers, net, 
+					                                               static_cast<engine::SimdLevel>(level));
+				}
+				keep(sum);
+			});
+		}
+	}
+	
+	for(int decks = 1; decks <= 8; decks += 5)
+	{
+		engine::Shoe shoe(decks);
+		engine::Round round(shoe, rng);
+		char name[32];
+		
+		shoe.shuffle(rng);
+		snprintf(name, sizeof(name), "full_round_%dd", decks);
+		bench.run(name, [&](uint64_t n) {
+			int bet = 10;
+			int balance = 1000000;
+			for(uint64_t i = 0; i < n; ++i)
+			{
+				round.deal();
+				while(round.player().score() < 17)
+				{
+					round.hit();
+				}
+				engine::settle(round.stand(), bet, balance);
+				if(bet == 0) bet = 10;
+			}
+			keep(balance);
+		});
+	}
+	
+	// The same round under a variant with H17 and a 6:5 payout, settled 
+	// through the multi-hand resolver
+	{
+		typedef engine::SixToFiveRules Rules;
+		engine::Shoe shoe(Rules::NumDecks);
+		engine::Round round(shoe, rng);
+		
+		shoe.shuffle(rng);
+		bench.run("full_round_6to5", [&](uint64_t n) {
+			int bet = 10;
+			int balance = 1000000;
+			for(uint64_t i = 0; i < n; ++i)
+			{
+				round.deal();
+				while(round.player().score() < 17)
+				{
+					round.hit();
+				}
+				round.stand<Rules>();
+				engine::settleNet(round.net<Rules>(bet), bet, balance);
+				if(bet == 0) bet = 10;
+			}
+			keep(balance);
+		});
+	}
+	
+	return 0;
+}
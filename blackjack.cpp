@@ -4,19 +4,47 @@
 #include <QMenuBar>
 #include <QMenu>
 #include <QAction>
+#include <QActionGroup>
+#include <QDateTime>
 #include <QIcon>
 #include <QStatusBar>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QMessageBox>
 #include <QTextEdit>
+#include <QFileDialog>
+#include <QInputDialog>
+#include <QDir>
+#include <QFile>
+#include <QFormLayout>
+#include <QStringList>
 #include "blackjack.h"
+#include "engine/journal.h"
+#include "engine/ruleset.h"
+
+static const int FrameMs = 16;  /**< milliseconds between two looks at the engine. */
+static const int StatsMs = 250; /**< milliseconds between two refreshes of the statistics. */
+static const size_t MaxDealerCache = 4096; /**< dealer distributions kept for the advice. */
+
+/**
+ * Values of the "outcome" property of the main info label, one per 
+ * Blackjack::InfoStyle; setStyle() styles each of them.
+ */
+static const char *InfoStyleNames[] = {"plain", "won", "lost", "draw"};
+
+/**
+ * Names of the player's plays as the buttons show them, indexed by 
+ * engine::Action up to Surrender.
+ */
+static const char *ActionNames[] = {"Stay", "Hit", "Double", "Split", "Give Up"};
 
 /**
  * The Blackjack class constructor.
  * Everything is set up in the body of this function.
  */
-Blackjack::Blackjack(QWidget *parent) : QMainWindow(parent)
+Blackjack::Blackjack(QWidget *parent) : QMainWindow(parent), m_seat(0), m_posted(0), 
+m_variant(engine::HouseVariant), m_strategyVariant(-1), m_playerOdds(m_dealerOdds), m_mainInfoStyle(InfoPlain), 
+m_dirty(DirtyAll), m_updatePending(false)
 {
 	// Layout the UI and style them first
 	setupUi();
@@ -27,13 +55,27 @@ Blackjack::Blackjack(QWidget *parent) : QMainWindow(parent)
 	// ... and update the UI with the data.
 	updateUi();
 	
-	// Now shuffle the card deck
-	m_deck.shuffle();
+	// Now start the game engine
+	m_engine.start();
+	m_pollTimer = new QTimer(this);
+	m_pollTimer->setInterval(FrameMs);
+	m_statsTimer = new QTimer(this);
+	m_statsTimer->start(StatsMs);
 	// ... and finally connect everything up.
+	connect(m_pollTimer, SIGNAL(timeout()),
+	        this, SLOT(pollEngine()));
+	connect(m_statsTimer, SIGNAL(timeout()),
+	        this, SLOT(updateStats()));
 	connect(newGameAct, SIGNAL(triggered()),
 	        this, SLOT(resetGame()));
 	connect(quitAct, SIGNAL(triggered()),
 	        this, SLOT(close()));
+	connect(replayAct, SIGNAL(triggered()),
+	        this, SLOT(replayRound()));
+	connect(rulesGroup, SIGNAL(triggered(QAction*)),
+	        this, SLOT(changeRules(QAction*)));
+	connect(adviceAct, SIGNAL(toggled(bool)),
+	        this, SLOT(toggleAdvice()));
 	connect(aboutAct, SIGNAL(triggered()),
 	        this, SLOT(about()));
 	connect(ruleAct, SIGNAL(triggered()),
@@ -41,8 +83,11 @@ Blackjack::Blackjack(QWidget *parent) : QMainWindow(parent)
 	        
 	connect(&m_dealerHand, SIGNAL(handChanged()),
 	        m_dealerHandView, SLOT(refresh()));
-	connect(&m_playerHand, SIGNAL(handChanged()),
-	        m_playerHandView, SLOT(refresh()));	
+	for(int i = 0; i < engine::Round::MaxHands; ++i)
+	{
+		connect(&m_playerHands[i], SIGNAL(handChanged()),
+		        m_playerHandViews[i], SLOT(refresh()));
+	}
 	          
 	connect(m_betButtons, SIGNAL(buttonClicked(int)),
 	        this, SLOT(updateBet(int)));
@@ -51,7 +96,15 @@ Blackjack::Blackjack(QWidget *parent) : QMainWindow(parent)
 	connect(m_hitButton, SIGNAL(clicked()),
 			this, SLOT(hit()));
 	connect(m_stayButton, SIGNAL(clicked()),
-			this, SLOT(dealerPlays()));	
+			this, SLOT(stay()));
+	connect(m_doubleButton, SIGNAL(clicked()),
+			this, SLOT(doubleDown()));
+	connect(m_splitButton, SIGNAL(clicked()),
+			this, SLOT(split()));
+	connect(m_surrenderButton, SIGNAL(clicked()),
+			this, SLOT(surrender()));
+	connect(m_insureButton, SIGNAL(clicked()),
+			this, SLOT(insure()));
 }
 
 /**
@@ -61,17 +114,21 @@ Blackjack::Blackjack(QWidget *parent) : QMainWindow(parent)
  */
 void Blackjack::resetData()
 {
-	m_cardsLeft = 52;
-	m_currentBet = 0;
-	m_balance = 1000;
-	
-	m_isBetting = true;
-	m_mainInfo = QString("Dealer stands on all 17s");
-	m_mainInfoStyleStr = QString("padding-left: 10px; font-weight: normal; color: #ffffff;");
+	setMainInfo(QString(engine::Variants[m_variant].description), InfoPlain);
 }
 
 /**
  * Member function that reads and loads settings from last game.
+ * The player sits down at a table of the engine with the balance and 
+ * rules of last game. Every settled hand is appended to DIR/SEED.bjhl 
+ * when a hand history directory is configured, where SEED is the seed 
+ * of the table, so the session can be replayed from the file alone.
+ * 
+ * The balance saved on close is only a checkpoint: every bet and settled 
+ * round goes to a journal as well, and when the last session crashed the 
+ * journal holds money the checkpoint never saw. Its last whole record 
+ * wins, then the checkpoint is brought up to date before the new session 
+ * starts the journal over.
  */
 void Blackjack::readSettings()
 {
@@ -79,18 +136,104 @@ void Blackjack::readSettings()
 	
 	resize(settings.value("size", QSize(400, 400)).toSize());
 	move(settings.value("pos", QPoint(200, 200)).toPoint());
-	m_balance = settings.value("balance", 1000).toInt();
+	m_variant = engine::findVariant(settings.value("rules", "house").toString().toLatin1().constData());
+	if(m_variant < 0)
+	{
+		m_variant = engine::HouseVariant;
+	}
+	rulesGroup->actions().at(m_variant)->setChecked(true);
+	m_statsDock->setVisible(settings.value("showStats", false).toBool());
+	adviceAct->setChecked(settings.value("showAdvice", false).toBool());
+	resetData();
+	m_handLogDir = settings.value("handLogDir").toString();
+	m_strategyDir = settings.value("strategyDir", QDir(QDir::homePath()).filePath(".blackjack")).toString();
+	loadStrategy();
+	
+	engine::SeatOptions options;
+	options.variant = m_variant;
+	options.seed = QDateTime::currentDateTime().toMSecsSinceEpoch();
+	options.balance = settings.value("balance", engine::Table::StartBalance).toInt();
+	options.penetration = settings.value("penetration", engine::Shoe::DefaultPenetration).toDouble();
+	options.handLogDir = QFile::encodeName(m_handLogDir).constData();
+	
+	QString journalPath = settings.value("journal", QDir(QDir::homePath()).filePath(".blackjack.journal")).toString();
+	options.journalPath = QFile::encodeName(journalPath).constData();
+	options.journalSyncEvents = settings.value("journalSyncEvents", engine::Journal::DefaultSyncEvents).toInt();
+	options.journalSyncMs = settings.value("journalSyncMs", engine::Journal::DefaultSyncMs).toInt();
+	
+	engine::JournalRecord last;
+	bool recovered = false;
+	if(engine::Journal::recover(options.journalPath.c_str(), last) && last.recoveredBalance() != options.balance)
+	{
+		options.balance = last.recoveredBalance();
+		settings.setValue("balance", options.balance);
+		settings.sync();
+		recovered = true;
+	}
+	
+	m_seat = m_engine.addSeat(options);
+	m_engine.poll(m_seat, m_snapshot);
+	
+	if(recovered)
+	{
+		statusBar()->showMessage(QString("Recovered a balance of %1 from %2").arg(options.balance).arg(journalPath));
+	}
+	if(m_snapshot.journalFailed)
+	{
+		statusBar()->showMessage(QString("Cannot write the session journal to %1").arg(journalPath));
+	}
+	if(m_snapshot.handLogFailed)
+	{
+		statusBar()->showMessage(QString("Cannot write hand history to %1")
+		                         .arg(QDir(m_handLogDir).filePath(QString::number(m_snapshot.seed) + ".bjhl")));
+	}
+}
+
+/**
+ * Member function that marks parts of the UI as out of date.
+ * They are brought up to date once control gets back to the event loop, 
+ * so everything one event changes ends up in a single updateUi().
+ * @param fields DirtyFlags bits of the parts to update
+ */
+void Blackjack::markDirty(int fields)
+{
+	m_dirty |= fields;
+	if(!m_updatePending && m_dirty != 0)
+	{
+		m_updatePending = true;
+		QTimer::singleShot(0, this, SLOT(updateUi()));
+	}
+}
+
+/**
+ * Member function that sets the text and the style of the main info.
+ * @param text The text
+ * @param style How it is styled
+ */
+void Blackjack::setMainInfo(const QString &text, InfoStyle style)
+{
+	if(text != m_mainInfo || style != m_mainInfoStyle)
+	{
+		m_mainInfo = text;
+		m_mainInfoStyle = style;
+		markDirty(DirtyInfo);
+	}
 }
 
 /**
  * Member function that updates UI with the latest game data.
- * This function is called whenever the UI needs updating. It enables or 
+ * Only the parts marked by markDirty() are touched. It enables or 
  * disables various buttons as appropriate; it also updates various displays.
  */
 void Blackjack::updateUi()
 {
+	const engine::TableState &state = m_snapshot.state;
+	int dirty = m_dirty;
+	m_dirty = 0;
+	m_updatePending = false;
+	
 	// Game is in betting mode
-	if(m_isBetting)
+	if((dirty & DirtyButtons) && state.isBetting())
 	{
 		m_betFiveButton->setDisabled(false);
 		m_betTwentyfiveButton->setDisabled(false);
@@ -98,8 +241,12 @@ void Blackjack::updateUi()
 		
 		m_hitButton->setDisabled(true);
 		m_stayButton->setDisabled(true);
+		m_doubleButton->setDisabled(true);
+		m_splitButton->setDisabled(true);
+		m_surrenderButton->setDisabled(true);
+		m_insureButton->setDisabled(true);
 		
-		if(m_currentBet == 0)
+		if(state.bet == 0)
 		{
 			m_clearBetBtn->setDisabled(true);
 			m_dealButton->setDisabled(true);
@@ -111,7 +258,7 @@ void Blackjack::updateUi()
 		}
 	}
 	// Game is in playing mode
-	else
+	else if(dirty & DirtyButtons)
 	{
 		m_clearBetBtn->setDisabled(true);
 		m_betFiveButton->setDisabled(true);
@@ -119,16 +266,200 @@ void Blackjack::updateUi()
 		m_betFiftyButton->setDisabled(true);
 		m_dealButton->setDisabled(true);
 		
-		m_hitButton->setDisabled(false);
-		m_stayButton->setDisabled(false);
+		// The engine only allows extra wagers the money covers
+		m_hitButton->setDisabled(!state.isAllowed(engine::Hit));
+		m_stayButton->setDisabled(!state.isAllowed(engine::Stand));
+		m_doubleButton->setDisabled(!state.isAllowed(engine::DoubleDown));
+		m_splitButton->setDisabled(!state.isAllowed(engine::Split));
+		m_surrenderButton->setDisabled(!state.isAllowed(engine::Surrender));
+		m_insureButton->setDisabled(!state.isAllowed(engine::Insure));
+	}
+	
+	// The rules can only change between hands
+	if(dirty & DirtyButtons)
+	{
+		rulesMenu->setEnabled(state.isBetting());
+	}
+	
+	// The hole card is counted as soon as it is dealt, so the count is 
+	// only shown between hands, when every card is face up
+	if(dirty & DirtyShoe)
+	{
+		m_cardsLeftDisp->setValue(m_snapshot.cardsLeft);
+		if(state.isBetting())
+		{
+			m_countLabel->setText(QString("Hi-Lo %1, true %2").arg(m_snapshot.runningCount)
+			                      .arg(m_snapshot.trueCount, 0, 'f', 1));
+		}
+	}
+	
+	// The outcome styles are all in the label's style sheet; switching 
+	// between them only re-polishes the label
+	if(dirty & DirtyInfo)
+	{
+		m_mainInfoLabel->setText(m_mainInfo);
+		QVariant outcome(InfoStyleNames[m_mainInfoStyle]);
+		if(m_mainInfoLabel->property("outcome") != outcome)
+		{
+			m_mainInfoLabel->setProperty("outcome", outcome);
+			m_mainInfoLabel->style()->unpolish(m_mainInfoLabel);
+			m_mainInfoLabel->style()->polish(m_mainInfoLabel);
+		}
 	}
 	
-	m_cardsLeftDisp->setValue(m_cardsLeft);
-	m_mainInfoLabel->setText(m_mainInfo);
-	m_mainInfoLabel->setStyleSheet(m_mainInfoStyleStr);
+	if(dirty & DirtyMoney)
+	{
+		m_betDisp->display(state.bet + state.extraWager);
+		m_balanceDisp->display(state.balance);	
+	}
 	
-	m_betDisp->display(m_currentBet);
-	m_balanceDisp->display(m_balance);	
+	if(dirty & DirtyAdvice)
+	{
+		showAdvice();
+	}
+}
+
+/**
+ * Member function that shows the best play for the hand being played.
+ * Advice is only given while the player can stay. The chart line is the 
+ * precomputed basic strategy for the total against the upcard; the shoe 
+ * line works out every play the table allows for the cards the player 
+ * has not seen, which is where counting pays off. Both follow the rules 
+ * played and take the dealer to have checked for Blackjack.
+ */
+void Blackjack::showAdvice()
+{
+	const engine::TableState &state = m_snapshot.state;
+	
+	if(!adviceAct->isChecked() || state.isBetting() || !state.isAllowed(engine::Stand))
+	{
+		m_adviceLabel->setText(QString());
+		return;
+	}
+	
+	const engine::Hand &player = state.hands[state.current];
+	engine::Card upcard = state.dealer.card(0);
+	QString text;
+	
+	const engine::StrategyTable::Cell *cell = m_strategy.find(player.score(), player.isSoft(), 
+	                                                          engine::Composition::indexOf(upcard));
+	if(cell != 0)
+	{
+		text = QString("Chart: %1\nhit %2, stay %3\n")
+		       .arg(cell->action == engine::StrategyTable::Hit ? "Hit" : "Stay")
+		       .arg(cell->evHit, 0, 'f', 3).arg(cell->evStand, 0, 'f', 3);
+	}
+	
+	// Only the current shoe's dealer is worked out, so this stays well 
+	// within a frame however cold the cache is
+	if(m_dealerOdds.cacheSize() > MaxDealerCache)
+	{
+		m_dealerOdds.clear();
+	}
+	engine::ActionEv ev = m_playerOdds.estimate(player, upcard, m_snapshot.unseen, state.allowed, 
+	                                            state.numHands > 1);
+	const double evs[] = {ev.stand, ev.hit, ev.doubleDown, ev.split, ev.surrender};
+	QStringList plays;
+	for(int a = engine::Stand; a <= engine::Surrender; ++a)
+	{
+		if(ev.evaluated & (1 << a))
+		{
+			plays << QString("%1 %2").arg(QString(ActionNames[a]).toLower()).arg(evs[a], 0, 'f', 3);
+		}
+	}
+	text += QString("Shoe: %1\n%2").arg(ActionNames[ev.best()]).arg(plays.join(", "));
+	
+	m_adviceLabel->setText(text);
+}
+
+/**
+ * Member function that maps the basic strategy chart for the rules played.
+ * The chart of a variant is DIR/NAME-N.bjst, where DIR is the strategyDir 
+ * setting, NAME the variant's short name and N its decks; a chart computed 
+ * for other rules or another shoe is not used. Without one only the shoe 
+ * is worked out, under the same rules.
+ */
+void Blackjack::loadStrategy()
+{
+	if(m_variant == m_strategyVariant)
+	{
+		return;
+	}
+	
+	const engine::Variant &rules = engine::Variants[m_variant];
+	m_strategyVariant = m_variant;
+	m_playerOdds.setVariant(m_variant);
+	
+	QString path = QDir(m_strategyDir).filePath(QString("%1-%2.bjst").arg(rules.name).arg(rules.numDecks));
+	if(m_strategy.open(QFile::encodeName(path).constData()) && 
+	   (m_strategy.header().rules != static_cast<uint32_t>(m_variant) || m_strategy.header().numDecks != rules.numDecks))
+	{
+		m_strategy.close();
+	}
+}
+
+/**
+ * Member function that shows or hides the advice.
+ */
+void Blackjack::toggleAdvice()
+{
+	markDirty(DirtyAdvice);
+}
+
+/**
+ * Member function that refreshes the statistics panel.
+ * The statistics are read from the engine without a lock, so this never 
+ * waits for a round being played. Nothing is read while the panel is hidden.
+ */
+void Blackjack::updateStats()
+{
+	if(!m_statsDock->isVisible())
+	{
+		return;
+	}
+	
+	engine::SessionStats stats = m_engine.stats(m_seat);
+	m_handsDisp->setText(QString::number(static_cast<qulonglong>(stats.hands)));
+	m_ratesDisp->setText(QString("%1% / %2% / %3%").arg(100.0 * stats.winRate(), 0, 'f', 1)
+	                     .arg(100.0 * stats.lossRate(), 0, 'f', 1).arg(100.0 * stats.pushRate(), 0, 'f', 1));
+	m_netDisp->setText(QString::number(static_cast<qlonglong>(stats.net)));
+	m_evDisp->setText(QString("%1 (sd %2)").arg(stats.meanEv, 0, 'f', 3)
+	                  .arg(stats.standardDeviation(), 0, 'f', 3));
+	m_streakDisp->setText(QString("%1 (longest %2 won, %3 lost)").arg(stats.streak)
+	                      .arg(stats.longestWinStreak).arg(stats.longestLossStreak));
+	m_blackjackDisp->setText(QString("%1 (%2%)").arg(static_cast<int>(stats.blackjacks))
+	                         .arg(100.0 * stats.blackjackRate(), 0, 'f', 1));
+}
+
+/**
+ * Member function that finds the parts of the UI two snapshots differ in.
+ * @param from The snapshot shown
+ * @param to The snapshot to show
+ * @return DirtyFlags bits
+ */
+int Blackjack::changedFields(const engine::TableSnapshot &from, const engine::TableSnapshot &to)
+{
+	int fields = 0;
+	if(from.state.flags != to.state.flags || from.state.allowed != to.state.allowed)
+	{
+		fields |= DirtyButtons;
+	}
+	if(from.cardsLeft != to.cardsLeft || from.runningCount != to.runningCount || 
+	   from.state.isBetting() != to.state.isBetting())
+	{
+		fields |= DirtyShoe;
+	}
+	if(from.state.balance != to.state.balance || from.state.bet != to.state.bet || 
+	   from.state.extraWager != to.state.extraWager)
+	{
+		fields |= DirtyMoney;
+	}
+	if(from.cardsLeft != to.cardsLeft || from.state.current != to.state.current || 
+	   from.state.allowed != to.state.allowed)
+	{
+		fields |= DirtyAdvice;
+	}
+	return fields;
 }
 
 /**
@@ -140,7 +471,7 @@ void Blackjack::resetGame()
 {
 	// Voluntary restart of a game (when player still has money but 
 	// "New Game" is clicked)
-	if(m_balance > 0 || m_currentBet > 0)
+	if(m_snapshot.state.balance > 0 || m_snapshot.state.bet > 0)
 	{
 		QMessageBox::StandardButton ans;
 		
@@ -154,24 +485,106 @@ void Blackjack::resetGame()
 			return;
 		}
 	}
-
+	
 	// Work to restart a game
-	m_dealerHand.clear();
-	m_playerHand.clear();
+	// The engine reshuffles the shoe it has, which keeps the shoe's state 
+	// a function of the seed for replays.
 	resetData();
-	updateUi();
-	m_deck.reset();
-	m_deck.shuffle();
+	post(engine::CommandNewGame);
+}
+
+/**
+ * Member function that shows a past round from a hand history file.
+ * The round is re-played through the engine from the seed in the file, 
+ * so what is shown is what the shoe dealt, checked against the record. 
+ * Checkpoints of the file are kept while the same file is chosen again, 
+ * so any later jump replays a bounded number of rounds.
+ * This is only possible between hands.
+ */
+void Blackjack::replayRound()
+{
+	if(!m_snapshot.state.isBetting() || isWaiting())
+	{
+		statusBar()->showMessage("Finish the hand before replaying a round");
+		return;
+	}
+	
+	QString path = QFileDialog::getOpenFileName(this, "Replay Round", m_replayPath, 
+	                                            "Hand history (*.bjhl)");
+	if(path.isEmpty())
+	{
+		return;
+	}
+	
+	if(path != m_replayPath || !m_replay)
+	{
+		m_replay.reset();
+		m_replayPath.clear();
+		if(!m_replayLog.open(QFile::encodeName(path).constData()) || m_replayLog.count() == 0)
+		{
+			QMessageBox::warning(this, "Replay Round", 
+			                     QString("%1 is not a hand history or has no rounds.").arg(path));
+			return;
+		}
+		m_replay.reset(new engine::Replay(m_replayLog));
+		m_replayPath = path;
+	}
+	
+	bool ok = false;
+	int round = QInputDialog::getInt(this, "Replay Round", "Round:", 0, 0, 
+	                                 static_cast<int>(m_replay->count()) - 1, 1, &ok);
+	if(!ok || !m_replay->seek(round))
+	{
+		return;
+	}
+	
+	bool matched = m_replay->step();
+	
+	// Show the round with every card face up
+	clearHands();
+	syncHands(m_replay->round());
+	
+	static const char *Outcomes[] = {"You won", "You lost", "Draw"};
+	setMainInfo(QString("Round %1: %2").arg(round).arg(Outcomes[m_replay->outcome()]), InfoPlain);
+	
+	if(!matched)
+	{
+		QMessageBox::warning(this, "Replay Round", 
+		                     QString("Round %1 does not match the hand history.").arg(round));
+	}
+}
+
+/**
+ * Member function that switches the table to another variant.
+ * This is only possible between hands. The engine seats the player at a 
+ * new table with the variant's number of decks and a fresh seed, and a 
+ * new hand history file is started, as each file is played under one set 
+ * of rules. The balance is kept.
+ * @param action The chosen entry of the rules menu
+ */
+void Blackjack::changeRules(QAction *action)
+{
+	int variant = action->data().toInt();
+	if(variant == m_variant || !m_snapshot.state.isBetting())
+	{
+		return;
+	}
+	
+	post(engine::CommandJoin, variant);
 }
 
 /**
  * Overloaded close event handler.
- * This function is called to save game settings before close.
+ * This function is called to save game settings before close. The engine 
+ * is stopped first, so the settings hold the table as it was left.
  */
 void Blackjack::closeEvent(QCloseEvent *event)
 {
 	if(userReallyWantsToQuit())
 	{
+		m_engine.stop();
+		while(m_engine.poll(m_seat, m_snapshot))
+		{}
 		writeSettings();
 		event->accept();
 	}
@@ -188,7 +601,7 @@ void Blackjack::closeEvent(QCloseEvent *event)
 bool Blackjack::userReallyWantsToQuit()
 {
 	// In the middle of a hand - user loses the bet if quit
-	if(m_hitButton->isEnabled())
+	if(!m_snapshot.state.isBetting())
 	{
 		QMessageBox::StandardButton ans;
 		
@@ -207,10 +620,9 @@ bool Blackjack::userReallyWantsToQuit()
 			return false;
 		}
 	}
-	// Still betting - take back the bet
+	// Still betting - the bet is taken back when settings are saved
 	else
 	{
-		m_balance += m_currentBet;
 		return true;
 	}
 }
@@ -224,7 +636,11 @@ void Blackjack::writeSettings()
 	
 	settings.setValue("size", size());
 	settings.setValue("pos", pos());
-	settings.setValue("balance", m_balance);
+	settings.setValue("balance", m_snapshot.state.balance + 
+	                  (m_snapshot.state.isBetting() ? m_snapshot.state.bet : 0));
+	settings.setValue("rules", engine::Variants[m_variant].name);
+	settings.setValue("showStats", m_statsDock->isVisible());
+	settings.setValue("showAdvice", adviceAct->isChecked());
 }
 
 /**
@@ -253,7 +669,7 @@ void Blackjack::rule()
 		ruleBox->setWindowModality(Qt::WindowModal);
 		ruleBox->setWindowTitle("Blackjack rules");
 		ruleBox->move(pos().x()+150, pos().y());
-		ruleBox->resize(400, 550);
+		ruleBox->resize(400, 700);
 		
 		ruleBox->setReadOnly(true);
 		ruleBox->setHtml("<h2>Rules of the game</h2>"
@@ -267,9 +683,18 @@ void Blackjack::rule()
 						 "<P><b>Example 2:</b></p>"
 						 "<p><img src=\":/images/dealer_18.jpg\"></P>"
 						 "<P>Dealer is 18 points. That's more than 17. He must stay even if \
-						 player has higher points. Also note ace here counts as 11, not 1.</p>");
+						 player has higher points. Also note ace here counts as 11, not 1.</p>"
+						 "<h2>Player's options</h2>"
+						 "<p><b>Double:</b> double the bet on the first two cards of a hand and take \
+						 exactly one more card.</p>"
+						 "<p><b>Split:</b> split two cards of the same value into two hands with a \
+						 bet each, up to four hands. Split Aces get one card each.</p>"
+						 "<p><b>Give Up:</b> surrender the first two cards for half the bet, where \
+						 the rules allow it.</p>"
+						 "<p><b>Insure:</b> when the dealer shows an Ace, bet half the bet that he \
+						 has Blackjack; it pays 2:1.</p>");
 	}
-
+	
 	ruleBox->show();
 }
 
@@ -280,59 +705,18 @@ void Blackjack::rule()
  */
 void Blackjack::updateBet(int bet)
 {
-	// The clear bet button is clicked
-	if(bet == 0)
-	{
-		m_balance += m_currentBet;
-		m_currentBet = 0;
-	}
-	// Other bet value buttons are clicked
-	else
-	{	
-		if(m_balance < bet) return;
-
-		m_currentBet += bet;
-		m_balance -= bet;
-	}
-	
-	updateUi();
+	post(engine::CommandBet, bet);
 }
 
 /**
  * Member function that deals a hand to dealer and player.
- * This function is called when the user clicks the deal button.
+ * This function is called when the user clicks the deal button. The
+ * dealer checks a ten for Blackjack at once; under an Ace the check waits
+ * until the player has decided on insurance.
  */
 void Blackjack::deal()
 {
-	// Switch off betting mode
-	m_isBetting = false;
-	
-	// Clear both hands first if necessary
-	if(m_dealerHand.numCards() != 0)
-	{
-		m_dealerHand.clear();
-		m_playerHand.clear();
-	}
-	
-	// Reset the deck if there is less than 10 cards left in the deck
-	if(m_deck.cardsLeft() < 10)
-	{
-		m_deck.reset();
-		m_deck.shuffle();
-		m_cardsLeft = 52;
-	}
-	
-	// Deal 2 cards to dealer and player
-	// Keep the second card of player face down
-	m_dealerHand << m_deck.deal() << m_deck.deal()->setFacedown(true);
-	m_playerHand << m_deck.deal() << m_deck.deal();
-	
-	// Update game data
-	m_cardsLeft -= 4;
-	m_mainInfo = QString("Dealer stands on all 17s");
-	m_mainInfoStyleStr = QString("padding-left: 10px; font-weight: normal; color: #ffffff;");
-	
-	updateUi();
+	post(engine::CommandDeal);
 }
 
 /**
@@ -341,124 +725,264 @@ void Blackjack::deal()
  */
 void Blackjack::hit()
 {
-	m_playerHand << m_deck.deal();
-	--m_cardsLeft;
-	
-	if(m_playerHand.busted())
+	post(engine::CommandHit);
+}
+
+/**
+ * Member function that finishes the user's current hand.
+ * This function is called when the user clicks the stay button.
+ */
+void Blackjack::stay()
+{
+	post(engine::CommandStand);
+}
+
+/**
+ * Member function that doubles the bet on the user's current hand.
+ * This function is called when the user clicks the double button. The
+ * hand gets one more card and is finished.
+ */
+void Blackjack::doubleDown()
+{
+	post(engine::CommandDouble);
+}
+
+/**
+ * Member function that splits the user's current hand into two.
+ * This function is called when the user clicks the split button. The new
+ * hand is played for the same bet.
+ */
+void Blackjack::split()
+{
+	post(engine::CommandSplit);
+}
+
+/**
+ * Member function that gives up the user's hand for half the bet.
+ * This function is called when the user clicks the surrender button.
+ */
+void Blackjack::surrender()
+{
+	post(engine::CommandSurrender);
+}
+
+/**
+ * Member function that places an insurance bet of half the bet.
+ * This function is called when the user clicks the insurance button;
+ * with a Blackjack this is even money. The dealer then checks for
+ * Blackjack.
+ */
+void Blackjack::insure()
+{
+	post(engine::CommandInsure);
+}
+
+/**
+ * Member function that sends a command to the game engine.
+ * The click is queued and the UI goes on at once. The engine checks every 
+ * command against the table as it is by then, so a click on a button the 
+ * next frame would have disabled is simply refused.
+ * @param command An engine::Command
+ * @param argument Its argument
+ */
+void Blackjack::post(engine::Command command, int argument)
+{
+	engine::Request request;
+	request.command = static_cast<quint8>(command);
+	request.argument = argument;
+	if(!m_engine.post(m_seat, request))
 	{
-		dealerPlays();
+		return;
 	}
-	else
+	
+	++m_posted;
+	if(!m_pollTimer->isActive())
 	{
-		updateUi();
+		m_pollTimer->start();
 	}
 }
 
 /**
- * Member function that drives the dealer's action.
- * This function is called when the user clicks the stay button, or 
- * when the user's hand has busted.
+ * Member function that checks whether a command is still with the engine.
+ * @return true: the last command has not been answered yet
  */
-void Blackjack::dealerPlays()
+bool Blackjack::isWaiting() const
 {
-	// Show dealer's second card that was previously hidden
-	m_dealerHand.cards()[1]->setFacedown(false);
+	return m_posted != m_snapshot.sequence;
+}
+
+/**
+ * Member function that takes the engine's snapshots and shows the latest.
+ * This function is called once per frame while a command is with the 
+ * engine. Every snapshot is looked at, so no settled round is missed, but 
+ * the table is only drawn once.
+ */
+void Blackjack::pollEngine()
+{
+	engine::TableSnapshot shown = m_snapshot;
+	engine::TableSnapshot snapshot;
+	bool changed = false;
+	bool bankrupt = false;
+	
+	while(m_engine.poll(m_seat, snapshot))
+	{
+		const engine::TableState &last = m_snapshot.state;
+		const engine::TableState &state = snapshot.state;
+		m_variant = state.variant;
+		
+		// A new deal or a new table starts with the rules on show
+		if(state.variant != last.variant || snapshot.seed != m_snapshot.seed || 
+		   (last.isBetting() && !state.isBetting()))
+		{
+			resetData();
+		}
+		if(snapshot.journalFailed && !m_snapshot.journalFailed)
+		{
+			statusBar()->showMessage("The session journal can no longer be written");
+		}
+		if(snapshot.seed != m_snapshot.seed && snapshot.handLogFailed)
+		{
+			statusBar()->showMessage(QString("Cannot write hand history to %1")
+			                         .arg(QDir(m_handLogDir).filePath(QString::number(snapshot.seed) + ".bjhl")));
+		}
+		if(state.rounds != last.rounds && snapshot.seed == m_snapshot.seed)
+		{
+			showOutcome(state.lastNet);
+		}
+		if(state.advances != last.advances && snapshot.seed == m_snapshot.seed)
+		{
+			bankrupt = true;
+		}
+		
+		m_snapshot = snapshot;
+		changed = true;
+	}
 	
-	// Keep dealing until 17 points or more
-	while(m_dealerHand.score() < 17)
+	if(!isWaiting())
+	{
+		m_pollTimer->stop();
+	}
+	if(!changed)
 	{
-		m_dealerHand << m_deck.deal();
-		--m_cardsLeft;
+		return;
 	}
 	
-	// Updates game data and UI according to the results
-	// of the hand counting
-	countHands();
-	m_isBetting = true;
-	updateUi();
+	rulesGroup->actions().at(m_variant)->setChecked(true);
+	loadStrategy();
+	syncHands(m_snapshot.state);
+	markDirty(changedFields(shown, m_snapshot));
 	
 	// Force a new game when the user has lost all money
-	if(m_currentBet == 0)
+	if(bankrupt)
 	{
+		m_pollTimer->stop();
 		QMessageBox::information(this, "You're bankrupt!",
 		                         "The casino has advanced you some more money to keep you going!");
-		resetGame();
+		resetData();
+		post(engine::CommandNewGame);
 	}
 }
 
 /**
- * Member function that counts the hands and updates game data accordingly.
- * This function is called after dealer has finished his play.
+ * Member function that shows what a settled round paid.
+ * Every hand, doubles, surrender and insurance are paid out together.
+ * @param net Amount won by the user, negative if lost
  */
-void Blackjack::countHands()
+void Blackjack::showOutcome(int net)
 {
-	bool playerWins = false;
-	bool dealerWins = false;
-	
-	// Determine who wins
-	if(m_playerHand.busted())
+	// Update game info depending on who wins
+	if(net > 0)
 	{
-		if(!m_dealerHand.busted())
-			dealerWins = true;
+		setMainInfo(QString("You won %1.").arg(net), InfoWon);
 	}
-	else if(m_playerHand.isBlackjack())
+	else if(net < 0)
 	{
-		if(!m_dealerHand.isBlackjack())
-			playerWins = true;
+		setMainInfo(QString("You lost %1.").arg(-net), InfoLost);
 	}
-	else if(m_dealerHand.busted())
+	else
 	{
-		playerWins = true;
+		setMainInfo(QString("Draw"), InfoDraw);
 	}
-	else if(m_dealerHand.isBlackjack())
+}
+
+/**
+ * Member function that shows the hands of a round.
+ * Only the player's hands in play are shown; with more than one, the
+ * hand being played is marked.
+ * @param round The round to show
+ */
+void Blackjack::syncHands(const engine::Round &round)
+{
+	m_dealerHand.sync(round.dealer());
+	
+	for(int i = 0; i < engine::Round::MaxHands; ++i)
 	{
-		dealerWins = true;
+		if(i < round.numHands())
+		{
+			m_playerHands[i].sync(round.player(i));
+			m_playerCardsGroups[i]->setTitle(round.numHands() == 1 ? QString("Player") :
+			                                 QString("Hand %1%2").arg(i + 1)
+			                                 .arg(i == round.current() ? " - your turn" : ""));
+			m_playerCardsGroups[i]->show();
+		}
+		else
+		{
+			m_playerHands[i].clear();
+			m_playerCardsGroups[i]->hide();
+		}
 	}
-	else if(m_playerHand.score() > m_dealerHand.score())
-	{
-		playerWins = true;
-	}	
-	else if(m_playerHand.score() < m_dealerHand.score())
+}
+
+/**
+ * Member function that shows the hands of a table snapshot.
+ * The dealer's hole card is drawn face down while the round is played.
+ * @param state The table
+ */
+void Blackjack::syncHands(const engine::TableState &state)
+{
+	if(state.numHands == 0)
 	{
-		dealerWins = true;
+		clearHands();
+		return;
 	}
 	
-	// Update game data depending on who wins
-	if(playerWins)
-	{
-		m_balance += m_currentBet;
-		m_mainInfo = QString("You won.");
-		m_mainInfoStyleStr = QString("padding-left: 10px;\
-		                              font-weight: bold;\
-		                              color: #89c403;");
-	}
-	else if(dealerWins)
+	m_dealerHand.sync(state.dealer);
+	m_dealerHand.setFacedown(1, state.holeHidden);
+	
+	for(int i = 0; i < engine::Round::MaxHands; ++i)
 	{
-		if(m_balance == 0)
-		{
-			m_currentBet = 0;
-		}
-		else if(m_balance < m_currentBet)
+		if(i < state.numHands)
 		{
-			m_currentBet = m_balance;
-			m_balance = 0;
+			m_playerHands[i].sync(state.hands[i]);
+			m_playerCardsGroups[i]->setTitle(state.numHands == 1 ? QString("Player") :
+			                                 QString("Hand %1%2").arg(i + 1)
+			                                 .arg(i == state.current ? " - your turn" : ""));
+			m_playerCardsGroups[i]->show();
 		}
 		else
 		{
-			m_balance -= m_currentBet;
+			m_playerHands[i].clear();
+			m_playerCardsGroups[i]->hide();
 		}
-		m_mainInfo = QString("You lost.");
-		m_mainInfoStyleStr = QString("padding-left: 10px;\
-		                              font-weight: bold;\
-		                              color: #f24537;");
 	}
-	else
+}
+
+/**
+ * Member function that removes the cards of all hands.
+ * Only the first player hand stays on the table.
+ */
+void Blackjack::clearHands()
+{
+	m_dealerHand.clear();
+	for(int i = 0; i < engine::Round::MaxHands; ++i)
 	{
-		m_mainInfo = QString("Draw");
-		m_mainInfoStyleStr = QString("padding-left: 10px;\
-		                              font-weight: bold;\
-		                              color: #3d94f6;");
+		m_playerHands[i].clear();
+		if(i > 0)
+		{
+			m_playerCardsGroups[i]->hide();
+		}
 	}
+	m_playerCardsGroups[0]->setTitle("Player");
 }
 
 /**
@@ -478,6 +1002,25 @@ void Blackjack::setupUi()
 	
 	newGameAct = gameMenu->addAction(QIcon(":/images/new.png"), "&New Game");
 	newGameAct->setStatusTip("Start a new game");
+	rulesMenu = gameMenu->addMenu("R&ules");
+	rulesGroup = new QActionGroup(this);
+	for(int i = 0; i < engine::NumVariants; ++i)
+	{
+		QAction *action = rulesMenu->addAction(engine::Variants[i].description);
+		action->setCheckable(true);
+		action->setData(i);
+		rulesGroup->addAction(action);
+	}
+	rulesMenu->menuAction()->setStatusTip("Choose the rules of the table");
+	replayAct = gameMenu->addAction("&Replay Round...");
+	replayAct->setStatusTip("Show a round from a hand history file");
+	m_statsDock = new QDockWidget("Statistics", this);
+	statsAct = m_statsDock->toggleViewAction();
+	statsAct->setStatusTip("Show the statistics of the session");
+	gameMenu->addAction(statsAct);
+	adviceAct = gameMenu->addAction("Show &Advice");
+	adviceAct->setCheckable(true);
+	adviceAct->setStatusTip("Show the best play and what each play is worth");
 	quitAct = gameMenu->addAction(QIcon(":/images/quit.png"), "&Quit");
 	quitAct->setStatusTip("Quit the game");
 	ruleAct = helpMenu->addAction("&Rule");
@@ -514,21 +1057,34 @@ void Blackjack::setupUi()
 	infoLayout->setAlignment(Qt::AlignLeft);
 	m_cardsLeftLabel = new QLabel("Cards Left", m_infoGroup);
 	m_cardsLeftDisp = new QSpinBox(m_infoGroup);
+	m_cardsLeftDisp->setRange(0, engine::Shoe::MaxCards);
 	m_cardsLeftDisp->setDisabled(true);
 	m_cardsLeftLabel->setBuddy(m_cardsLeftDisp);
+	m_countLabel = new QLabel(m_infoGroup);
 	m_mainInfoLabel = new QLabel(m_infoGroup);
 	infoLayout->addWidget(m_cardsLeftLabel);
 	infoLayout->addWidget(m_cardsLeftDisp);
+	infoLayout->addWidget(m_countLabel);
 	infoLayout->addWidget(m_mainInfoLabel);
 	m_infoGroup->setLayout(infoLayout);
 	m_centralLayout->addWidget(m_infoGroup);
 	// end main info area
-
-	// Player's cards display
-	m_playerCardsGroup = new QGroupBox("Player", m_centralWidget);
-	m_playerCardsGroup->setFixedHeight(120);
-	m_playerHandView = new HandView(&m_playerHand, m_playerCardsGroup);
-	m_centralLayout->addWidget(m_playerCardsGroup);
+	
+	// Player's cards display, one box per hand - only the first is shown 
+	// until the player splits
+	QHBoxLayout *playerLayout = new QHBoxLayout();
+	for(int i = 0; i < engine::Round::MaxHands; ++i)
+	{
+		m_playerCardsGroups[i] = new QGroupBox("Player", m_centralWidget);
+		m_playerCardsGroups[i]->setFixedHeight(120);
+		m_playerHandViews[i] = new HandView(&m_playerHands[i], m_playerCardsGroups[i]);
+		playerLayout->addWidget(m_playerCardsGroups[i]);
+		if(i > 0)
+		{
+			m_playerCardsGroups[i]->hide();
+		}
+	}
+	m_centralLayout->addLayout(playerLayout);
 	// end player's cards display
 	
 	// + Control area
@@ -614,12 +1170,62 @@ void Blackjack::setupUi()
 	decisionAreaLayout->addWidget(m_stayButton);
 	playGroupLayout->addLayout(decisionAreaLayout);
 	
+	m_doubleButton = new QPushButton("Double", m_playGroup);
+	m_doubleButton->setStatusTip("Double the bet for one more card");
+	m_doubleButton->setFixedSize(58, 30);
+	m_splitButton = new QPushButton("Split", m_playGroup);
+	m_splitButton->setStatusTip("Split the pair into two hands");
+	m_splitButton->setFixedSize(58, 30);
+	QHBoxLayout *doubleAreaLayout = new QHBoxLayout();
+	doubleAreaLayout->setAlignment(Qt::AlignLeft);
+	doubleAreaLayout->addWidget(m_doubleButton);
+	doubleAreaLayout->addWidget(m_splitButton);
+	playGroupLayout->addLayout(doubleAreaLayout);
+	
+	m_surrenderButton = new QPushButton("Give Up", m_playGroup);
+	m_surrenderButton->setStatusTip("Surrender the hand for half the bet");
+	m_surrenderButton->setFixedSize(58, 30);
+	m_insureButton = new QPushButton("Insure", m_playGroup);
+	m_insureButton->setStatusTip("Insure against a dealer Blackjack for half the bet");
+	m_insureButton->setFixedSize(58, 30);
+	QHBoxLayout *sideAreaLayout = new QHBoxLayout();
+	sideAreaLayout->setAlignment(Qt::AlignLeft);
+	sideAreaLayout->addWidget(m_surrenderButton);
+	sideAreaLayout->addWidget(m_insureButton);
+	playGroupLayout->addLayout(sideAreaLayout);
+	
+	m_adviceLabel = new QLabel(m_playGroup);
+	m_adviceLabel->setFixedWidth(120);
+	m_adviceLabel->setWordWrap(true);
+	playGroupLayout->addWidget(m_adviceLabel);
+	
 	m_playGroup->setLayout(playGroupLayout);
 	ctrlAreaLayout->addWidget(m_playGroup);
 	//   - end play area
 	
 	m_centralLayout->addLayout(ctrlAreaLayout);
 	// + end control area
+	
+	////////////////////////////////////////////////////////////////////////////
+	// Layout statistics panel
+	////////////////////////////////////////////////////////////////////////////
+	
+	QWidget *statsWidget = new QWidget(m_statsDock);
+	QFormLayout *statsLayout = new QFormLayout(statsWidget);
+	m_handsDisp = new QLabel(statsWidget);
+	m_ratesDisp = new QLabel(statsWidget);
+	m_netDisp = new QLabel(statsWidget);
+	m_evDisp = new QLabel(statsWidget);
+	m_streakDisp = new QLabel(statsWidget);
+	m_blackjackDisp = new QLabel(statsWidget);
+	statsLayout->addRow("Hands", m_handsDisp);
+	statsLayout->addRow("Won / Lost / Push", m_ratesDisp);
+	statsLayout->addRow("Net", m_netDisp);
+	statsLayout->addRow("EV per Bet", m_evDisp);
+	statsLayout->addRow("Streak", m_streakDisp);
+	statsLayout->addRow("Blackjacks", m_blackjackDisp);
+	m_statsDock->setWidget(statsWidget);
+	addDockWidget(Qt::RightDockWidgetArea, m_statsDock);
 }
 
 /**
@@ -638,12 +1244,26 @@ void Blackjack::setStyle()
 	
 	// Main information area in the middle                                   
 	m_cardsLeftDisp->setStyleSheet("color: #000000;");
-	m_mainInfoLabel->setStyleSheet("padding-left: 10px;");
+	m_countLabel->setStyleSheet("padding-left: 10px;");
+	// The outcome of a round picks one of these by the "outcome" property, 
+	// so the style sheet is only parsed once
+	m_mainInfoLabel->setStyleSheet("QLabel {padding-left: 10px;\
+	                                        font-weight: normal;\
+	                                        color: #ffffff;}\
+	                                QLabel[outcome=\"won\"] {font-weight: bold;\
+	                                                         color: #89c403;}\
+	                                QLabel[outcome=\"lost\"] {font-weight: bold;\
+	                                                          color: #f24537;}\
+	                                QLabel[outcome=\"draw\"] {font-weight: bold;\
+	                                                          color: #3d94f6;}");
 	
 	// Player cards area                           
-	m_playerCardsGroup->setStyleSheet("padding-left: 3px; \
-	                                   padding-top: 3px;\
-	                                   font-weight: bold;");
+	for(int i = 0; i < engine::Round::MaxHands; ++i)
+	{
+		m_playerCardsGroups[i]->setStyleSheet("padding-left: 3px; \
+		                                       padding-top: 3px;\
+		                                       font-weight: bold;");
+	}
 	
 	// The LCD displays                                   
 	m_betGroup->setStyleSheet("QLCDNumber {border-color: white;\
@@ -660,7 +1280,7 @@ void Blackjack::setStyle()
 	                             QPushButton:disabled {color: #767373;\
 	                                                   background-color: #A9A5A5;}\
 	                             QPushButton:hover {background-color: #1e62d0;}");                                                              
-
+	
 	// The hit button
 	m_hitButton->setStyleSheet("QPushButton {font-weight: bold;\
 											  border-radius:6px;\
@@ -678,4 +1298,26 @@ void Blackjack::setStyle()
 	                             QPushButton:disabled {color: #767373;\
 	                                                   background-color: #A9A5A5;}\
 	                             QPushButton:hover {background-color: #c62d1f;}"); 
+	
+	// The double and split buttons
+	QString raiseStyle("QPushButton {font-weight: bold;\
+	                                 border-radius:6px;\
+	                                 color: #ffffff;\
+	                                 background-color: #f6a33d;}\
+	                    QPushButton:disabled {color: #767373;\
+	                                          background-color: #A9A5A5;}\
+	                    QPushButton:hover {background-color: #d0821e;}");
+	m_doubleButton->setStyleSheet(raiseStyle);
+	m_splitButton->setStyleSheet(raiseStyle);
+	
+	// The surrender and insurance buttons
+	QString sideStyle("QPushButton {font-weight: bold;\
+	                                border-radius:6px;\
+	                                color: #ffffff;\
+	                                background-color: #8c6bb1;}\
+	                   QPushButton:disabled {color: #767373;\
+	                                         background-color: #A9A5A5;}\
+	                   QPushButton:hover {background-color: #6a4c93;}");
+	m_surrenderButton->setStyleSheet(sideStyle);
+	m_insureButton->setStyleSheet(sideStyle);
 }
@@ -2,6 +2,7 @@
 #define BLACKJACK_H
 
 #include <QMainWindow>
+#include <QDockWidget>
 #include <QToolBar>
 #include <QGroupBox>
 #include <QSpinBox>
@@ -9,14 +10,22 @@
 #include <QLCDNumber>
 #include <QButtonGroup>
 #include <QPushButton>
+#include <QScopedPointer>
+#include <QTimer>
 #include "card.h"
-#include "deck.h"
 #include "hand.h"
 #include "handview.h"
+#include "engine/playerodds.h"
+#include "engine/replay.h"
+#include "engine/round.h"
+#include "engine/strategytable.h"
+#include "engine/tablethread.h"
 
 /**
  * Class that represents a Blackjack game.
- * The class contains all UI and logic of the Blackjack game.
+ * The class contains all UI of the Blackjack game. The game itself is 
+ * played by an engine::TableThread: every click is posted to it as a 
+ * command, and its snapshots are drawn once per frame as they come in.
  */
 class Blackjack : public QMainWindow
 {
@@ -32,17 +41,58 @@ private slots:
 	void updateBet(int bet);
 	void deal();
 	void hit();
-	void dealerPlays();
+	void stay();
+	void doubleDown();
+	void split();
+	void surrender();
+	void insure();
 	void resetGame();
+	void replayRound();
+	void changeRules(QAction *action);
 	void about();
 	void rule();
+	void pollEngine();
+	void updateUi();
+	void updateStats();
+	void toggleAdvice();
 	
 private:
+	/**
+	 * enum type representing the parts of the UI updateUi() can update.
+	 */
+	enum DirtyFlags {
+	                    DirtyButtons = 1, /**< enum value DirtyButtons - enabled buttons and menus. */
+	                    DirtyShoe = 2,    /**< enum value DirtyShoe - cards left and the count. */
+	                    DirtyInfo = 4,    /**< enum value DirtyInfo - the main info. */
+	                    DirtyMoney = 8,   /**< enum value DirtyMoney - bet and balance. */
+	                    DirtyAdvice = 16, /**< enum value DirtyAdvice - the play advice. */
+	                    DirtyAll = 31     /**< enum value DirtyAll - everything. */
+	                };
+	
+	/**
+	 * enum type representing how the main info is styled.
+	 */
+	enum InfoStyle {
+	                   InfoPlain = 0, /**< enum value InfoPlain - rules and replays. */
+	                   InfoWon = 1,   /**< enum value InfoWon - the round was won. */
+	                   InfoLost = 2,  /**< enum value InfoLost - the round was lost. */
+	                   InfoDraw = 3   /**< enum value InfoDraw - the round was a draw. */
+	               };
+	
 	void resetData();
 	void setupUi();
 	void setStyle();
-	void updateUi();
-	void countHands();
+	void markDirty(int fields);
+	void setMainInfo(const QString &text, InfoStyle style);
+	static int changedFields(const engine::TableSnapshot &from, const engine::TableSnapshot &to);
+	void post(engine::Command command, int argument = 0);
+	bool isWaiting() const;
+	void showOutcome(int net);
+	void showAdvice();
+	void loadStrategy();
+	void syncHands(const engine::Round &round);
+	void syncHands(const engine::TableState &state);
+	void clearHands();
 	void readSettings();
 	void writeSettings();
 	bool userReallyWantsToQuit();
@@ -51,12 +101,17 @@ private:
 	// UI member data
 	QAction *newGameAct;
 	QAction *quitAct;
+	QAction *replayAct;
+	QAction *statsAct;
+	QAction *adviceAct;
 	QAction *ruleAct;
 	QAction *aboutAct;
 	QMenu *gameMenu;
 	QMenu *helpMenu;
+	QMenu *rulesMenu;
+	QActionGroup *rulesGroup;
 	QToolBar *toolBar;
-
+	
 	QWidget *m_centralWidget;
 	QVBoxLayout *m_centralLayout;
 	
@@ -66,10 +121,11 @@ private:
 	QGroupBox *m_infoGroup;
 	QLabel *m_cardsLeftLabel;
 	QSpinBox *m_cardsLeftDisp;
+	QLabel *m_countLabel;
 	QLabel *m_mainInfoLabel;
 	
-	QGroupBox *m_playerCardsGroup;
-	HandView *m_playerHandView;
+	QGroupBox *m_playerCardsGroups[engine::Round::MaxHands];
+	HandView *m_playerHandViews[engine::Round::MaxHands];
 	
 	QGroupBox *m_betGroup;
 	QLabel *m_betLabel;
@@ -86,19 +142,46 @@ private:
 	QPushButton *m_dealButton;
 	QPushButton *m_hitButton;
 	QPushButton *m_stayButton;
+	QPushButton *m_doubleButton;
+	QPushButton *m_splitButton;
+	QPushButton *m_surrenderButton;
+	QPushButton *m_insureButton;
+	QLabel *m_adviceLabel;
+	
+	QDockWidget *m_statsDock;
+	QLabel *m_handsDisp;
+	QLabel *m_ratesDisp;
+	QLabel *m_netDisp;
+	QLabel *m_evDisp;
+	QLabel *m_streakDisp;
+	QLabel *m_blackjackDisp;
 	// end UI member data
 	
-	Deck m_deck;
+	engine::TableThread m_engine;
+	int m_seat;
+	engine::TableSnapshot m_snapshot;
+	quint32 m_posted;
+	QTimer *m_pollTimer;
+	QTimer *m_statsTimer;
+	QString m_handLogDir;
+	int m_variant;
 	Hand m_dealerHand;
-	Hand m_playerHand;
+	Hand m_playerHands[engine::Round::MaxHands];
 	
-	int m_cardsLeft;
-	int m_currentBet;
-	int m_balance;
-	QString m_mainInfo;
-	QString m_mainInfoStyleStr;
+	engine::HandLogReader m_replayLog;
+	QScopedPointer<engine::Replay> m_replay;
+	QString m_replayPath;
 	
-	bool m_isBetting;
+	engine::StrategyTableReader m_strategy;
+	QString m_strategyDir;
+	int m_strategyVariant;
+	engine::DealerOdds m_dealerOdds;
+	engine::PlayerOdds m_playerOdds;
+	
+	QString m_mainInfo;
+	InfoStyle m_mainInfoStyle;
+	int m_dirty;
+	bool m_updatePending;
 };
 
 
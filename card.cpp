@@ -1,76 +1,165 @@
+#include <QImage>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QWaitCondition>
 #include "card.h"
 
 const QString Card::CardValues = "23456789tjqka";
 const QString Card::CardSuits = "cdhs";
-QMap<QString, QImage> Card::CardImageMap = QMap<QString, QImage>();
+QPixmap *Card::CardPixmaps = 0;
+
+static const int NumImages = Card::CardBackIndex + 1; /**< card faces and the card back. */
+
+static QImage DecodedImages[NumImages];  /**< images decoded but not yet converted to pixmaps. */
+static bool IsDecoded[NumImages];        /**< the image is in DecodedImages, guarded by DecodeMutex. */
+static QAtomicInt IsClaimed[NumImages];  /**< 1 once a thread has started decoding the image. */
+static QMutex DecodeMutex;               /**< guards DecodedImages and IsDecoded. */
+static QWaitCondition DecodeDone;        /**< signalled whenever an image is decoded. */
 
 /**
- * Member function that reads in card images and populate the card image map.
- * This function is only called once when the first Card is constructed.
+ * Helper function that decodes a card image, on whichever thread claims it.
+ * Only the first caller for an index decodes; the others return at once.
+ * @param index engine::Card::id() of the card, or Card::CardBackIndex
+ * @return true: this call decoded the image
  */
-void Card::initCardImages()
+static bool decodeCardImage(int index)
 {
-	foreach(QChar suit, CardSuits)
+	if(!IsClaimed[index].testAndSetOrdered(0, 1))
 	{
-		foreach(QChar value, CardValues)
-		{
-			QString card = QString("%1%2").arg(value).arg(suit);
-			QString imageFileName = QString(":/images/cards/%1.png").arg(card);
-			QImage image(imageFileName);
-			CardImageMap[card] = image;
-		}
+		return false;
+	}
+	
+	QString imageFileName = ":/images/cards/cb.png";
+	if(index != Card::CardBackIndex)
+	{
+		engine::Card card(index);
+		imageFileName = QString(":/images/cards/%1%2.png")
+		                .arg(QChar(card.value())).arg(QChar(card.suitChar()));
 	}
+	QImage image(imageFileName);
 	
-	// Card back image
-	CardImageMap["cb"] = QImage(":/images/cards/cb.png");
+	QMutexLocker locker(&DecodeMutex);
+	DecodedImages[index] = image;
+	IsDecoded[index] = true;
+	DecodeDone.wakeAll();
+	return true;
 }
 
 /**
- * The Card class constructor.
- * Within the function the image map initializer is called 
- * on first Card construction.
- * @see initCardImages()
+ * Class that decodes one card image on the thread pool.
+ */
+class CardDecoder : public QRunnable
+{
+public:
+	explicit CardDecoder(int index) : m_index(index) {}
+	
+	void run() {decodeCardImage(m_index);}
+	
+private:
+	int m_index;
+};
+
+/**
+ * Member function that starts decoding every card image in the background.
+ * The images are decoded in parallel on the global thread pool, card back 
+ * first, and this function returns at once, so the window can be shown 
+ * while they are being decoded. An image that is needed before its turn 
+ * comes is decoded by cardPixmap() itself.
+ */
+void Card::preloadCardImages()
+{
+	QThreadPool::globalInstance()->start(new CardDecoder(CardBackIndex));
+	for(int id = 0; id < engine::Card::NumCards; ++id)
+	{
+		QThreadPool::globalInstance()->start(new CardDecoder(id));
+	}
+}
+
+/**
+ * Member function that returns the shared pixmap of a card face.
+ * Each pixmap is made the first time it is asked for: the image is 
+ * taken from the background decoding, decoded here if nobody has started 
+ * on it yet, or waited for if it is being decoded. Pixmaps can only be 
+ * made on the GUI thread, so the conversion is done here.
+ * QPixmap is implicitly shared, so handing out copies of the returned 
+ * pixmap never copies the image data.
+ * @param index engine::Card::id() of the card, or CardBackIndex
+ * @return The pixmap
  */
-Card::Card(QString name, CardFaceDirection facedir, QWidget *parent) :
-QLabel(parent), m_name(name), m_faceDown(facedir)
+const QPixmap &Card::cardPixmap(int index)
 {
-	static bool cardImageMapInitialized = false;
-	if(cardImageMapInitialized == false)
+	if(CardPixmaps == 0)
 	{
-		initCardImages();
-		cardImageMapInitialized = true;
+		CardPixmaps = new QPixmap[NumImages];
+	}
+	
+	if(CardPixmaps[index].isNull())
+	{
+		decodeCardImage(index);
+		
+		QImage image;
+		{
+			QMutexLocker locker(&DecodeMutex);
+			while(!IsDecoded[index])
+			{
+				DecodeDone.wait(&DecodeMutex);
+			}
+			image = DecodedImages[index];
+			DecodedImages[index] = QImage();
+		}
+		CardPixmaps[index] = QPixmap::fromImage(image);
 	}
 	
-	if(facedir == CardFaceUp)
+	return CardPixmaps[index];
+}
+
+/**
+ * The Card class constructor.
+ * @param card Engine value of the card
+ * @see cardPixmap()
+ */
+Card::Card(engine::Card card, CardFaceDirection facedir, QWidget *parent) :
+QLabel(parent), m_name(QString("%1%2").arg(QChar(card.value())).arg(QChar(card.suitChar()))), 
+m_card(card), m_faceDown(facedir)
+{
+	setPixmap(cardPixmap(m_faceDown ? CardBackIndex : m_card.id()));
+}
+
+/**
+ * Member function that binds the widget to another card.
+ * Nothing is done if the widget already shows that card that way.
+ * @param card Engine value of the card
+ * @param facedir Whether the card is facing up or down
+ */
+void Card::bind(engine::Card card, CardFaceDirection facedir)
+{
+	if(card != m_card)
 	{
-		m_pixmap = QPixmap::fromImage(CardImageMap[name]);
+		m_card = card;
+		m_name = QString("%1%2").arg(QChar(card.value())).arg(QChar(card.suitChar()));
+		m_faceDown = facedir;
+		setPixmap(cardPixmap(m_faceDown ? CardBackIndex : m_card.id()));
 	}
 	else
 	{
-		m_pixmap = QPixmap::fromImage(CardImageMap["cb"]);
+		setFacedown(facedir == CardFaceDown);
 	}
-	
-	setPixmap(m_pixmap);
 }
 
 /**
  * Member function that sets card face down or up.
+ * Flipping only swaps the shared pixmap handle.
  * @param wantFacedown = true: set the card face down; wantFacedown = false: set the card face up
  * @return Pointer to the Card object
  */
 Card *Card::setFacedown(bool wantFacedown)
 {
-	if(wantFacedown && !m_faceDown)
-	{
-		m_pixmap = QPixmap::fromImage(CardImageMap["cb"]);
-		setPixmap(m_pixmap);
-		m_faceDown = true;
-	}
-	if(!wantFacedown && m_faceDown)
+	if(wantFacedown != m_faceDown)
 	{
-		m_pixmap = QPixmap::fromImage(CardImageMap[m_name]);
-		setPixmap(m_pixmap);
-		m_faceDown = false;
+		m_faceDown = wantFacedown;
+		setPixmap(cardPixmap(m_faceDown ? CardBackIndex : m_card.id()));
 	}
 	
 	return this;
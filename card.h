@@ -6,15 +6,17 @@
 #include <QString>
 #include <QPixmap>
 #include <QChar>
-#include <QImage>
-#include <QMap>
+#include "engine/card.h"
 
 /**
- * Class that represents a card.
- * This class represents a playing card that's characterized by:
+ * Class that represents a card widget.
+ * This class shows a playing card that's characterized by:
  * - a name that consists of a "value + suit" string such as "5s"
- * - a pixmap picture
+ * - a pixmap picture, shared with every other Card of the same face
  * - a flag denoting whether the card is facing down or up
+ * 
+ * Card widgets are pooled by HandView: a widget is bound to whichever 
+ * card it has to show with bind() instead of being destroyed and rebuilt.
  */ 
 class Card : public QLabel
 {
@@ -31,9 +33,12 @@ public:
 	
 	static const QString CardValues; /**< static member containing all card values. */
 	static const QString CardSuits;  /**< static member containing all card suits. */
-	static QMap<QString, QImage> CardImageMap; /**< static member containing <card, image> mapping. */
+	static const int CardBackIndex = engine::Card::NumCards; /**< pixmap index of the card back. */
 	
-	Card(QString name, CardFaceDirection facedir = CardFaceUp, QWidget *parent = 0);
+	Card(engine::Card card = engine::Card(), CardFaceDirection facedir = CardFaceUp, 
+	     QWidget *parent = 0);
+	
+	void bind(engine::Card card, CardFaceDirection facedir);
 	
 	/**
 	 * Member function that checks whether card is facing down.
@@ -45,7 +50,7 @@ public:
 	 * Member function that checks whether card is Ace.
 	 * @return true: card is Ace; false: card is not Ace
 	 */
-	bool isAce() const {return m_name[0] == 'a';}
+	bool isAce() const {return m_card.isAce();}
 	
 	/**
 	 * Member function that returns card name.
@@ -65,14 +70,22 @@ public:
 	 */
 	QChar suit() const {return m_name[1];}
 	
+	/**
+	 * Member function that returns the engine value of the card.
+	 * @return The UI-free card used by the game engine
+	 */
+	engine::Card card() const {return m_card;}
+	
 	Card *setFacedown(bool wantFacedown);
 	
-private:
-	void initCardImages();
+	static void preloadCardImages();
+	static const QPixmap &cardPixmap(int index);
 	
 private:
+	static QPixmap *CardPixmaps;
+	
 	QString m_name;
-	QPixmap m_pixmap;
+	engine::Card m_card;
 	bool m_faceDown;
 };
 
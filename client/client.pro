@@ -0,0 +1,19 @@
+######################################################################
+# Command line client and load generator for the table server
+######################################################################
+
+TEMPLATE = app
+CONFIG += console thread
+CONFIG -= qt app_bundle
+TARGET = blackjack-client
+DEPENDPATH += .
+INCLUDEPATH += . ..
+QMAKE_CXXFLAGS += -std=c++11
+
+# Game engine static library - build ../engine/engine.pro first
+LIBS += -L../engine -lengine -lpthread
+PRE_TARGETDEPS += ../engine/libengine.a
+
+# Input
+HEADERS += loadgenerator.h
+SOURCES += loadgenerator.cpp main.cpp
@@ -0,0 +1,281 @@
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "engine/protocol.h"
+#include "loadgenerator.h"
+
+/**
+ * Function that opens a TCP connection to a server.
+ * @param host Host name or address
+ * @param port TCP port
+ * @return The blocking socket, -1 if the server cannot be reached
+ */
+int connectTo(const char *host, int port)
+{
+	addrinfo hints;
+	addrinfo *addresses;
+	char service[16];
+	
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	snprintf(service, sizeof(service), "%d", port);
+	if(getaddrinfo(host, service, &hints, &addresses) != 0)
+	{
+		return -1;
+	}
+	
+	int fd = -1;
+	for(addrinfo *address = addresses; address != 0 && fd < 0; address = address->ai_next)
+	{
+		fd = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+		if(fd >= 0 && connect(fd, address->ai_addr, address->ai_addrlen) < 0)
+		{
+			close(fd);
+			fd = -1;
+		}
+	}
+	freeaddrinfo(addresses);
+	
+	if(fd >= 0)
+	{
+		int one = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	}
+	return fd;
+}
+
+/**
+ * The LoadResult struct constructor.
+ * All tallies start at zero.
+ */
+LoadResult::LoadResult() : connections(0), requests(0), refused(0), rounds(0)
+{}
+
+/**
+ * Member function that adds another tally to this one.
+ * The latencies are sorted again.
+ * @param other Tally to be added
+ */
+void LoadResult::merge(const LoadResult &other)
+{
+	connections += other.connections;
+	requests += other.requests;
+	refused += other.refused;
+	rounds += other.rounds;
+	latencies.insert(latencies.end(), other.latencies.begin(), other.latencies.end());
+	std::sort(latencies.begin(), latencies.end());
+}
+
+/**
+ * Member function that returns a quantile of the latency.
+ * @param fraction The quantile, 0.5 for the median
+ * @return Nanoseconds from request to reply
+ */
+uint32_t LoadResult::latencyAt(double fraction) const
+{
+	if(latencies.empty()) return 0;
+	size_t i = static_cast<size_t>(fraction * (latencies.size() - 1) + 0.5);
+	return latencies[std::min(i, latencies.size() - 1)];
+}
+
+/**
+ * Struct that holds one connection of the load and its last reply.
+ */
+struct LoadGenerator::Player
+{
+	int fd;                                               /**< the socket. */
+	std::vector<uint8_t> received;                        /**< bytes of a partial reply. */
+	std::chrono::steady_clock::time_point sentAt;         /**< when the request was sent. */
+	uint32_t rounds;                                      /**< rounds the table had settled. */
+	engine::TableState state;                             /**< the last reply. */
+};
+
+/**
+ * The LoadGenerator class constructor.
+ * @param host Host name or address of the server
+ * @param port TCP port of the server
+ * @param variant Rules every table plays, an engine::VariantId
+ * @param bet Bet placed at every table
+ */
+LoadGenerator::LoadGenerator(const std::string &host, int port, int variant, int bet) :
+m_host(host), m_port(port), m_variant(variant), m_bet(bet)
+{}
+
+/**
+ * Member function that runs the load.
+ * @param connections Number of tables to play at once
+ * @param numThreads Number of worker threads, at least 1
+ * @param seconds How long to play
+ * @return Merged tally of all workers
+ */
+LoadResult LoadGenerator::run(int connections, int numThreads, double seconds) const
+{
+	if(numThreads < 1) numThreads = 1;
+	if(numThreads > connections) numThreads = connections;
+	
+	std::vector<LoadResult> results(numThreads);
+	std::vector<std::thread> workers;
+	
+	for(int i = 0; i < numThreads; ++i)
+	{
+		int share = connections / numThreads + (i < connections % numThreads ? 1 : 0);
+		workers.push_back(std::thread(&LoadGenerator::work, this, share, seconds, &results[i]));
+	}
+	
+	LoadResult total;
+	for(int i = 0; i < numThreads; ++i)
+	{
+		workers[i].join();
+		total.merge(results[i]);
+	}
+	return total;
+}
+
+/**
+ * Helper function that sends a request for a player.
+ * @param player The player
+ * @param command An engine::Command
+ * @param argument Its argument
+ * @return true: sent; false: the connection failed
+ */
+bool LoadGenerator::request(Player &player, uint8_t command, int32_t argument) const
+{
+	engine::Request request;
+	uint8_t bytes[engine::Request::Size];
+	
+	request.command = command;
+	request.argument = argument;
+	request.encode(bytes);
+	player.sentAt = std::chrono::steady_clock::now();
+	return ::send(player.fd, bytes, sizeof(bytes), MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(bytes));
+}
+
+/**
+ * Worker thread body.
+ * Every player first joins a table of the variant, then plays until the
+ * time is up; replies still on their way are waited for.
+ * @param connections Number of tables the worker plays
+ * @param seconds How long to play
+ * @param result Where to store the worker's tally
+ */
+void LoadGenerator::work(int connections, double seconds, LoadResult *result) const
+{
+	std::vector<Player> players(connections);
+	int epollFd = epoll_create1(EPOLL_CLOEXEC);
+	int pending = 0;
+	LoadResult tally;
+	
+	for(int i = 0; i < connections; ++i)
+	{
+		Player &player = players[i];
+		player.fd = connectTo(m_host.c_str(), m_port);
+		player.rounds = 0;
+		if(player.fd < 0)
+		{
+			perror("connect");
+			continue;
+		}
+		++tally.connections;
+		
+		epoll_event event;
+		event.events = EPOLLIN;
+		event.data.u32 = i;
+		epoll_ctl(epollFd, EPOLL_CTL_ADD, player.fd, &event);
+		if(request(player, engine::CommandJoin, m_variant)) ++pending;
+	}
+	
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() +
+	    std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+	epoll_event events[256];
+	uint8_t buffer[4096];
+	
+	while(pending > 0)
+	{
+		int n = epoll_wait(epollFd, events, 256, 1000);
+		if(n < 0 && errno != EINTR) break;
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		
+		for(int e = 0; e < n; ++e)
+		{
+			Player &player = players[events[e].data.u32];
+			ssize_t size = recv(player.fd, buffer, sizeof(buffer), 0);
+			if(size <= 0)
+			{
+				if(size < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+				close(player.fd);
+				--pending;
+				continue;
+			}
+			player.received.insert(player.received.end(), buffer, buffer + size);
+			
+			size_t length = player.received.size() >= 2 ? player.received[0] | player.received[1] << 8 : 0;
+			if(player.received.size() < 2 || player.received.size() < 2 + length)
+			{
+				continue;
+			}
+			
+			--pending;
+			++tally.requests;
+			tally.latencies.push_back(static_cast<uint32_t>(
+			    std::chrono::duration_cast<std::chrono::nanoseconds>(now - player.sentAt).count()));
+			
+			bool valid = player.state.decode(&player.received[2], length);
+			player.received.clear();
+			if(!valid)
+			{
+				close(player.fd);
+				continue;
+			}
+			if(player.state.status != engine::ReplyOk) ++tally.refused;
+			tally.rounds += player.state.rounds - player.rounds;
+			player.rounds = player.state.rounds;
+			
+			if(now >= end)
+			{
+				close(player.fd);
+				continue;
+			}
+			
+			// Bet, deal and hit to 17
+			const engine::TableState &state = player.state;
+			bool sent;
+			if(state.isBetting())
+			{
+				sent = (state.flags & engine::TableState::CanDeal) ?
+				       request(player, engine::CommandDeal, 0) :
+				       request(player, engine::CommandBet, m_bet);
+			}
+			else if(state.isAllowed(engine::Hit) && state.hands[state.current].score() < 17)
+			{
+				sent = request(player, engine::CommandHit, 0);
+			}
+			else
+			{
+				sent = request(player, engine::CommandStand, 0);
+			}
+			
+			if(sent)
+			{
+				++pending;
+			}
+			else
+			{
+				close(player.fd);
+			}
+		}
+	}
+	
+	close(epollFd);
+	std::sort(tally.latencies.begin(), tally.latencies.end());
+	*result = tally;
+}
@@ -0,0 +1,53 @@
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+int connectTo(const char *host, int port);
+
+/**
+ * Struct that holds the tally of a load run.
+ */
+struct LoadResult
+{
+	uint64_t connections;            /**< connections opened. */
+	uint64_t requests;               /**< requests answered. */
+	uint64_t refused;                /**< requests the server did not carry out. */
+	uint64_t rounds;                 /**< rounds settled. */
+	std::vector<uint32_t> latencies; /**< nanoseconds from each request to its reply, sorted. */
+	
+	LoadResult();
+	
+	void merge(const LoadResult &other);
+	uint32_t latencyAt(double fraction) const;
+};
+
+/**
+ * Class that plays many tables on a server at once.
+ * Connections are spread over worker threads, each of which waits on its
+ * own with epoll. Every connection plays a closed loop: it bets, deals and
+ * hits to 17, sending the next request as soon as the last reply is in.
+ */
+class LoadGenerator
+{
+public:
+	LoadGenerator(const std::string &host, int port, int variant, int bet);
+	
+	LoadResult run(int connections, int numThreads, double seconds) const;
+
+private:
+	struct Player;
+	
+	void work(int connections, double seconds, LoadResult *result) const;
+	bool request(Player &player, uint8_t command, int32_t argument) const;
+
+private:
+	std::string m_host;
+	int m_port;
+	int m_variant;
+	int m_bet;
+};
+
+#endif
@@ -0,0 +1,226 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <thread>
+#include "engine/protocol.h"
+#include "engine/ruleset.h"
+#include "loadgenerator.h"
+
+/**
+ * Helper function that prints the command line usage.
+ */
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+	        "Usage: %s [-H host] [-p port] [-c connections] [-t threads] [-d seconds] [-r rules] [-b bet]\n"
+	        "  -H  server host (default localhost)\n"
+	        "  -p  server port (default %d)\n"
+	        "  -c  play this many tables at once as a load test instead of interactively\n"
+	        "  -t  load test worker threads (default: all cores)\n"
+	        "  -d  load test duration in seconds (default 10)\n"
+	        "  -r  load test rules: house, strip, downtown, atlantic or 6to5 (default house)\n"
+	        "  -b  load test bet (default 10)\n"
+	        "Interactive commands: join RULES, bet N, clear, deal, hit, stand, double, split,\n"
+	        "surrender, insure, state, new, quit\n",
+	        prog, engine::DefaultPort);
+}
+
+/**
+ * Helper function that reads exactly size bytes from a socket.
+ * @return true: read; false: the connection was closed
+ */
+static bool readFully(int fd, uint8_t *out, size_t size)
+{
+	while(size > 0)
+	{
+		ssize_t n = recv(fd, out, size, 0);
+		if(n <= 0) return false;
+		out += n;
+		size -= n;
+	}
+	return true;
+}
+
+/**
+ * Helper function that prints a hand as card names.
+ */
+static void printHand(const char *who, const engine::Hand &hand, bool hidden, const char *note)
+{
+	printf("%-8s", who);
+	for(int i = 0; i < hand.numCards(); ++i)
+	{
+		printf(" %c%c", hand.card(i).value(), hand.card(i).suitChar());
+	}
+	printf("%s  (%d)%s\n", hidden ? " ??" : "", hand.score(), note);
+}
+
+/**
+ * Helper function that prints the state of the table.
+ */
+static void printState(const engine::TableState &state)
+{
+	static const char *Outcomes[] = {" won", " lost", " push"};
+	bool betting = state.isBetting();
+	
+	if(state.status == engine::ReplyRefused) printf("not allowed now\n");
+	if(state.status == engine::ReplyBadCommand) printf("unknown command\n");
+	
+	if(state.dealer.numCards() > 0)
+	{
+		printHand("Dealer", state.dealer, state.holeHidden, "");
+		for(int i = 0; i < state.numHands; ++i)
+		{
+			char who[16];
+			char note[32];
+			snprintf(who, sizeof(who), "%sHand %d", !betting && i == state.current ? ">" : " ", i + 1);
+			snprintf(note, sizeof(note), "%s%s%s",
+			         state.handFlags[i] & engine::TableState::Doubled ? " doubled" : "",
+			         state.handFlags[i] & engine::TableState::Surrendered ? " surrendered" : "",
+			         betting && state.outcomes[i] <= engine::Push ? Outcomes[state.outcomes[i]] : "");
+			printHand(who, state.hands[i], false, note);
+		}
+	}
+	
+	printf("balance %d  bet %d", state.balance, state.bet + state.extraWager);
+	if(betting && state.rounds > 0)
+	{
+		printf("  last round %+d", state.lastNet);
+	}
+	printf("\n");
+	
+	static const char *Actions[] = {"stand", "hit", "double", "split", "surrender", "insure"};
+	printf("you may:");
+	if(betting)
+	{
+		printf(" join bet clear%s new", state.flags & engine::TableState::CanDeal ? " deal" : "");
+	}
+	for(int a = engine::Stand; a <= engine::Insure; ++a)
+	{
+		if(state.isAllowed(static_cast<engine::Action>(a))) printf(" %s", Actions[a]);
+	}
+	printf("\n");
+}
+
+/**
+ * Helper function that plays one table from the command line.
+ * @param fd Socket connected to the server
+ * @return Exit code
+ */
+static int interactive(int fd)
+{
+	static const struct {const char *word; engine::Command command;} Words[] = {
+		{"join", engine::CommandJoin}, {"bet", engine::CommandBet}, {"clear", engine::CommandBet},
+		{"deal", engine::CommandDeal}, {"hit", engine::CommandHit}, {"stand", engine::CommandStand},
+		{"double", engine::CommandDouble}, {"split", engine::CommandSplit},
+		{"surrender", engine::CommandSurrender}, {"insure", engine::CommandInsure},
+		{"state", engine::CommandState}, {"new", engine::CommandNewGame}
+	};
+	char line[256];
+	engine::Request request = {engine::CommandState, 0};
+	
+	for(;;)
+	{
+		uint8_t bytes[engine::TableState::MaxSize];
+		request.encode(bytes);
+		if(send(fd, bytes, engine::Request::Size, MSG_NOSIGNAL) < 0 || !readFully(fd, bytes, 2))
+		{
+			fprintf(stderr, "connection lost\n");
+			return 1;
+		}
+		size_t length = bytes[0] | bytes[1] << 8;
+		engine::TableState state;
+		if(length > sizeof(bytes) - 2 || !readFully(fd, bytes + 2, length) || !state.decode(bytes + 2, length))
+		{
+			fprintf(stderr, "bad reply\n");
+			return 1;
+		}
+		printState(state);
+		
+		// Read commands until one is understood
+		for(;;)
+		{
+			printf("> ");
+			fflush(stdout);
+			if(fgets(line, sizeof(line), stdin) == 0) return 0;
+			
+			char word[32];
+			char argument[32] = "";
+			if(sscanf(line, "%31s %31s", word, argument) < 1) continue;
+			if(strcmp(word, "quit") == 0) return 0;
+			
+			request.command = 0;
+			for(size_t i = 0; i < sizeof(Words) / sizeof(Words[0]); ++i)
+			{
+				if(strcmp(word, Words[i].word) == 0) request.command = Words[i].command;
+			}
+			request.argument = request.command == engine::CommandJoin ? engine::findVariant(argument) :
+			                   strcmp(word, "bet") == 0 ? atoi(argument) : 0;
+			if(request.command != 0) break;
+			printf("unknown command %s\n", word);
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const char *host = "localhost";
+	int port = engine::DefaultPort;
+	int connections = 0;
+	int numThreads = std::thread::hardware_concurrency();
+	double seconds = 10.0;
+	int variant = engine::HouseVariant;
+	int bet = 10;
+	int opt;
+	
+	while((opt = getopt(argc, argv, "H:p:c:t:d:r:b:h")) != -1)
+	{
+		switch(opt)
+		{
+		case 'H': host = optarg; break;
+		case 'p': port = atoi(optarg); break;
+		case 'c': connections = atoi(optarg); break;
+		case 't': numThreads = atoi(optarg); break;
+		case 'd': seconds = atof(optarg); break;
+		case 'r': variant = engine::findVariant(optarg); break;
+		case 'b': bet = atoi(optarg); break;
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	
+	if(variant < 0 || bet < 1)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+	
+	if(connections <= 0)
+	{
+		int fd = connectTo(host, port);
+		if(fd < 0)
+		{
+			fprintf(stderr, "cannot connect to %s:%d\n", host, port);
+			return 1;
+		}
+		int code = interactive(fd);
+		close(fd);
+		return code;
+	}
+	
+	LoadGenerator generator(host, port, variant, bet);
+	LoadResult result = generator.run(connections, numThreads, seconds);
+	
+	printf("connections   %llu\n", static_cast<unsigned long long>(result.connections));
+	printf("requests      %llu (%llu refused)\n", static_cast<unsigned long long>(result.requests),
+	       static_cast<unsigned long long>(result.refused));
+	printf("rounds        %llu\n", static_cast<unsigned long long>(result.rounds));
+	printf("requests/sec  %.0f\n", result.requests / seconds);
+	printf("rounds/sec    %.0f\n", result.rounds / seconds);
+	printf("latency       p50 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n",
+	       result.latencyAt(0.5) / 1000.0, result.latencyAt(0.99) / 1000.0,
+	       result.latencyAt(0.999) / 1000.0, result.latencyAt(1.0) / 1000.0);
+	return 0;
+}
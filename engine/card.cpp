@@ -0,0 +1,32 @@
+#include <string.h>
+#include "card.h"
+
+namespace engine {
+
+/**
+ * Member function that builds a card from its name.
+ * @param name Card name e.g. "5s", as used by ::Card
+ * @return The card, invalid if the name is not recognised
+ */
+Card Card::fromName(const char *name)
+{
+	const char *values = "23456789tjqka";
+	const char *suits = "cdhs";
+	
+	if(name == 0 || name[0] == '\0' || name[1] == '\0')
+	{
+		return Card();
+	}
+	
+	const char *value = strchr(values, name[0]);
+	const char *suit = strchr(suits, name[1]);
+	
+	if(value == 0 || suit == 0)
+	{
+		return Card();
+	}
+	
+	return Card(static_cast<int>(value - values), static_cast<int>(suit - suits));
+}
+
+} // namespace engine
@@ -0,0 +1,112 @@
+#ifndef ENGINE_CARD_H
+#define ENGINE_CARD_H
+
+#include <stdint.h>
+
+namespace engine {
+
+/**
+ * Points of each rank, indexed by Card::rank(). Aces count as 1.
+ */
+constexpr uint8_t RankPoints[13] = {2, 3, 4, 5, 6, 7, 8, 9, 10, 10, 10, 10, 1};
+
+/**
+ * Value type that represents a playing card.
+ * A card is stored in a single byte as rank * 4 + suit, where the rank 
+ * indexes "23456789tjqka" and the suit indexes "cdhs" - the same ordering 
+ * as ::Card::CardValues and ::Card::CardSuits.
+ */
+class Card
+{
+public:
+	/**
+	 * enum type representing the card ranks.
+	 */
+	enum Rank {
+		           Two = 0, Three, Four, Five, Six, Seven, Eight, Nine,
+		           Ten, Jack, Queen, King, Ace
+		       };
+	
+	static const int NumRanks = 13; /**< number of ranks in a suit. */
+	static const int NumSuits = 4;  /**< number of suits in a deck. */
+	static const int NumCards = 52; /**< number of cards in a deck. */
+	
+	/**
+	 * Default constructor - builds an invalid card.
+	 */
+	Card() : m_id(NumCards) {}
+	
+	/**
+	 * Card constructor from a card id.
+	 * @param id Card id in the range [0, 52)
+	 */
+	explicit Card(int id) : m_id(static_cast<uint8_t>(id)) {}
+	
+	/**
+	 * Card constructor from rank and suit.
+	 * @param rank Rank index in the range [0, 13)
+	 * @param suit Suit index in the range [0, 4)
+	 */
+	Card(int rank, int suit) : m_id(static_cast<uint8_t>(rank * NumSuits + suit)) {}
+	
+	static Card fromName(const char *name);
+	
+	/**
+	 * Member function that returns the card id.
+	 * @return Card id in the range [0, 52), 52 if the card is invalid
+	 */
+	int id() const {return m_id;}
+	
+	/**
+	 * Member function that returns the card rank.
+	 * @return Rank index - Two is 0, Ace is 12
+	 */
+	int rank() const {return m_id >> 2;}
+	
+	/**
+	 * Member function that returns the card suit.
+	 * @return Suit index - one of 0 to 3 for "cdhs"
+	 */
+	int suit() const {return m_id & 3;}
+	
+	/**
+	 * Member function that checks whether the card is valid.
+	 * @return true: card is one of the 52; false: card is invalid
+	 */
+	bool isValid() const {return m_id < NumCards;}
+	
+	/**
+	 * Member function that checks whether card is Ace.
+	 * @return true: card is Ace; false: card is not Ace
+	 */
+	bool isAce() const {return rank() == Ace;}
+	
+	/**
+	 * Member function that returns the card's point.
+	 * Note Aces are always counted as 1 in here.
+	 * @return Point of the card
+	 */
+	int points() const {return RankPoints[rank()];}
+	
+	/**
+	 * Member function that returns card value character.
+	 * @return One of "23456789tjqka"
+	 */
+	char value() const {return "23456789tjqka"[rank()];}
+	
+	/**
+	 * Member function that returns card suit character.
+	 * @return One of "cdhs"
+	 */
+	char suitChar() const {return "cdhs"[suit()];}
+	
+	bool operator==(Card other) const {return m_id == other.m_id;}
+	bool operator!=(Card other) const {return m_id != other.m_id;}
+	
+private:
+	uint8_t m_id;
+};
+
+} // namespace engine
+
+#endif
@@ -0,0 +1,71 @@
+#include "composition.h"
+#include "shoe.h"
+
+namespace engine {
+
+/**
+ * Default constructor for the Composition class.
+ * The composition is empty.
+ */
+Composition::Composition() : m_total(0)
+{
+	for(int i = 0; i < NumValues; ++i)
+	{
+		m_counts[i] = 0;
+	}
+}
+
+/**
+ * Composition class constructor for full decks.
+ * @param numDecks Number of full decks
+ */
+Composition::Composition(int numDecks) : m_total(numDecks * Card::NumCards)
+{
+	for(int i = 0; i < TenIndex; ++i)
+	{
+		m_counts[i] = static_cast<uint16_t>(numDecks * Card::NumSuits);
+	}
+	m_counts[TenIndex] = static_cast<uint16_t>(numDecks * Card::NumSuits * 4);
+}
+
+/**
+ * Function that counts the cards that are left in a shoe.
+ * The shoe keeps its cards left per rank, so this takes constant time.
+ * @param shoe The shoe
+ * @return Composition of the undealt part of the shoe
+ */
+Composition Composition::remaining(const Shoe &shoe)
+{
+	Composition c;
+	
+	c.m_counts[0] = static_cast<uint16_t>(shoe.rankLeft(Card::Ace));
+	for(int r = Card::Two; r <= Card::Nine; ++r)
+	{
+		c.m_counts[r + 1] = static_cast<uint16_t>(shoe.rankLeft(r));
+	}
+	c.m_counts[TenIndex] = static_cast<uint16_t>(shoe.rankLeft(Card::Ten) + shoe.rankLeft(Card::Jack) + 
+	                                             shoe.rankLeft(Card::Queen) + shoe.rankLeft(Card::King));
+	c.m_total = shoe.cardsLeft();
+	
+	return c;
+}
+
+/**
+ * Member function that packs the counts into a cache key.
+ * The counts of Aces to Nines take 6 bits each and the ten-valued count 
+ * takes 8 bits, which covers every composition of an 8 deck shoe.
+ * @return Key that is unique for each composition
+ */
+uint64_t Composition::key() const
+{
+	uint64_t key = m_counts[TenIndex];
+	
+	for(int i = 0; i < TenIndex; ++i)
+	{
+		key = (key << 6) | m_counts[i];
+	}
+	
+	return key;
+}
+
+} // namespace engine
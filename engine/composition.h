@@ -0,0 +1,69 @@
+#ifndef ENGINE_COMPOSITION_H
+#define ENGINE_COMPOSITION_H
+
+#include <stdint.h>
+#include "card.h"
+
+namespace engine {
+
+class Shoe;
+
+/**
+ * Class that counts the cards of a shoe by point value.
+ * Suits do not matter to the rules and neither do the ten-valued ranks, 
+ * so the count is kept for 10 values: index 0 holds the Aces, index 1 to 
+ * 8 the Twos to Nines and index 9 the ten-valued cards.
+ */
+class Composition
+{
+public:
+	static const int NumValues = 10; /**< distinct point values. */
+	static const int TenIndex = 9;   /**< index of the ten-valued cards. */
+	
+	Composition();
+	explicit Composition(int numDecks);
+	
+	static Composition remaining(const Shoe &shoe);
+	
+	/**
+	 * Function that maps a card to its value index.
+	 * @param card The card
+	 * @return 0 for an Ace, points - 1 for any other card
+	 */
+	static int indexOf(Card card) {return card.points() - 1;}
+	
+	/**
+	 * Member function that returns the count of one value.
+	 * @param index Value index, 0 (Ace) to 9 (ten-valued)
+	 * @return Number of such cards
+	 */
+	int count(int index) const {return m_counts[index];}
+	
+	/**
+	 * Member function that returns the total number of cards.
+	 * @return Number of cards
+	 */
+	int total() const {return m_total;}
+	
+	/**
+	 * Member function that removes one card of a value.
+	 * @param index Value index, 0 (Ace) to 9 (ten-valued)
+	 */
+	void remove(int index) {--m_counts[index]; --m_total;}
+	
+	/**
+	 * Member function that adds one card of a value.
+	 * @param index Value index, 0 (Ace) to 9 (ten-valued)
+	 */
+	void add(int index) {++m_counts[index]; ++m_total;}
+	
+	uint64_t key() const;
+	
+private:
+	uint16_t m_counts[NumValues];
+	int m_total;
+};
+
+} // namespace engine
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef ENGINE_COUNTING_H
+#define ENGINE_COUNTING_H
+
+#include <stdint.h>
+
+namespace engine {
+
+/**
+ * enum type representing the card counting systems tallied by Shoe.
+ */
+enum CountSystem {
+	                 HiLo = 0,       /**< enum value HiLo: balanced, tens and Aces -1, 2 to 6 +1. */
+	                 KO = 1,         /**< enum value KO: unbalanced Knock-Out, like HiLo with 7 as +1. */
+	                 OmegaII = 2,    /**< enum value OmegaII: balanced level two, Aces neutral. */
+	                 NumCountSystems = 3
+	             };
+
+/**
+ * Tag of each rank in each counting system, indexed by CountSystem and
+ * then by Card::rank().
+ */
+constexpr int8_t CountTags[NumCountSystems][13] = {
+	{ 1,  1,  1,  1,  1,  0,  0,  0, -1, -1, -1, -1, -1},
+	{ 1,  1,  1,  1,  1,  1,  0,  0, -1, -1, -1, -1, -1},
+	{ 1,  1,  2,  2,  2,  1,  0, -1, -2, -2, -2, -2,  0}
+};
+
+/**
+ * Function that returns the running count of a freshly shuffled shoe.
+ * Balanced systems start at 0. KO starts at 4 - 4 * decks, so that its
+ * key count of +4 means the same in shoes of any size.
+ * @param system The counting system
+ * @param numDecks Number of decks in the shoe
+ * @return Initial running count
+ */
+inline int initialCount(CountSystem system, int numDecks)
+{
+	return system == KO ? 4 - 4 * numDecks : 0;
+}
+
+} // namespace engine
+
+#endif
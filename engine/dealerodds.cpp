@@ -0,0 +1,138 @@
+#include "dealerodds.h"
+#include "rules.h"
+
+namespace engine {
+
+/**
+ * The DealerOdds class constructor.
+ * @param hitSoft17 The dealer hits soft 17 instead of standing on all 17s
+ */
+DealerOdds::DealerOdds(bool hitSoft17) : m_hitSoft17(hitSoft17)
+{}
+
+/**
+ * Member function that sets how the dealer plays a soft 17.
+ * The cache only holds distributions of one rule, so it is emptied when 
+ * the rule changes.
+ * @param hitSoft17 The dealer hits soft 17 instead of standing on all 17s
+ */
+void DealerOdds::setHitSoft17(bool hitSoft17)
+{
+	if(hitSoft17 != m_hitSoft17)
+	{
+		m_hitSoft17 = hitSoft17;
+		clear();
+	}
+}
+
+/**
+ * Member function that returns the distribution of the dealer's final hand.
+ * Probabilities of an exhausted shoe are left out, so they only sum to 1 
+ * if the shoe cannot run out during the dealer's play.
+ * @param upcard Value index of the dealer's face-up card, 0 (Ace) to 9
+ * @param shoe Cards left in the shoe, upcard already removed
+ * @return Distribution of the dealer's final hand, valid until clear()
+ */
+const DealerDistribution &DealerOdds::distribution(int upcard, const Composition &shoe)
+{
+	std::unordered_map<uint64_t, DealerDistribution> &cache = m_cache[upcard];
+	std::unordered_map<uint64_t, DealerDistribution>::iterator it = cache.find(shoe.key());
+	
+	if(it != cache.end())
+	{
+		return it->second;
+	}
+	
+	DealerDistribution result;
+	for(int i = 0; i < DealerDistribution::NumFinals; ++i)
+	{
+		result.p[i] = 0.0;
+	}
+	
+	Composition remaining = shoe;
+	draw(upcard + 1, upcard == 0 ? 1 : 0, 1, 1.0, remaining, result);
+	
+	return cache[shoe.key()] = result;
+}
+
+/**
+ * Member function that empties the cache.
+ */
+void DealerOdds::clear()
+{
+	for(int i = 0; i < Composition::NumValues; ++i)
+	{
+		m_cache[i].clear();
+	}
+}
+
+/**
+ * Member function that returns the number of cached distributions.
+ * @return Number of cached distributions
+ */
+size_t DealerOdds::cacheSize() const
+{
+	size_t size = 0;
+	
+	for(int i = 0; i < Composition::NumValues; ++i)
+	{
+		size += m_cache[i].size();
+	}
+	
+	return size;
+}
+
+/**
+ * Helper function that walks every card the dealer can draw.
+ * @param hardTotal Dealer's total with Aces counted as 1
+ * @param numAces Number of Aces in the dealer's hand
+ * @param numCards Number of cards in the dealer's hand
+ * @param prob Probability of reaching this hand
+ * @param shoe Cards left in the shoe, restored before returning
+ * @param result Distribution the final hands are added to
+ */
+void DealerOdds::draw(int hardTotal, int numAces, int numCards, double prob, 
+                      Composition &shoe, DealerDistribution &result) const
+{
+	bool soft = numAces != 0 && hardTotal <= 11;
+	int score = hardTotal + (soft ? 10 : 0);
+	
+	if(score > DealerStandsOn || (score == DealerStandsOn && !(m_hitSoft17 && soft)))
+	{
+		if(score > 21)
+		{
+			result.p[DealerDistribution::Bust] += prob;
+		}
+		else if(score == 21 && numCards == 2)
+		{
+			result.p[DealerDistribution::Blackjack] += prob;
+		}
+		else
+		{
+			result.p[score - DealerStandsOn] += prob;
+		}
+		return;
+	}
+	
+	int total = shoe.total();
+	if(total == 0)
+	{
+		return;
+	}
+	
+	for(int i = 0; i < Composition::NumValues; ++i)
+	{
+		int count = shoe.count(i);
+		if(count == 0)
+		{
+			continue;
+		}
+		
+		shoe.remove(i);
+		draw(hardTotal + i + 1, numAces + (i == 0 ? 1 : 0), numCards + 1, 
+		     prob * count / total, shoe, result);
+		shoe.add(i);
+	}
+}
+
+} // namespace engine
@@ -0,0 +1,79 @@
+#ifndef ENGINE_DEALERODDS_H
+#define ENGINE_DEALERODDS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <unordered_map>
+#include "composition.h"
+
+namespace engine {
+
+/**
+ * Struct that holds the probabilities of the dealer's final hands.
+ */
+struct DealerDistribution
+{
+	/**
+	 * enum type representing the dealer's final hand.
+	 */
+	enum Final {
+		           Seventeen = 0, Eighteen, Nineteen, Twenty, 
+		           TwentyOne,     /**< 21 with three or more cards. */
+		           Blackjack,     /**< 21 with two cards. */
+		           Bust,
+		           NumFinals
+		       };
+	
+	double p[NumFinals]; /**< probability of each final hand. */
+};
+
+/**
+ * Class that calculates the exact distribution of the dealer's final hand.
+ * The dealer draws from the given shoe composition until he reaches 17, 
+ * and on a soft 17 too where the rules have him hit it, as 
+ * RuleSet::dealerMustHit() does, and every branch is weighted by the odds 
+ * of drawing each card without replacement. Results are cached per upcard 
+ * by the packed composition, so asking again during a shoe is a hash 
+ * lookup. An instance is not thread-safe; give each thread its own.
+ */
+class DealerOdds
+{
+public:
+	explicit DealerOdds(bool hitSoft17 = false);
+	
+	void setHitSoft17(bool hitSoft17);
+	
+	/**
+	 * Member function that checks how the dealer plays a soft 17.
+	 * @return true: the dealer hits soft 17; false: he stands on all 17s
+	 */
+	bool hitSoft17() const {return m_hitSoft17;}
+	
+	const DealerDistribution &distribution(int upcard, const Composition &shoe);
+	
+	/**
+	 * Member function that calculates a distribution for a card.
+	 * @param upcard The dealer's face-up card
+	 * @param shoe Cards left in the shoe, upcard already removed
+	 * @return Distribution of the dealer's final hand
+	 */
+	const DealerDistribution &distribution(Card upcard, const Composition &shoe)
+	{
+		return distribution(Composition::indexOf(upcard), shoe);
+	}
+	
+	void clear();
+	size_t cacheSize() const;
+	
+private:
+	void draw(int hardTotal, int numAces, int numCards, double prob, 
+	          Composition &shoe, DealerDistribution &result) const;
+	
+private:
+	bool m_hitSoft17;
+	std::unordered_map<uint64_t, DealerDistribution> m_cache[Composition::NumValues];
+};
+
+} // namespace engine
+
+#endif
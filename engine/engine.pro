@@ -0,0 +1,15 @@
+######################################################################
+# Headless Blackjack game engine - no Qt dependency
+######################################################################
+
+TEMPLATE = lib
+CONFIG += staticlib
+CONFIG -= qt
+TARGET = engine
+DEPENDPATH += .
+INCLUDEPATH += .
+QMAKE_CXXFLAGS += -std=c++11
+
+# Input
+HEADERS += card.h composition.h counting.h dealerodds.h hand.h handbatch.h handlog.h journal.h playerodds.h protocol.h replay.h rng.h round.h rules.h ruleset.h seqlock.h sessionstats.h shoe.h spscqueue.h strategytable.h table.h tablethread.h
+SOURCES += card.cpp composition.cpp dealerodds.cpp handbatch.cpp handlog.cpp journal.cpp playerodds.cpp protocol.cpp replay.cpp rng.cpp round.cpp rules.cpp ruleset.cpp sessionstats.cpp shoe.cpp strategytable.cpp table.cpp tablethread.cpp
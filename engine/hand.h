@@ -0,0 +1,110 @@
+#ifndef ENGINE_HAND_H
+#define ENGINE_HAND_H
+
+#include "card.h"
+
+namespace engine {
+
+/**
+ * Class that represents a hand of cards without any UI attached.
+ * The cards are held by value in a fixed-capacity array, so a hand never 
+ * allocates. The hard total, the number of Aces and the resulting best 
+ * score are kept up to date as cards are added, so scoring a hand is a 
+ * field read.
+ */
+class Hand
+{
+public:
+	/**
+	 * Maximum number of cards in a hand.
+	 * 21 Aces is the longest hand that has not busted, so one more card 
+	 * always busts it.
+	 */
+	static const int MaxCards = 22;
+	
+	Hand() : m_numCards(0), m_hardTotal(0), m_numAces(0), m_score(0) {}
+	
+	/**
+	 * Member function that adds a card to the hand.
+	 * Aces are counted as 1 in the hard total; one of them is counted 
+	 * as 11 in the score if that does not bust the hand.
+	 * @param card Card to be added to the hand
+	 * @return Reference to the hand object
+	 */
+	Hand& operator<<(Card card)
+	{
+		if(m_numCards < MaxCards)
+		{
+			m_cards[m_numCards++] = card;
+			m_hardTotal += card.points();
+			m_numAces += card.isAce();
+			m_score = m_hardTotal + (isSoft() ? 10 : 0);
+		}
+		return *this;
+	}
+	
+	/**
+	 * Member function that returns the best score of the hand.
+	 * @return Best possible score of the hand
+	 */
+	int score() const {return m_score;}
+	
+	/**
+	 * Member function that returns the score with all Aces counted as 1.
+	 * @return Hard total of the hand
+	 */
+	int hardTotal() const {return m_hardTotal;}
+	
+	/**
+	 * Member function that checks whether an Ace is counted as 11.
+	 * @return true: the hand is soft; false: the hand is hard
+	 */
+	bool isSoft() const {return m_numAces != 0 && m_hardTotal <= 11;}
+	
+	/**
+	 * Member function that check whether is hand is a Blackjack.
+	 * @return true: the hand is a Blackjack; false: the hand is not a Blackjack
+	 */
+	bool isBlackjack() const {return m_numCards == 2 && m_score == 21;}
+	
+	/**
+	 * Member function that check whether is hand has busted.
+	 * @return true: the hand has busted; false: the hand has not busted
+	 */
+	bool busted() const {return m_score > 21;}
+	
+	/**
+	 * Member function that returns the number of cards in the hand.
+	 * @return Number of cards in the hand
+	 */
+	int numCards() const {return m_numCards;}
+	
+	/**
+	 * Member function that returns the number of Aces in the hand.
+	 * @return Number of Aces in the hand
+	 */
+	int numAces() const {return m_numAces;}
+	
+	/**
+	 * Member function that returns one card of the hand.
+	 * @param i Index of the card, must be less than numCards()
+	 * @return The card
+	 */
+	Card card(int i) const {return m_cards[i];}
+	
+	/**
+	 * Member function that empties the hand.
+	 */
+	void clear() {m_numCards = m_hardTotal = m_numAces = m_score = 0;}
+	
+private:
+	Card m_cards[MaxCards];
+	uint8_t m_numCards;
+	uint8_t m_hardTotal;
+	uint8_t m_numAces;
+	uint8_t m_score;
+};
+
+} // namespace engine
+
+#endif
@@ -0,0 +1,505 @@
+#include "handbatch.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ENGINE_BATCH_X86 1
+#include <immintrin.h>
+#endif
+
+namespace engine {
+
+// Vector lanes add up net in 32 bits for at most this many steps before
+// they are flushed into the 64-bit sum: |net| < 8 * 2^22 per hand
+static const size_t FlushSteps = 32;
+
+/**
+ * Helper function that returns the multiplier the vector paths divide by
+ * the Blackjack denominator with.
+ * For x < 2^25 and a denominator of 2 to 8, the high half of x times
+ * ceil(2^32 / den) is exactly x / den rounded down, as the scalar path
+ * divides.
+ * @param den Blackjack denominator, 1 to 8
+ * @return ceil(2^32 / den), or 0 for a denominator of 1, which needs no
+ * division
+ */
+static inline uint32_t reciprocalOf(int den)
+{
+	return den > 1 ? static_cast<uint32_t>(((uint64_t(1) << 32) + den - 1) / den) : 0;
+}
+
+/**
+ * Helper function that scores one hand.
+ * @param hardTotal Hard total of the hand
+ * @param numAces Number of Aces in the hand
+ * @return Best possible score
+ */
+static inline int32_t scoreOf(int32_t hardTotal, int32_t numAces)
+{
+	return hardTotal + (numAces != 0 && hardTotal <= 11 ? 10 : 0);
+}
+
+/**
+ * Helper function that settles one round, as RuleSet::resolve() and
+ * RuleSet::win() would.
+ * @return What the round paid the player
+ */
+static inline int32_t settleOne(int32_t playerScore, int32_t playerCards, int32_t wager,
+                                int32_t dealerScore, int32_t dealerCards, const BatchRules &rules)
+{
+	bool playerBusted = playerScore > 21;
+	bool dealerBusted = dealerScore > 21;
+	bool playerBlackjack = playerCards == 2 && playerScore == 21;
+	bool dealerBlackjack = dealerCards == 2 && dealerScore == 21;
+	
+	if(playerBusted)
+	{
+		return rules.bustPush && dealerBusted ? 0 : -wager;
+	}
+	if(playerBlackjack)
+	{
+		return dealerBlackjack ? 0 : wager * rules.blackjackNum / rules.blackjackDen;
+	}
+	if(dealerBusted || (!dealerBlackjack && playerScore > dealerScore))
+	{
+		return wager;
+	}
+	if(dealerBlackjack || playerScore < dealerScore)
+	{
+		return -wager;
+	}
+	return 0;
+}
+
+#ifdef ENGINE_BATCH_X86
+
+/**
+ * Helper function that multiplies 32-bit lanes, keeping the low halves.
+ * SSE2 has no _mm_mullo_epi32, so the even and odd lanes are multiplied
+ * into 64 bits separately.
+ */
+__attribute__((target("sse2")))
+static inline __m128i mulloSse2(__m128i a, __m128i b)
+{
+	__m128i even = _mm_mul_epu32(a, b);
+	__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+	                          _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+/**
+ * Helper function that multiplies unsigned 32-bit lanes, keeping the high
+ * halves.
+ */
+__attribute__((target("sse2")))
+static inline __m128i mulhiSse2(__m128i a, __m128i b)
+{
+	__m128i even = _mm_mul_epu32(a, b);
+	__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 3, 1)),
+	                          _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 3, 1)));
+}
+
+/**
+ * Helper function that multiplies unsigned 32-bit lanes, keeping the high
+ * halves.
+ */
+__attribute__((target("avx2")))
+static inline __m256i mulhiAvx2(__m256i a, __m256i b)
+{
+	__m256i even = _mm256_srli_epi64(_mm256_mul_epu32(a, b), 32);
+	__m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+	return _mm256_blend_epi32(even, odd, 0xaa);
+}
+
+/**
+ * Helper function that scores hands four at a time.
+ * @return Number of hands scored, a multiple of 4
+ */
+__attribute__((target("sse2")))
+static size_t scoresSse2(const int32_t *hard, const int32_t *aces, int32_t *out, size_t n)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i ten = _mm_set1_epi32(10);
+	const __m128i twelve = _mm_set1_epi32(12);
+	size_t i = 0;
+	
+	for(; i + 4 <= n; i += 4)
+	{
+		__m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(hard + i));
+		__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(aces + i));
+		__m128i soft = _mm_andnot_si128(_mm_cmpeq_epi32(a, zero), _mm_cmplt_epi32(h, twelve));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_add_epi32(h, _mm_and_si128(soft, ten)));
+	}
+	return i;
+}
+
+/**
+ * Helper function that scores hands eight at a time.
+ * @return Number of hands scored, a multiple of 8
+ */
+__attribute__((target("avx2")))
+static size_t scoresAvx2(const int32_t *hard, const int32_t *aces, int32_t *out, size_t n)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i ten = _mm256_set1_epi32(10);
+	const __m256i twelve = _mm256_set1_epi32(12);
+	size_t i = 0;
+	
+	for(; i + 8 <= n; i += 8)
+	{
+		__m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(hard + i));
+		__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(aces + i));
+		__m256i soft = _mm256_andnot_si256(_mm256_cmpeq_epi32(a, zero), _mm256_cmpgt_epi32(twelve, h));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_add_epi32(h, _mm256_and_si256(soft, ten)));
+	}
+	return i;
+}
+
+/**
+ * Helper function that settles rounds four at a time.
+ * Every lane computes all the cases and masks pick the one that applies,
+ * so there are no branches.
+ * @param sum Sum of net, updated in place
+ * @return Number of rounds settled, a multiple of 4
+ */
+__attribute__((target("sse2")))
+static size_t settleSse2(const HandBatch &players, const HandBatch &dealers,
+                         const BatchRules &rules, int32_t *net, size_t n, int64_t &sum)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i ten = _mm_set1_epi32(10);
+	const __m128i twelve = _mm_set1_epi32(12);
+	const __m128i two = _mm_set1_epi32(2);
+	const __m128i twentyOne = _mm_set1_epi32(21);
+	const __m128i bustPush = _mm_set1_epi32(rules.bustPush ? -1 : 0);
+	const __m128i num = _mm_set1_epi32(rules.blackjackNum);
+	const __m128i reciprocal = _mm_set1_epi32(static_cast<int32_t>(reciprocalOf(rules.blackjackDen)));
+	const __m128i divides = _mm_set1_epi32(rules.blackjackDen > 1 ? -1 : 0);
+	const __m128i *ph = reinterpret_cast<const __m128i *>(players.hardTotals());
+	const __m128i *pa = reinterpret_cast<const __m128i *>(players.numAces());
+	const __m128i *pc = reinterpret_cast<const __m128i *>(players.numCards());
+	const __m128i *pw = reinterpret_cast<const __m128i *>(players.wagers());
+	const __m128i *dh = reinterpret_cast<const __m128i *>(dealers.hardTotals());
+	const __m128i *da = reinterpret_cast<const __m128i *>(dealers.numAces());
+	const __m128i *dc = reinterpret_cast<const __m128i *>(dealers.numCards());
+	__m128i *out = reinterpret_cast<__m128i *>(net);
+	size_t steps = n / 4;
+	
+	for(size_t first = 0; first < steps; first += FlushSteps)
+	{
+		size_t last = first + FlushSteps < steps ? first + FlushSteps : steps;
+		__m128i total = zero;
+		
+		for(size_t k = first; k < last; ++k)
+		{
+			__m128i h = _mm_loadu_si128(ph + k);
+			__m128i w = _mm_loadu_si128(pw + k);
+			__m128i ps = _mm_add_epi32(h, _mm_and_si128(ten, _mm_andnot_si128(
+			                 _mm_cmpeq_epi32(_mm_loadu_si128(pa + k), zero), _mm_cmplt_epi32(h, twelve))));
+			h = _mm_loadu_si128(dh + k);
+			__m128i ds = _mm_add_epi32(h, _mm_and_si128(ten, _mm_andnot_si128(
+			                 _mm_cmpeq_epi32(_mm_loadu_si128(da + k), zero), _mm_cmplt_epi32(h, twelve))));
+			
+			__m128i playerBusted = _mm_cmpgt_epi32(ps, twentyOne);
+			__m128i dealerBusted = _mm_cmpgt_epi32(ds, twentyOne);
+			__m128i playerBlackjack = _mm_and_si128(_mm_cmpeq_epi32(_mm_loadu_si128(pc + k), two),
+			                                        _mm_cmpeq_epi32(ps, twentyOne));
+			__m128i dealerBlackjack = _mm_and_si128(_mm_cmpeq_epi32(_mm_loadu_si128(dc + k), two),
+			                                        _mm_cmpeq_epi32(ds, twentyOne));
+			
+			// Won: not busted and either a Blackjack against none, or a
+			// dealer bust, or more points than a dealer without Blackjack
+			__m128i beats = _mm_or_si128(dealerBusted, _mm_andnot_si128(dealerBlackjack, _mm_cmpgt_epi32(ps, ds)));
+			__m128i won = _mm_andnot_si128(playerBusted, _mm_or_si128(
+			                  _mm_andnot_si128(dealerBlackjack, playerBlackjack),
+			                  _mm_andnot_si128(playerBlackjack, beats)));
+			// Lost: busted unless both bust and that pushes, or no
+			// Blackjack and no dealer bust against a dealer Blackjack or
+			// more points
+			__m128i loses = _mm_or_si128(dealerBlackjack, _mm_cmplt_epi32(ps, ds));
+			__m128i lost = _mm_or_si128(
+			                   _mm_andnot_si128(_mm_and_si128(bustPush, dealerBusted), playerBusted),
+			                   _mm_andnot_si128(playerBusted, _mm_andnot_si128(playerBlackjack,
+			                                    _mm_andnot_si128(dealerBusted, loses))));
+			
+			// Blackjack pays w * num / den in integers, as settleOne() does
+			__m128i product = mulloSse2(w, num);
+			__m128i blackjackPays = _mm_or_si128(_mm_and_si128(divides, mulhiSse2(product, reciprocal)),
+			                                     _mm_andnot_si128(divides, product));
+			__m128i pays = _mm_or_si128(_mm_and_si128(playerBlackjack, blackjackPays),
+			                            _mm_andnot_si128(playerBlackjack, w));
+			__m128i result = _mm_or_si128(_mm_and_si128(won, pays),
+			                              _mm_and_si128(lost, _mm_sub_epi32(zero, w)));
+			
+			_mm_storeu_si128(out + k, result);
+			total = _mm_add_epi32(total, result);
+		}
+		
+		int32_t lanes[4];
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), total);
+		sum += static_cast<int64_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+	}
+	return steps * 4;
+}
+
+/**
+ * Helper function that settles rounds eight at a time.
+ * This is settleSse2() on 256-bit registers.
+ * @param sum Sum of net, updated in place
+ * @return Number of rounds settled, a multiple of 8
+ */
+__attribute__((target("avx2")))
+static size_t settleAvx2(const HandBatch &players, const HandBatch &dealers,
+                         const BatchRules &rules, int32_t *net, size_t n, int64_t &sum)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i ten = _mm256_set1_epi32(10);
+	const __m256i twelve = _mm256_set1_epi32(12);
+	const __m256i two = _mm256_set1_epi32(2);
+	const __m256i twentyOne = _mm256_set1_epi32(21);
+	const __m256i bustPush = _mm256_set1_epi32(rules.bustPush ? -1 : 0);
+	const __m256i num = _mm256_set1_epi32(rules.blackjackNum);
+	const __m256i reciprocal = _mm256_set1_epi32(static_cast<int32_t>(reciprocalOf(rules.blackjackDen)));
+	const __m256i divides = _mm256_set1_epi32(rules.blackjackDen > 1 ? -1 : 0);
+	const __m256i *ph = reinterpret_cast<const __m256i *>(players.hardTotals());
+	const __m256i *pa = reinterpret_cast<const __m256i *>(players.numAces());
+	const __m256i *pc = reinterpret_cast<const __m256i *>(players.numCards());
+	const __m256i *pw = reinterpret_cast<const __m256i *>(players.wagers());
+	const __m256i *dh = reinterpret_cast<const __m256i *>(dealers.hardTotals());
+	const __m256i *da = reinterpret_cast<const __m256i *>(dealers.numAces());
+	const __m256i *dc = reinterpret_cast<const __m256i *>(dealers.numCards());
+	__m256i *out = reinterpret_cast<__m256i *>(net);
+	size_t steps = n / 8;
+	
+	for(size_t first = 0; first < steps; first += FlushSteps)
+	{
+		size_t last = first + FlushSteps < steps ? first + FlushSteps : steps;
+		__m256i total = zero;
+		
+		for(size_t k = first; k < last; ++k)
+		{
+			__m256i h = _mm256_loadu_si256(ph + k);
+			__m256i w = _mm256_loadu_si256(pw + k);
+			__m256i ps = _mm256_add_epi32(h, _mm256_and_si256(ten, _mm256_andnot_si256(
+			                 _mm256_cmpeq_epi32(_mm256_loadu_si256(pa + k), zero), _mm256_cmpgt_epi32(twelve, h))));
+			h = _mm256_loadu_si256(dh + k);
+			__m256i ds = _mm256_add_epi32(h, _mm256_and_si256(ten, _mm256_andnot_si256(
+			                 _mm256_cmpeq_epi32(_mm256_loadu_si256(da + k), zero), _mm256_cmpgt_epi32(twelve, h))));
+			
+			__m256i playerBusted = _mm256_cmpgt_epi32(ps, twentyOne);
+			__m256i dealerBusted = _mm256_cmpgt_epi32(ds, twentyOne);
+			__m256i playerBlackjack = _mm256_and_si256(_mm256_cmpeq_epi32(_mm256_loadu_si256(pc + k), two),
+			                                           _mm256_cmpeq_epi32(ps, twentyOne));
+			__m256i dealerBlackjack = _mm256_and_si256(_mm256_cmpeq_epi32(_mm256_loadu_si256(dc + k), two),
+			                                           _mm256_cmpeq_epi32(ds, twentyOne));
+			
+			__m256i beats = _mm256_or_si256(dealerBusted, _mm256_andnot_si256(dealerBlackjack, _mm256_cmpgt_epi32(ps, ds)));
+			__m256i won = _mm256_andnot_si256(playerBusted, _mm256_or_si256(
+			                  _mm256_andnot_si256(dealerBlackjack, playerBlackjack),
+			                  _mm256_andnot_si256(playerBlackjack, beats)));
+			__m256i loses = _mm256_or_si256(dealerBlackjack, _mm256_cmpgt_epi32(ds, ps));
+			__m256i lost = _mm256_or_si256(
+			                   _mm256_andnot_si256(_mm256_and_si256(bustPush, dealerBusted), playerBusted),
+			                   _mm256_andnot_si256(playerBusted, _mm256_andnot_si256(playerBlackjack,
+			                                       _mm256_andnot_si256(dealerBusted, loses))));
+			
+			__m256i product = _mm256_mullo_epi32(w, num);
+			__m256i blackjackPays = _mm256_blendv_epi8(product, mulhiAvx2(product, reciprocal), divides);
+			__m256i pays = _mm256_blendv_epi8(w, blackjackPays, playerBlackjack);
+			__m256i result = _mm256_or_si256(_mm256_and_si256(won, pays),
+			                                 _mm256_and_si256(lost, _mm256_sub_epi32(zero, w)));
+			
+			_mm256_storeu_si256(out + k, result);
+			total = _mm256_add_epi32(total, result);
+		}
+		
+		int32_t lanes[8];
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), total);
+		for(int j = 0; j < 8; ++j)
+		{
+			sum += lanes[j];
+		}
+	}
+	return steps * 8;
+}
+
+#endif // ENGINE_BATCH_X86
+
+/**
+ * Function that returns the widest vector instructions of this CPU.
+ * The CPU is only asked once.
+ * @return SimdAvx2 or SimdSse2 on x86, SimdScalar elsewhere
+ */
+SimdLevel bestSimdLevel()
+{
+#ifdef ENGINE_BATCH_X86
+	static const SimdLevel level = __builtin_cpu_supports("avx2") ? SimdAvx2 :
+	                               __builtin_cpu_supports("sse2") ? SimdSse2 : SimdScalar;
+	return level;
+#else
+	return SimdScalar;
+#endif
+}
+
+/**
+ * The HandBatch class constructor.
+ * @param size Number of hands, all empty with no wager
+ */
+HandBatch::HandBatch(size_t size)
+{
+	resize(size);
+}
+
+/**
+ * Member function that changes the number of hands.
+ * All hands are emptied and their wagers cleared. Growing allocates;
+ * reusing a batch of the same size does not.
+ * @param size Number of hands
+ */
+void HandBatch::resize(size_t size)
+{
+	m_hardTotals.assign(size, 0);
+	m_numAces.assign(size, 0);
+	m_numCards.assign(size, 0);
+	m_wagers.assign(size, 0);
+}
+
+/**
+ * Member function that empties every hand.
+ * The wagers are kept.
+ */
+void HandBatch::clear()
+{
+	m_hardTotals.assign(m_hardTotals.size(), 0);
+	m_numAces.assign(m_numAces.size(), 0);
+	m_numCards.assign(m_numCards.size(), 0);
+}
+
+/**
+ * Member function that copies a hand into the batch.
+ * @param i Index of the hand, less than size()
+ * @param hand The hand
+ */
+void HandBatch::set(size_t i, const Hand &hand)
+{
+	m_hardTotals[i] = hand.hardTotal();
+	m_numAces[i] = hand.numAces();
+	m_numCards[i] = hand.numCards();
+}
+
+/**
+ * Member function that scores every hand.
+ * @param out Where to store the best score of each hand, size() entries
+ * @param level Instructions to use, at most bestSimdLevel()
+ */
+void HandBatch::scores(int32_t *out, SimdLevel level) const
+{
+	scores(0, size(), out, level);
+}
+
+/**
+ * Member function that counts the hands that have busted.
+ * The hands are scored a block at a time on the stack, so this never
+ * allocates.
+ * @param level Instructions to use, at most bestSimdLevel()
+ * @return Number of hands over 21
+ */
+size_t HandBatch::countBusted(SimdLevel level) const
+{
+	const size_t BlockSize = 256;
+	int32_t block[BlockSize];
+	size_t busted = 0;
+	
+	for(size_t first = 0; first < size(); first += BlockSize)
+	{
+		size_t n = size() - first < BlockSize ? size() - first : BlockSize;
+		scores(first, n, block, level);
+		for(size_t i = 0; i < n; ++i)
+		{
+			busted += block[i] > 21;
+		}
+	}
+	return busted;
+}
+
+/**
+ * Helper function that scores a range of hands.
+ * @param first Index of the first hand
+ * @param n Number of hands
+ * @param out Where to store the best score of each hand, n entries
+ * @param level Instructions to use, at most bestSimdLevel()
+ */
+void HandBatch::scores(size_t first, size_t n, int32_t *out, SimdLevel level) const
+{
+	const int32_t *hard = hardTotals() + first;
+	const int32_t *aces = numAces() + first;
+	size_t i = 0;
+	
+	if(level > bestSimdLevel())
+	{
+		level = bestSimdLevel();
+	}
+
+#ifdef ENGINE_BATCH_X86
+	if(level == SimdAvx2)
+	{
+		i = scoresAvx2(hard, aces, out, n);
+	}
+	else if(level == SimdSse2)
+	{
+		i = scoresSse2(hard, aces, out, n);
+	}
+#endif
+
+	for(; i < n; ++i)
+	{
+		out[i] = scoreOf(hard[i], aces[i]);
+	}
+}
+
+/**
+ * Function that settles a batch of independent rounds.
+ * Round i is the player's hand i against the dealer's hand i, and pays as
+ * RuleSet::resolve() and RuleSet::win() would for a hand that was not
+ * split: net[i] is +wager, the Blackjack payout, 0 or -wager.
+ * @param players The player's hands, with their wagers
+ * @param dealers The dealer's hand of each round, after the dealer has played
+ * @param rules Rules of the variant played
+ * @param net Where to store what each round paid, players.size() entries
+ * @param level Instructions to use, at most bestSimdLevel()
+ * @return Sum of net
+ */
+int64_t settleBatch(const HandBatch &players, const HandBatch &dealers,
+                    const BatchRules &rules, int32_t *net, SimdLevel level)
+{
+	size_t n = players.size() < dealers.size() ? players.size() : dealers.size();
+	size_t i = 0;
+	int64_t sum = 0;
+	
+	if(level > bestSimdLevel())
+	{
+		level = bestSimdLevel();
+	}
+
+#ifdef ENGINE_BATCH_X86
+	if(level == SimdAvx2)
+	{
+		i = settleAvx2(players, dealers, rules, net, n, sum);
+	}
+	else if(level == SimdSse2)
+	{
+		i = settleSse2(players, dealers, rules, net, n, sum);
+	}
+#endif
+
+	for(; i < n; ++i)
+	{
+		net[i] = settleOne(scoreOf(players.hardTotals()[i], players.numAces()[i]),
+		                   players.numCards()[i], players.wagers()[i],
+		                   scoreOf(dealers.hardTotals()[i], dealers.numAces()[i]),
+		                   dealers.numCards()[i], rules);
+		sum += net[i];
+	}
+	return sum;
+}
+
+} // namespace engine
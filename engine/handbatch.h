@@ -0,0 +1,150 @@
+#ifndef ENGINE_HANDBATCH_H
+#define ENGINE_HANDBATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "hand.h"
+
+namespace engine {
+
+/**
+ * enum type representing the vector instructions a batch is evaluated with.
+ */
+enum SimdLevel {
+	               SimdScalar = 0, /**< enum value SimdScalar - plain C++, one hand at a time. */
+	               SimdSse2 = 1,   /**< enum value SimdSse2 - four hands per instruction. */
+	               SimdAvx2 = 2    /**< enum value SimdAvx2 - eight hands per instruction. */
+	           };
+
+SimdLevel bestSimdLevel();
+
+/**
+ * Class that holds many independent hands as a structure of arrays.
+ * Instead of one Hand per round, each column (hard total, number of Aces,
+ * number of cards, wager) is its own contiguous array of 32-bit lanes, so
+ * scoring and settling a batch runs down the columns with SSE2 or AVX2,
+ * eight hands per instruction on AVX2. The cards themselves are not kept;
+ * the columns are all the rules need.
+ *
+ * The vector paths are chosen at run time by bestSimdLevel(), so the
+ * library needs no special compiler flags; the scalar path is used on
+ * other CPUs and for the hands left over at the end of a batch.
+ */
+class HandBatch
+{
+public:
+	explicit HandBatch(size_t size = 0);
+	
+	void resize(size_t size);
+	void clear();
+	
+	/**
+	 * Member function that returns the number of hands.
+	 * @return Number of hands in the batch
+	 */
+	size_t size() const {return m_hardTotals.size();}
+	
+	/**
+	 * Member function that adds a card to one hand.
+	 * @param i Index of the hand, less than size()
+	 * @param card Card to be added to the hand
+	 */
+	void add(size_t i, Card card)
+	{
+		m_hardTotals[i] += card.points();
+		m_numAces[i] += card.isAce();
+		++m_numCards[i];
+	}
+	
+	void set(size_t i, const Hand &hand);
+	
+	/**
+	 * Member function that sets the wager on one hand.
+	 * @param i Index of the hand, less than size()
+	 * @param wager Amount wagered, less than 2^22
+	 */
+	void setWager(size_t i, int32_t wager) {m_wagers[i] = wager;}
+	
+	/**
+	 * Member function that returns the best score of one hand.
+	 * @param i Index of the hand, less than size()
+	 * @return Best possible score, as Hand::score()
+	 */
+	int score(size_t i) const
+	{
+		return m_hardTotals[i] + (m_numAces[i] != 0 && m_hardTotals[i] <= 11 ? 10 : 0);
+	}
+	
+	/**
+	 * Member function that returns the column of hard totals.
+	 * @return size() hard totals, Aces counted as 1
+	 */
+	const int32_t *hardTotals() const {return m_hardTotals.data();}
+	
+	/**
+	 * Member function that returns the column of Ace counts.
+	 * @return size() numbers of Aces
+	 */
+	const int32_t *numAces() const {return m_numAces.data();}
+	
+	/**
+	 * Member function that returns the column of card counts.
+	 * @return size() numbers of cards
+	 */
+	const int32_t *numCards() const {return m_numCards.data();}
+	
+	/**
+	 * Member function that returns the column of wagers.
+	 * @return size() wagers
+	 */
+	const int32_t *wagers() const {return m_wagers.data();}
+	
+	void scores(int32_t *out, SimdLevel level = bestSimdLevel()) const;
+	size_t countBusted(SimdLevel level = bestSimdLevel()) const;
+
+private:
+	void scores(size_t first, size_t n, int32_t *out, SimdLevel level) const;
+
+private:
+	std::vector<int32_t> m_hardTotals;
+	std::vector<int32_t> m_numAces;
+	std::vector<int32_t> m_numCards;
+	std::vector<int32_t> m_wagers;
+};
+
+/**
+ * Struct that holds the rules settling a batch depends on.
+ */
+struct BatchRules
+{
+	bool bustPush;    /**< a busted player pushes a busted dealer. */
+	int blackjackNum; /**< Blackjack pays blackjackNum (1 to 8) ... */
+	int blackjackDen; /**< ... to blackjackDen (1 to 8). */
+};
+
+int64_t settleBatch(const HandBatch &players, const HandBatch &dealers,
+                    const BatchRules &rules, int32_t *net,
+                    SimdLevel level = bestSimdLevel());
+
+/**
+ * Function that settles a batch under a variant's rules.
+ * @tparam Rules RuleSet of the variant played
+ * @param players The player's hands, with their wagers
+ * @param dealers The dealer's hand of each round, after the dealer has played
+ * @param net Where to store what each round paid, size() entries
+ * @param level Instructions to use, at most bestSimdLevel()
+ * @return Sum of net
+ * @see settleBatch()
+ */
+template<class Rules>
+int64_t settleBatch(const HandBatch &players, const HandBatch &dealers, int32_t *net,
+                    SimdLevel level = bestSimdLevel())
+{
+	static const BatchRules rules = {Rules::BustPush, Rules::BlackjackNum, Rules::BlackjackDen};
+	return settleBatch(players, dealers, rules, net, level);
+}
+
+} // namespace engine
+
+#endif
@@ -0,0 +1,254 @@
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "handlog.h"
+
+namespace engine {
+
+static_assert(sizeof(HandLogHeader) == 32, "HandLogHeader must have a fixed layout");
+static_assert(sizeof(HandRecord) == 168, "HandRecord must have a fixed layout");
+
+static const size_t WriteBufferSize = 1 << 20;
+
+/**
+ * Member function that fills in the record from a finished round.
+ * The cards of all the player's hands go into playerCards one hand after 
+ * the other; in the rare round with more than Hand::MaxCards of them the 
+ * rest are left out, but the actions are enough to replay it.
+ * @param shoeId Shuffles of the shoe once the first four cards were dealt
+ * @param round Round number in the session
+ * @param bet Amount wagered on each hand
+ * @param balance Balance after settling
+ * @param outcome Outcome of the first hand
+ * @param played The round, after Round::stand()
+ */
+void HandRecord::set(uint32_t shoeId, uint32_t round, int bet, int64_t balance, Outcome outcome, 
+                     const Round &played)
+{
+	memset(this, 0, sizeof(*this));
+	
+	this->shoeId = shoeId;
+	this->round = round;
+	this->bet = bet;
+	this->balance = balance;
+	this->outcome = static_cast<uint8_t>(outcome);
+	
+	for(int h = 0; h < played.numHands(); ++h)
+	{
+		const Hand &player = played.player(h);
+		for(int i = 0; i < player.numCards() && numPlayerCards < Hand::MaxCards; ++i)
+		{
+			playerCards[numPlayerCards++] = static_cast<uint8_t>(player.card(i).id());
+		}
+	}
+	
+	const Hand &dealer = played.dealer();
+	numDealerCards = static_cast<uint8_t>(dealer.numCards());
+	for(int i = 0; i < dealer.numCards(); ++i)
+	{
+		dealerCards[i] = static_cast<uint8_t>(dealer.card(i).id());
+	}
+	
+	numActions = static_cast<uint8_t>(played.numActions());
+	for(int i = 0; i < played.numActions(); ++i)
+	{
+		actions[i] = static_cast<uint8_t>(played.action(i));
+	}
+}
+
+/**
+ * The HandLogWriter class constructor.
+ */
+HandLogWriter::HandLogWriter() : m_file(0), m_buffer(0)
+{}
+
+/**
+ * The HandLogWriter class destructor.
+ * The file is flushed and closed.
+ */
+HandLogWriter::~HandLogWriter()
+{
+	close();
+}
+
+/**
+ * Member function that opens a file for appending.
+ * A new file gets a header describing the session. An existing file is 
+ * only appended to if its header matches.
+ * @param path File to write
+ * @param seed Seed of the shoe's random number generator
+ * @param stream Jumps applied to the generator after seeding
+ * @param numDecks Decks in the shoe
+ * @param penetration Fraction of the shoe dealt before the cut card
+ * @param variant Rules played, an engine::VariantId
+ * @return true: the file is open; false: it could not be opened or does 
+ * not belong to this session
+ */
+bool HandLogWriter::open(const char *path, uint64_t seed, uint32_t stream, int numDecks, 
+                         double penetration, int variant)
+{
+	close();
+	
+	HandLogHeader header;
+	memcpy(header.magic, "BJHL", 4);
+	header.version = Version;
+	header.recordSize = sizeof(HandRecord);
+	header.seed = seed;
+	header.stream = stream;
+	header.numDecks = static_cast<uint16_t>(numDecks);
+	header.variant = static_cast<uint16_t>(variant);
+	header.penetration = penetration;
+	
+	// Check the header of an existing file before appending to it
+	FILE *existing = fopen(path, "rb");
+	bool isNew = true;
+	if(existing != 0)
+	{
+		HandLogHeader h;
+		size_t n = fread(&h, 1, sizeof(h), existing);
+		fclose(existing);
+		
+		if(n != 0 && (n != sizeof(h) || memcmp(&h, &header, sizeof(header)) != 0))
+		{
+			return false;
+		}
+		isNew = (n == 0);
+	}
+	
+	m_file = fopen(path, "ab");
+	if(m_file == 0)
+	{
+		return false;
+	}
+	
+	m_buffer = new char[WriteBufferSize];
+	setvbuf(m_file, m_buffer, _IOFBF, WriteBufferSize);
+	
+	if(isNew && fwrite(&header, sizeof(header), 1, m_file) != 1)
+	{
+		close();
+		return false;
+	}
+	
+	return true;
+}
+/**
+ * Member function that appends one record.
+ * @param record The record
+ * @return true: the record was buffered; false: no file is open or the 
+ * write failed
+ */
+bool HandLogWriter::append(const HandRecord &record)
+{
+	return m_file != 0 && fwrite(&record, sizeof(record), 1, m_file) == 1;
+}
+
+/**
+ * Member function that writes the buffered records to the file.
+ */
+void HandLogWriter::flush()
+{
+	if(m_file != 0)
+	{
+		fflush(m_file);
+	}
+}
+
+/**
+ * Member function that flushes and closes the file.
+ */
+void HandLogWriter::close()
+{
+	if(m_file != 0)
+	{
+		fclose(m_file);
+		m_file = 0;
+	}
+	
+	delete[] m_buffer;
+	m_buffer = 0;
+}
+
+/**
+ * The HandLogReader class constructor.
+ */
+HandLogReader::HandLogReader() : m_map(0), m_size(0), m_records(0), m_count(0)
+{}
+
+/**
+ * The HandLogReader class destructor.
+ * The file is unmapped.
+ */
+HandLogReader::~HandLogReader()
+{
+	close();
+}
+
+/**
+ * Member function that maps a file.
+ * A trailing partial record, e.g. from a crash while writing, is ignored.
+ * @param path File to read
+ * @return true: the file is mapped; false: it could not be read or is 
+ * not a hand history file
+ */
+bool HandLogReader::open(const char *path)
+{
+	close();
+	
+	int fd = ::open(path, O_RDONLY);
+	if(fd < 0)
+	{
+		return false;
+	}
+	
+	struct stat st;
+	if(fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(HandLogHeader))
+	{
+		::close(fd);
+		return false;
+	}
+	
+	m_size = st.st_size;
+	m_map = mmap(0, m_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	
+	if(m_map == MAP_FAILED)
+	{
+		m_map = 0;
+		m_size = 0;
+		return false;
+	}
+	
+	const HandLogHeader &h = header();
+	if(memcmp(h.magic, "BJHL", 4) != 0 || h.version != HandLogWriter::Version || 
+	   h.recordSize != sizeof(HandRecord))
+	{
+		close();
+		return false;
+	}
+	
+	madvise(m_map, m_size, MADV_SEQUENTIAL);
+	m_records = reinterpret_cast<const HandRecord *>(static_cast<const char *>(m_map) + sizeof(HandLogHeader));
+	m_count = (m_size - sizeof(HandLogHeader)) / sizeof(HandRecord);
+	return true;
+}
+
+/**
+ * Member function that unmaps the file.
+ */
+void HandLogReader::close()
+{
+	if(m_map != 0)
+	{
+		munmap(m_map, m_size);
+	}
+	
+	m_map = 0;
+	m_size = 0;
+	m_records = 0;
+	m_count = 0;
+}
+
+} // namespace engine
@@ -0,0 +1,138 @@
+#ifndef ENGINE_HANDLOG_H
+#define ENGINE_HANDLOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "hand.h"
+#include "round.h"
+#include "rules.h"
+
+namespace engine {
+
+/**
+ * Struct that holds the header of a hand history file.
+ * The header describes the session the rounds were played in, so that 
+ * they can be replayed from the seed.
+ */
+struct HandLogHeader
+{
+	char magic[4];                /**< always "BJHL". */
+	uint16_t version;             /**< file format version. */
+	uint16_t recordSize;          /**< sizeof(HandRecord). */
+	uint64_t seed;                /**< seed of the shoe's random number generator. */
+	uint32_t stream;              /**< jumps applied to the generator after seeding. */
+	uint16_t numDecks;            /**< decks in the shoe. */
+	uint16_t variant;             /**< rules played, an engine::VariantId. */
+	double penetration;           /**< fraction of the shoe dealt before the cut card. */
+};
+
+/**
+ * Struct that holds one round of a hand history file.
+ * Records have a fixed width, so the n-th round is at a known offset. 
+ * Cards are stored as engine::Card ids; the player's hands follow each 
+ * other in playerCards, first hand first.
+ */
+struct HandRecord
+{
+	int64_t balance;                        /**< balance after settling. */
+	uint32_t shoeId;                        /**< shuffles of the shoe once the round was dealt. */
+	uint32_t round;                         /**< round number in the session. */
+	int32_t bet;                            /**< amount wagered. */
+	uint8_t outcome;                        /**< an engine::Outcome. */
+	uint8_t numPlayerCards;                 /**< cards in playerCards, over all hands. */
+	uint8_t numDealerCards;                 /**< cards in dealerCards, the draw sequence. */
+	uint8_t numActions;                     /**< actions in actions. */
+	uint8_t playerCards[Hand::MaxCards];    /**< player's cards. */
+	uint8_t dealerCards[Hand::MaxCards];    /**< dealer's cards. */
+	uint8_t actions[Round::MaxActions];     /**< player's actions, each an engine::Action. */
+	uint8_t reserved[7];                    /**< always 0. */
+	
+	void set(uint32_t shoeId, uint32_t round, int bet, int64_t balance, Outcome outcome, 
+	         const Round &played);
+};
+
+/**
+ * Class that appends rounds to a hand history file.
+ * Writes go through a large stdio buffer, so appending a record is 
+ * usually a memcpy.
+ */
+class HandLogWriter
+{
+public:
+	static const uint16_t Version = 1; /**< file format version. */
+	
+	HandLogWriter();
+	~HandLogWriter();
+	
+	bool open(const char *path, uint64_t seed, uint32_t stream, int numDecks, 
+	          double penetration, int variant = 0);
+	bool append(const HandRecord &record);
+	void flush();
+	void close();
+	
+	/**
+	 * Member function that checks whether a file is open.
+	 * @return true: records are being written; false: no file is open
+	 */
+	bool isOpen() const {return m_file != 0;}
+	
+private:
+	HandLogWriter(const HandLogWriter &);
+	HandLogWriter &operator=(const HandLogWriter &);
+	
+private:
+	FILE *m_file;
+	char *m_buffer;
+};
+
+/**
+ * Class that reads a hand history file through a memory map.
+ * Records are returned as pointers into the map; nothing is copied.
+ */
+class HandLogReader
+{
+public:
+	HandLogReader();
+	~HandLogReader();
+	
+	bool open(const char *path);
+	void close();
+	
+	/**
+	 * Member function that returns the file header.
+	 * The file must be open.
+	 * @return The header
+	 */
+	const HandLogHeader &header() const {return *static_cast<const HandLogHeader *>(m_map);}
+	
+	/**
+	 * Member function that returns the number of records.
+	 * @return Number of complete records in the file
+	 */
+	size_t count() const {return m_count;}
+	
+	/**
+	 * Member function that returns one record.
+	 * @param i Index of the record, less than count()
+	 * @return The record
+	 */
+	const HandRecord &record(size_t i) const {return m_records[i];}
+	
+	const HandRecord *begin() const {return m_records;}
+	const HandRecord *end() const {return m_records + m_count;}
+	
+private:
+	HandLogReader(const HandLogReader &);
+	HandLogReader &operator=(const HandLogReader &);
+	
+private:
+	void *m_map;
+	size_t m_size;
+	const HandRecord *m_records;
+	size_t m_count;
+};
+
+} // namespace engine
+
+#endif
@@ -0,0 +1,248 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include "journal.h"
+
+namespace engine {
+
+static_assert(sizeof(JournalRecord) == 24, "JournalRecord must have a fixed layout");
+
+/**
+ * Helper function that returns the checksum of a record.
+ * @param record The record
+ * @return FNV-1a of every byte before the checksum
+ */
+static uint32_t checksum(const JournalRecord &record)
+{
+	const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&record);
+	uint32_t hash = 2166136261u;
+	for(size_t i = 0; i < offsetof(JournalRecord, checksum); ++i)
+	{
+		hash = (hash ^ bytes[i]) * 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * Helper function that commits the entry of a new file to its directory.
+ * Without it a power cut can lose the file along with every record in it.
+ * @param path Path of the file
+ * @return false: the directory cannot be synced
+ */
+static bool syncDirectory(const char *path)
+{
+	const char *slash = strrchr(path, '/');
+	std::string dir = slash == 0 ? std::string(".") : std::string(path, slash == path ? 1 : slash - path);
+	
+	int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if(fd < 0)
+	{
+		return false;
+	}
+	
+	// Some file systems cannot sync a directory and need not
+	bool synced = fsync(fd) == 0 || errno == EINVAL;
+	::close(fd);
+	return synced;
+}
+
+/**
+ * The Journal class constructor.
+ * No file is open.
+ */
+Journal::Journal() : m_fd(-1), m_sequence(0), m_pending(0), m_syncEvents(DefaultSyncEvents),
+m_syncInterval(std::chrono::milliseconds(DefaultSyncMs)), m_failed(false)
+{}
+
+/**
+ * The Journal class destructor.
+ * Waiting events are committed.
+ */
+Journal::~Journal()
+{
+	close();
+}
+
+/**
+ * Member function that starts a new journal.
+ * Whatever the file held is thrown away, so it must have been recovered
+ * first.
+ * @param path Path of the file
+ * @param syncEvents Commit once this many events wait, at least 1
+ * @param syncMs Commit once an event has waited this many milliseconds
+ * @return true: the file is open; false: it cannot be written
+ */
+bool Journal::open(const char *path, int syncEvents, int syncMs)
+{
+	close();
+	
+	m_fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+	m_sequence = 0;
+	m_pending = 0;
+	m_syncEvents = syncEvents < 1 ? 1 : syncEvents;
+	m_syncInterval = std::chrono::milliseconds(syncMs < 0 ? 0 : syncMs);
+	m_failed = false;
+	
+	if(m_fd >= 0 && !syncDirectory(path))
+	{
+		::close(m_fd);
+		m_fd = -1;
+	}
+	return m_fd >= 0;
+}
+
+/**
+ * Member function that appends an event.
+ * The record is written at once and committed with the next group, which
+ * the caller makes once the group is full or commitDue() says so. A
+ * record the file cannot take fails the journal.
+ * @param event What happened
+ * @param betting Whether the table is between rounds afterwards
+ * @param amount Chips placed, or what the round paid
+ * @param balance Money not on the table afterwards
+ * @param bet Bet on the table afterwards
+ * @return true: syncEvents are waiting and should be committed now
+ */
+bool Journal::append(JournalEvent event, bool betting, int amount, int balance, int bet)
+{
+	if(m_fd < 0)
+	{
+		return false;
+	}
+	
+	JournalRecord record;
+	memset(&record, 0, sizeof(record));
+	record.sequence = m_sequence++;
+	record.event = static_cast<uint8_t>(event);
+	record.betting = betting ? 1 : 0;
+	record.amount = amount;
+	record.balance = balance;
+	record.bet = bet;
+	record.checksum = checksum(record);
+	
+	const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&record);
+	size_t written = 0;
+	while(written < sizeof(record))
+	{
+		ssize_t n = ::write(m_fd, bytes + written, sizeof(record) - written);
+		if(n < 0 && errno == EINTR) continue;
+		if(n <= 0)
+		{
+			fail();
+			return false;
+		}
+		written += n;
+	}
+	
+	if(m_pending++ == 0)
+	{
+		m_deadline = Clock::now() + m_syncInterval;
+	}
+	return m_pending >= m_syncEvents;
+}
+
+/**
+ * Member function that commits the waiting events if they are due.
+ * @param now The time
+ * @return true: a commit was made
+ */
+bool Journal::commitDue(Clock::time_point now)
+{
+	if(m_pending == 0 || now < m_deadline)
+	{
+		return false;
+	}
+	commit();
+	return true;
+}
+
+/**
+ * Member function that commits the waiting events to disk.
+ */
+void Journal::commit()
+{
+	if(m_fd >= 0 && m_pending > 0 && fdatasync(m_fd) != 0)
+	{
+		fail();
+	}
+	m_pending = 0;
+}
+
+/**
+ * Member function that gives up on a journal that cannot be written.
+ * Whatever was written last is left as it is; recover() stops at the 
+ * last whole record.
+ */
+void Journal::fail()
+{
+	::close(m_fd);
+	m_fd = -1;
+	m_pending = 0;
+	m_failed = true;
+}
+
+/**
+ * Member function that commits the waiting events and closes the file.
+ */
+void Journal::close()
+{
+	if(m_fd >= 0)
+	{
+		commit();
+		::close(m_fd);
+		m_fd = -1;
+	}
+}
+
+/**
+ * Function that reads back the last event of a journal.
+ * Records are read in order up to the first one that is cut short, out of
+ * sequence or fails its checksum; what follows it was never committed.
+ * @param path Path of the file
+ * @param last Where to store the last whole record
+ * @return true: a record was found; false: the journal is missing or empty
+ */
+bool Journal::recover(const char *path, JournalRecord &last)
+{
+	int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+	if(fd < 0)
+	{
+		return false;
+	}
+	
+	JournalRecord records[256];
+	uint32_t sequence = 0;
+	bool found = false;
+	bool valid = true;
+	
+	while(valid)
+	{
+		ssize_t n = ::read(fd, records, sizeof(records));
+		if(n < 0 && errno == EINTR) continue;
+		if(n <= 0) break;
+		
+		// A short read is only the end of the file if the next read is empty,
+		// so whole records are taken and the rest is read again
+		size_t count = n / sizeof(JournalRecord);
+		if(count == 0) break;
+		lseek(fd, static_cast<off_t>(count * sizeof(JournalRecord)) - n, SEEK_CUR);
+		
+		for(size_t i = 0; i < count && valid; ++i)
+		{
+			valid = records[i].sequence == sequence && records[i].checksum == checksum(records[i]);
+			if(valid)
+			{
+				last = records[i];
+				found = true;
+				++sequence;
+			}
+		}
+	}
+	
+	::close(fd);
+	return found;
+}
+
+} // namespace engine
@@ -0,0 +1,113 @@
+#ifndef ENGINE_JOURNAL_H
+#define ENGINE_JOURNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <chrono>
+
+namespace engine {
+
+/**
+ * enum type representing what happened to the player's money.
+ */
+enum JournalEvent {
+	                  JournalBet = 1,     /**< enum value JournalBet - chips placed, or the bet taken back. */
+	                  JournalDeal = 2,    /**< enum value JournalDeal - a round was dealt for the bet. */
+	                  JournalSettle = 3,  /**< enum value JournalSettle - a round was paid out. */
+	                  JournalAdvance = 4, /**< enum value JournalAdvance - a broke player was given money. */
+	                  JournalNewGame = 5, /**< enum value JournalNewGame - the game was started over. */
+	                  JournalJoin = 6     /**< enum value JournalJoin - the player moved to another table. */
+	              };
+
+/**
+ * Struct that holds one event of a session journal.
+ * A record holds the money as the event left it rather than a change, so
+ * replaying a record twice does no harm. The checksum tells a record cut
+ * short by a crash from a whole one.
+ */
+struct JournalRecord
+{
+	uint32_t sequence;            /**< events before this one in the journal. */
+	uint8_t event;                /**< an engine::JournalEvent. */
+	uint8_t betting;              /**< 1 if the table is between rounds afterwards. */
+	uint16_t reserved;            /**< always 0. */
+	int32_t amount;               /**< chips placed, or what the round paid. */
+	int32_t balance;              /**< money not on the table afterwards. */
+	int32_t bet;                  /**< bet on the table afterwards. */
+	uint32_t checksum;            /**< FNV-1a of the bytes before it. */
+	
+	/**
+	 * Member function that returns the money the player would walk away with.
+	 * A bet still on the table between rounds is taken back; a round
+	 * being played is lost, as when the game is quit in the middle of it.
+	 * @return The balance
+	 */
+	int recoveredBalance() const {return balance + (betting ? bet : 0);}
+};
+
+/**
+ * Class that appends the events of a session to a journal file.
+ * Every record is handed to the operating system as it is appended, so it
+ * survives the game crashing; making records survive a power cut costs an
+ * fsync, so they are committed in groups, once syncEvents are waiting or
+ * the oldest of them has waited syncMs, whichever comes first. The owner
+ * makes the commits: append() only says when a group is full, so the
+ * fsync can wait until the reply is on its way. A journal that cannot be
+ * written stops taking events.
+ */
+class Journal
+{
+public:
+	typedef std::chrono::steady_clock Clock;
+	
+	static const int DefaultSyncEvents = 16;  /**< events committed together at most. */
+	static const int DefaultSyncMs = 250;     /**< milliseconds an event waits to be committed at most. */
+	
+	Journal();
+	~Journal();
+	
+	bool open(const char *path, int syncEvents = DefaultSyncEvents, int syncMs = DefaultSyncMs);
+	bool append(JournalEvent event, bool betting, int amount, int balance, int bet);
+	bool commitDue(Clock::time_point now);
+	void commit();
+	void close();
+	
+	/**
+	 * Member function that checks whether a file is open.
+	 * @return true: events are being written; false: no file is open
+	 */
+	bool isOpen() const {return m_fd >= 0;}
+	
+	/**
+	 * Member function that checks whether a write or a commit failed.
+	 * @return true: events since then are lost and the file is closed
+	 */
+	bool failed() const {return m_failed;}
+	
+	/**
+	 * Member function that returns when the waiting events are due.
+	 * @return Time of the next commit, Clock::time_point::max() if nothing waits
+	 */
+	Clock::time_point deadline() const {return m_pending > 0 ? m_deadline : Clock::time_point::max();}
+	
+	static bool recover(const char *path, JournalRecord &last);
+
+private:
+	Journal(const Journal &);
+	Journal &operator=(const Journal &);
+	
+	void fail();
+
+private:
+	int m_fd;
+	uint32_t m_sequence;
+	int m_pending;
+	int m_syncEvents;
+	Clock::duration m_syncInterval;
+	Clock::time_point m_deadline;
+	bool m_failed;
+};
+
+} // namespace engine
+
+#endif
@@ -0,0 +1,405 @@
+#include "playerodds.h"
+
+namespace engine {
+
+/**
+ * Member function that returns the best of the evaluated actions.
+ * @return The action with the highest EV, Stand if nothing was evaluated
+ */
+Action ActionEv::best() const
+{
+	const double evs[] = {stand, hit, doubleDown, split, surrender};
+	Action action = Stand;
+	bool found = false;
+	
+	for(int a = Stand; a <= Surrender; ++a)
+	{
+		if((evaluated & (1 << a)) != 0 && (!found || evs[a] > evs[action]))
+		{
+			action = static_cast<Action>(a);
+			found = true;
+		}
+	}
+	return action;
+}
+
+/**
+ * The PlayerOdds class constructor.
+ * @param dealer Dealer odds calculator whose cache is shared by all 
+ * evaluations
+ * @param variant Rules the hands are played under, a VariantId
+ */
+PlayerOdds::PlayerOdds(DealerOdds &dealer, int variant) : m_dealer(dealer), m_rules(0), m_upcard(0), 
+m_fixed(false)
+{
+	setVariant(variant);
+}
+
+/**
+ * Member function that sets the rules the hands are played under.
+ * The dealer odds calculator is set to the same rules.
+ * @param variant A VariantId; anything else is HouseRules
+ */
+void PlayerOdds::setVariant(int variant)
+{
+	m_rules = &Variants[variant >= 0 && variant < NumVariants ? variant : HouseVariant];
+	m_dealer.setHitSoft17(m_rules->hitSoft17);
+}
+
+/**
+ * Member function that evaluates standing and hitting for a hand.
+ * @param player The player's hand
+ * @param upcard The dealer's face-up card
+ * @param shoe Cards left in the shoe, player's cards and upcard removed
+ * @return EV of standing and of hitting
+ */
+ActionEv PlayerOdds::evaluate(const Hand &player, Card upcard, const Composition &shoe)
+{
+	return evaluate(player.hardTotal(), player.numAces(), player.numCards(), 
+	                Composition::indexOf(upcard), shoe);
+}
+
+/**
+ * Member function that evaluates standing and hitting for a hand.
+ * Hitting a hand of 21 or more is never considered; its hit EV is 
+ * reported as that of a bust.
+ * @param hardTotal Player's total with Aces counted as 1
+ * @param numAces Number of Aces in the player's hand
+ * @param numCards Number of cards in the player's hand
+ * @param upcard Value index of the dealer's face-up card, 0 (Ace) to 9
+ * @param shoe Cards left in the shoe, player's cards and upcard removed
+ * @return EV of standing and of hitting
+ */
+ActionEv PlayerOdds::evaluate(int hardTotal, int numAces, int numCards, int upcard, 
+                              const Composition &shoe)
+{
+	m_upcard = upcard;
+	return play(hardTotal, numAces, numCards, false, (1 << Stand) | (1 << Hit), shoe);
+}
+
+/**
+ * Member function that estimates every allowed action for a hand.
+ * The player's draws are walked over the exact shoe composition, but 
+ * every final hand is settled against the dealer distribution of the 
+ * shoe as it is now, so only one distribution is worked out.
+ * @param player The player's hand
+ * @param upcard The dealer's face-up card
+ * @param shoe Cards left in the shoe, player's cards and upcard removed
+ * @param allowed Bit 1 << a for each engine::Action a the table allows
+ * @param split The hand comes from a split, so 21 is not a Blackjack
+ * @return EV of each allowed action
+ */
+ActionEv PlayerOdds::estimate(const Hand &player, Card upcard, const Composition &shoe, 
+                              int allowed, bool split)
+{
+	m_upcard = Composition::indexOf(upcard);
+	m_fixedDealer = m_dealer.distribution(m_upcard, shoe);
+	m_fixed = true;
+	
+	ActionEv ev = play(player.hardTotal(), player.numAces(), player.numCards(), split, allowed, shoe);
+	ev.evaluated &= allowed;
+	m_fixed = false;
+	return ev;
+}
+
+/**
+ * Helper function that works out the actions of a hand.
+ * Final hands are weighed by the odds that the dealer has no Blackjack 
+ * given the cards drawn to them, and the sum is divided by the odds of 
+ * that for the shoe as it is, which conditions every EV on the dealer's 
+ * check without changing the odds of the player's draws.
+ * @param hardTotal Player's total with Aces counted as 1
+ * @param numAces Number of Aces in the player's hand
+ * @param numCards Number of cards in the player's hand
+ * @param split The hand comes from a split
+ * @param allowed Bit 1 << a for each engine::Action a to work out besides 
+ * standing and hitting
+ * @param shoe Cards left in the shoe, player's cards and upcard removed
+ * @return EV of standing, of hitting and of each allowed action
+ */
+ActionEv PlayerOdds::play(int hardTotal, int numAces, int numCards, bool split, int allowed, 
+                          const Composition &shoe)
+{
+	int score = hardTotal + ((numAces != 0 && hardTotal <= 11) ? 10 : 0);
+	Composition remaining = shoe;
+	ActionEv ev = {0.0, 0.0, 0.0, 0.0, 0.0, (1 << Stand) | (1 << Hit)};
+	
+	const DealerDistribution &d = dealer(remaining);
+	double noBlackjack = 1.0 - d.p[DealerDistribution::Blackjack];
+	if(noBlackjack <= 0.0)
+	{
+		return ev;
+	}
+	
+	// The memo is keyed by composition alone, which is only unique for 
+	// hands grown from the same starting shoe
+	m_memo.clear();
+	
+	if(score > 21)
+	{
+		ev.stand = ev.hit = bustEv(remaining) / noBlackjack;
+		return ev;
+	}
+	
+	ev.stand = standEv(score, numCards == 2 && score == 21 && !split, remaining) / noBlackjack;
+	ev.hit = (score < 21 ? hitEv(hardTotal, numAces, remaining) : bustEv(remaining)) / noBlackjack;
+	
+	if(allowed & (1 << DoubleDown))
+	{
+		ev.doubleDown = doubleEv(hardTotal, numAces, remaining) / noBlackjack;
+		ev.evaluated |= 1 << DoubleDown;
+	}
+	if(allowed & (1 << Surrender))
+	{
+		ev.surrender = -0.5;
+		ev.evaluated |= 1 << Surrender;
+	}
+	if((allowed & (1 << Split)) && numCards == 2)
+	{
+		// A pair is two Aces or two cards of half the total
+		m_memo.clear();
+		ev.split = splitEv(numAces == 2 ? 0 : hardTotal / 2 - 1, remaining) / noBlackjack;
+		ev.evaluated |= 1 << Split;
+	}
+	
+	return ev;
+}
+
+/**
+ * Helper function that returns the dealer's distribution for a shoe.
+ * @param shoe Cards left in the shoe
+ * @return The current shoe's distribution while estimating, else the 
+ * shoe's own
+ */
+const DealerDistribution &PlayerOdds::dealer(const Composition &shoe)
+{
+	return m_fixed ? m_fixedDealer : m_dealer.distribution(m_upcard, shoe);
+}
+
+/**
+ * Helper function that settles a standing hand.
+ * A dealer Blackjack is left out, so the EV is weighed by the odds that 
+ * the dealer has none.
+ * @param score Player's score, 21 or less
+ * @param blackjack Whether the player has a Blackjack
+ * @param shoe Cards left in the shoe
+ * @return EV of standing
+ */
+double PlayerOdds::standEv(int score, bool blackjack, const Composition &shoe)
+{
+	const DealerDistribution &d = dealer(shoe);
+	
+	if(blackjack)
+	{
+		double payout = static_cast<double>(m_rules->blackjackNum) / m_rules->blackjackDen;
+		return payout * (1.0 - d.p[DealerDistribution::Blackjack]);
+	}
+	
+	double ev = d.p[DealerDistribution::Bust];
+	
+	for(int f = DealerDistribution::Seventeen; f <= DealerDistribution::TwentyOne; ++f)
+	{
+		int dealerScore = DealerStandsOn + f;
+		if(score > dealerScore)
+		{
+			ev += d.p[f];
+		}
+		else if(score < dealerScore)
+		{
+			ev -= d.p[f];
+		}
+	}
+	
+	return ev;
+}
+
+/**
+ * Helper function that settles a busted hand.
+ * The dealer still plays; where the rules let busted hands push, the hand 
+ * is a push if he busts as well. A dealer Blackjack is left out.
+ * @param shoe Cards left in the shoe
+ * @return EV of the busted hand
+ */
+double PlayerOdds::bustEv(const Composition &shoe)
+{
+	const DealerDistribution &d = dealer(shoe);
+	double ev = 0.0;
+	
+	for(int f = DealerDistribution::Seventeen; f <= DealerDistribution::TwentyOne; ++f)
+	{
+		ev -= d.p[f];
+	}
+	if(!m_rules->bustPush)
+	{
+		ev -= d.p[DealerDistribution::Bust];
+	}
+	return ev;
+}
+
+/**
+ * Helper function that averages a double over every card drawn.
+ * @param hardTotal Player's total with Aces counted as 1
+ * @param numAces Number of Aces in the player's hand
+ * @param shoe Cards left in the shoe, restored before returning
+ * @return EV of doubling, both bets counted
+ */
+double PlayerOdds::doubleEv(int hardTotal, int numAces, Composition &shoe)
+{
+	int total = shoe.total();
+	double ev = 0.0;
+	
+	if(total == 0)
+	{
+		return 2.0 * bustEv(shoe);
+	}
+	
+	for(int i = 0; i < Composition::NumValues; ++i)
+	{
+		int count = shoe.count(i);
+		if(count == 0)
+		{
+			continue;
+		}
+		
+		shoe.remove(i);
+		int drawn = hardTotal + i + 1;
+		int score = drawn + ((numAces != 0 || i == 0) && drawn <= 11 ? 10 : 0);
+		ev += (score > 21 ? bustEv(shoe) : standEv(score, false, shoe)) * count / total;
+		shoe.add(i);
+	}
+	
+	return 2.0 * ev;
+}
+
+/**
+ * Helper function that averages a split over every second card drawn.
+ * Each hand gets the pair's card and a card of the shoe, and is played 
+ * on optimally, with a double where the rules allow it after a split; 
+ * split Aces stand on their second card. The two hands are taken to draw 
+ * from the same shoe and resplits are not followed, so this is close to 
+ * the exact value rather than equal to it.
+ * @param value Value index of the pair's cards, 0 (Ace) to 9
+ * @param shoe Cards left in the shoe, restored before returning
+ * @return EV of splitting, both hands counted
+ */
+double PlayerOdds::splitEv(int value, Composition &shoe)
+{
+	int total = shoe.total();
+	double ev = 0.0;
+	
+	if(total == 0)
+	{
+		return 2.0 * bustEv(shoe);
+	}
+	
+	for(int i = 0; i < Composition::NumValues; ++i)
+	{
+		int count = shoe.count(i);
+		if(count == 0)
+		{
+			continue;
+		}
+		
+		shoe.remove(i);
+		int hardTotal = value + i + 2;
+		int numAces = (value == 0) + (i == 0);
+		int score = hardTotal + (numAces != 0 && hardTotal <= 11 ? 10 : 0);
+		double hand = standEv(score, false, shoe);
+		
+		if(value != 0 && score < 21)
+		{
+			double hit = hitEv(hardTotal, numAces, shoe);
+			if(hit > hand)
+			{
+				hand = hit;
+			}
+		}
+		if(value != 0 && m_rules->doubleAfterSplit)
+		{
+			double doubled = doubleEv(hardTotal, numAces, shoe);
+			if(doubled > hand)
+			{
+				hand = doubled;
+			}
+		}
+		
+		ev += hand * count / total;
+		shoe.add(i);
+	}
+	
+	return 2.0 * ev;
+}
+
+/**
+ * Helper function that averages the best EV over every card drawn.
+ * @param hardTotal Player's total with Aces counted as 1
+ * @param numAces Number of Aces in the player's hand
+ * @param shoe Cards left in the shoe, restored before returning
+ * @return EV of hitting once and playing on optimally
+ */
+double PlayerOdds::hitEv(int hardTotal, int numAces, Composition &shoe)
+{
+	int total = shoe.total();
+	double ev = 0.0;
+	
+	if(total == 0)
+	{
+		return bustEv(shoe);
+	}
+	
+	for(int i = 0; i < Composition::NumValues; ++i)
+	{
+		int count = shoe.count(i);
+		if(count == 0)
+		{
+			continue;
+		}
+		
+		shoe.remove(i);
+		ev += bestEv(hardTotal + i + 1, numAces + (i == 0 ? 1 : 0), shoe) * count / total;
+		shoe.add(i);
+	}
+	
+	return ev;
+}
+
+/**
+ * Helper function that returns the EV of the better action.
+ * Results are memoized by composition, which determines the player's 
+ * hand within one evaluation.
+ * @param hardTotal Player's total with Aces counted as 1
+ * @param numAces Number of Aces in the player's hand
+ * @param shoe Cards left in the shoe, restored before returning
+ * @return Best EV of the hand, which has at least 3 cards
+ */
+double PlayerOdds::bestEv(int hardTotal, int numAces, Composition &shoe)
+{
+	if(hardTotal > 21)
+	{
+		return bustEv(shoe);
+	}
+	
+	uint64_t key = shoe.key();
+	std::unordered_map<uint64_t, double>::iterator it = m_memo.find(key);
+	if(it != m_memo.end())
+	{
+		return it->second;
+	}
+	
+	int score = hardTotal + ((numAces != 0 && hardTotal <= 11) ? 10 : 0);
+	double ev = standEv(score, false, shoe);
+	
+	if(score < 21)
+	{
+		double hit = hitEv(hardTotal, numAces, shoe);
+		if(hit > ev)
+		{
+			ev = hit;
+		}
+	}
+	
+	m_memo[key] = ev;
+	return ev;
+}
+
+} // namespace engine
@@ -0,0 +1,86 @@
+#ifndef ENGINE_PLAYERODDS_H
+#define ENGINE_PLAYERODDS_H
+
+#include <stdint.h>
+#include <unordered_map>
+#include "composition.h"
+#include "dealerodds.h"
+#include "hand.h"
+#include "ruleset.h"
+
+namespace engine {
+
+/**
+ * Struct that holds the expected value of each player action.
+ * Values are in units of the bet, once the dealer has checked for 
+ * Blackjack. Only the actions in evaluated were worked out.
+ */
+struct ActionEv
+{
+	double stand;       /**< EV of standing now. */
+	double hit;         /**< EV of hitting now and playing on optimally. */
+	double doubleDown;  /**< EV of doubling, both bets counted. */
+	double split;       /**< EV of splitting, both hands counted. */
+	double surrender;   /**< EV of giving up half the bet. */
+	uint8_t evaluated;  /**< bit 1 << a for each engine::Action a worked out. */
+	
+	/**
+	 * Member function that checks which action is better.
+	 * @return true: hitting is better; false: standing is at least as good
+	 */
+	bool shouldHit() const {return hit > stand;}
+	
+	Action best() const;
+};
+
+/**
+ * Class that calculates the exact expected value of the player's actions.
+ * The player's future draws are walked over the exact shoe composition 
+ * and every final hand is settled against the dealer distribution for 
+ * the cards left at that point, as the variant's RuleSet settles it. The 
+ * dealer has always checked a ten or an Ace for Blackjack before a play 
+ * counts, so every EV is for a dealer without one. An instance is not 
+ * thread-safe; give each thread its own.
+ *
+ * Working out the dealer for every shoe the player's draws can leave is 
+ * what makes an exact evaluation slow, up to half a second from a cold 
+ * cache. estimate() settles every final hand against the dealer of the 
+ * current shoe instead, which keeps the player's draws exact and finishes 
+ * in about a third of a millisecond, a couple at worst with a split.
+ */
+class PlayerOdds
+{
+public:
+	explicit PlayerOdds(DealerOdds &dealer, int variant = HouseVariant);
+	
+	void setVariant(int variant);
+	
+	ActionEv evaluate(const Hand &player, Card upcard, const Composition &shoe);
+	ActionEv evaluate(int hardTotal, int numAces, int numCards, int upcard, 
+	                  const Composition &shoe);
+	ActionEv estimate(const Hand &player, Card upcard, const Composition &shoe, 
+	                  int allowed, bool split = false);
+	
+private:
+	ActionEv play(int hardTotal, int numAces, int numCards, bool split, int allowed, 
+	              const Composition &shoe);
+	const DealerDistribution &dealer(const Composition &shoe);
+	double standEv(int score, bool blackjack, const Composition &shoe);
+	double bustEv(const Composition &shoe);
+	double doubleEv(int hardTotal, int numAces, Composition &shoe);
+	double splitEv(int value, Composition &shoe);
+	double hitEv(int hardTotal, int numAces, Composition &shoe);
+	double bestEv(int hardTotal, int numAces, Composition &shoe);
+	
+private:
+	DealerOdds &m_dealer;
+	const Variant *m_rules;
+	int m_upcard;
+	bool m_fixed;
+	DealerDistribution m_fixedDealer;
+	std::unordered_map<uint64_t, double> m_memo;
+};
+
+} // namespace engine
+
+#endif
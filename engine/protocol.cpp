@@ -0,0 +1,255 @@
+#include "protocol.h"
+
+namespace engine {
+
+/**
+ * Helper function that writes a little endian 32-bit integer.
+ * @param out Where to write 4 bytes
+ * @param value The integer
+ * @return Pointer past the bytes written
+ */
+static uint8_t *put32(uint8_t *out, uint32_t value)
+{
+	out[0] = static_cast<uint8_t>(value);
+	out[1] = static_cast<uint8_t>(value >> 8);
+	out[2] = static_cast<uint8_t>(value >> 16);
+	out[3] = static_cast<uint8_t>(value >> 24);
+	return out + 4;
+}
+
+/**
+ * Helper function that reads a little endian 32-bit integer.
+ * @param in 4 bytes
+ * @return The integer
+ */
+static uint32_t get32(const uint8_t *in)
+{
+	return static_cast<uint32_t>(in[0]) | static_cast<uint32_t>(in[1]) << 8 |
+	       static_cast<uint32_t>(in[2]) << 16 | static_cast<uint32_t>(in[3]) << 24;
+}
+
+/**
+ * Helper function that writes the cards of a hand.
+ * @param out Where to write the count and the ids
+ * @param hand The hand
+ * @param hidden Index of a card to send as TableState::HiddenCard, -1 for none
+ * @return Pointer past the bytes written
+ */
+static uint8_t *putHand(uint8_t *out, const Hand &hand, int hidden = -1)
+{
+	*out++ = static_cast<uint8_t>(hand.numCards());
+	for(int i = 0; i < hand.numCards(); ++i)
+	{
+		*out++ = i == hidden ? TableState::HiddenCard : static_cast<uint8_t>(hand.card(i).id());
+	}
+	return out;
+}
+
+/**
+ * Helper function that reads the cards of a hand.
+ * Face down cards are left out of the hand.
+ * @param in Position of the count, moved past the cards
+ * @param end End of the message
+ * @param hand Where to store the cards
+ * @param hidden Set when a card was face down
+ * @return true: read; false: the message is cut short or a card is invalid
+ */
+static bool getHand(const uint8_t *&in, const uint8_t *end, Hand &hand, bool &hidden)
+{
+	hand.clear();
+	hidden = false;
+	if(in >= end || *in > Hand::MaxCards || end - in < 1 + *in) return false;
+	
+	int numCards = *in++;
+	for(int i = 0; i < numCards; ++i, ++in)
+	{
+		if(*in == TableState::HiddenCard)
+		{
+			hidden = true;
+		}
+		else if(*in < Card::NumCards)
+		{
+			hand << Card(*in);
+		}
+		else
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Member function that writes the request to the wire.
+ * @param out Where to write Size bytes
+ */
+void Request::encode(uint8_t *out) const
+{
+	out[0] = command;
+	out[1] = out[2] = out[3] = 0;
+	put32(out + 4, static_cast<uint32_t>(argument));
+}
+
+/**
+ * Member function that reads a request from the wire.
+ * @param in Size bytes
+ */
+void Request::decode(const uint8_t *in)
+{
+	command = in[0];
+	argument = static_cast<int32_t>(get32(in + 4));
+}
+
+/**
+ * Member function that takes the state of a table.
+ * The dealer's hole card is kept even while it is face down; encode()
+ * hides it.
+ * @param table The table
+ * @param status Whether the request was carried out
+ */
+void TableState::set(const Table &table, ReplyStatus status)
+{
+	const Round &round = table.round();
+	bool betting = table.isBetting();
+	
+	this->status = static_cast<uint8_t>(status);
+	flags = static_cast<uint8_t>((betting ? Betting : 0) | (table.canDeal() ? CanDeal : 0));
+	allowed = 0;
+	if(!betting)
+	{
+		allowed = static_cast<uint8_t>(1 << Stand | table.canHit() << Hit |
+		                               table.canDouble() << DoubleDown | table.canSplit() << Split |
+		                               table.canSurrender() << Surrender | table.canInsure() << Insure);
+	}
+	variant = static_cast<uint8_t>(table.variant());
+	balance = table.balance();
+	bet = table.currentBet();
+	extraWager = table.extraWager();
+	lastNet = table.lastNet();
+	rounds = table.rounds();
+	advances = static_cast<uint32_t>(table.advances());
+	holeHidden = !betting;
+	
+	// Nothing is dealt before the first round
+	if(!table.hasCards())
+	{
+		dealer.clear();
+		numHands = 0;
+		current = 0;
+		return;
+	}
+	
+	dealer = round.dealer();
+	numHands = static_cast<uint8_t>(round.numHands());
+	current = static_cast<uint8_t>(round.current());
+	for(int i = 0; i < numHands; ++i)
+	{
+		hands[i] = round.player(i);
+		handFlags[i] = static_cast<uint8_t>((round.isDoubled(i) ? Doubled : 0) |
+		                                    (round.isSurrendered(i) ? Surrendered : 0));
+		outcomes[i] = static_cast<uint8_t>(betting ? round.outcome(i) : Push);
+	}
+}
+
+/**
+ * Member function that writes the state to the wire.
+ * @param out Where to write, at least MaxSize bytes
+ * @return Bytes written, length included
+ */
+size_t TableState::encode(uint8_t *out) const
+{
+	uint8_t *p = out + 2;
+	*p++ = status;
+	*p++ = flags;
+	*p++ = allowed;
+	*p++ = variant;
+	p = put32(p, static_cast<uint32_t>(balance));
+	p = put32(p, static_cast<uint32_t>(bet));
+	p = put32(p, static_cast<uint32_t>(extraWager));
+	p = put32(p, static_cast<uint32_t>(lastNet));
+	p = put32(p, rounds);
+	p = put32(p, advances);
+	
+	p = putHand(p, dealer, holeHidden ? 1 : -1);
+	*p++ = numHands;
+	*p++ = current;
+	for(int i = 0; i < numHands; ++i)
+	{
+		*p++ = static_cast<uint8_t>(handFlags[i] | outcomes[i] << 2);
+		p = putHand(p, hands[i]);
+	}
+	
+	size_t size = p - out;
+	out[0] = static_cast<uint8_t>(size - 2);
+	out[1] = static_cast<uint8_t>((size - 2) >> 8);
+	return size;
+}
+
+/**
+ * Member function that reads the state of a table from the wire.
+ * @param in The message, after its length
+ * @param size Length of the message
+ * @return true: read; false: the message is malformed
+ */
+bool TableState::decode(const uint8_t *in, size_t size)
+{
+	const uint8_t *end = in + size;
+	if(size < 31) return false;
+	
+	status = in[0];
+	flags = in[1];
+	allowed = in[2];
+	variant = in[3];
+	balance = static_cast<int32_t>(get32(in + 4));
+	bet = static_cast<int32_t>(get32(in + 8));
+	extraWager = static_cast<int32_t>(get32(in + 12));
+	lastNet = static_cast<int32_t>(get32(in + 16));
+	rounds = get32(in + 20);
+	advances = get32(in + 24);
+	in += 28;
+	
+	if(!getHand(in, end, dealer, holeHidden) || end - in < 2) return false;
+	numHands = *in++;
+	current = *in++;
+	if(numHands > Round::MaxHands) return false;
+	
+	for(int i = 0; i < numHands; ++i)
+	{
+		bool hidden;
+		if(in >= end) return false;
+		handFlags[i] = *in & 3;
+		outcomes[i] = *in >> 2;
+		++in;
+		if(!getHand(in, end, hands[i], hidden)) return false;
+	}
+	return in == end;
+}
+
+/**
+ * Function that carries out a request at a table.
+ * CommandJoin is up to whoever hosts the table, as it replaces the table.
+ * @param table The table
+ * @param request The request
+ * @return Whether it was carried out
+ */
+ReplyStatus execute(Table &table, const Request &request)
+{
+	bool done;
+	switch(request.command)
+	{
+	case CommandBet:       done = table.bet(request.argument); break;
+	case CommandDeal:      done = table.deal(); break;
+	case CommandHit:       done = table.hit(); break;
+	case CommandStand:     done = table.stand(); break;
+	case CommandDouble:    done = table.doubleDown(); break;
+	case CommandSplit:     done = table.split(); break;
+	case CommandSurrender: done = table.surrender(); break;
+	case CommandInsure:    done = table.insure(); break;
+	case CommandNewGame:   table.newGame(); done = true; break;
+	case CommandState:     done = true; break;
+	default:               return ReplyBadCommand;
+	}
+	return done ? ReplyOk : ReplyRefused;
+}
+
+} // namespace engine
@@ -0,0 +1,126 @@
+#ifndef ENGINE_PROTOCOL_H
+#define ENGINE_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "hand.h"
+#include "round.h"
+#include "table.h"
+
+namespace engine {
+
+static const int DefaultPort = 7021; /**< TCP port of the table server. */
+
+/**
+ * enum type representing a command sent to a table server.
+ */
+enum Command {
+	              CommandJoin = 1,      /**< enum value CommandJoin - move to a new table between rounds, argument the VariantId. */
+	              CommandBet = 2,       /**< enum value CommandBet - add chips to the bet, argument the amount, 0 clears. */
+	              CommandDeal = 3,      /**< enum value CommandDeal - deal a round. */
+	              CommandHit = 4,       /**< enum value CommandHit - one more card. */
+	              CommandStand = 5,     /**< enum value CommandStand - finish the current hand. */
+	              CommandDouble = 6,    /**< enum value CommandDouble - double down. */
+	              CommandSplit = 7,     /**< enum value CommandSplit - split the pair. */
+	              CommandSurrender = 8, /**< enum value CommandSurrender - give up half the bet. */
+	              CommandInsure = 9,    /**< enum value CommandInsure - take insurance. */
+	              CommandState = 10,    /**< enum value CommandState - only send the table state. */
+	              CommandNewGame = 11   /**< enum value CommandNewGame - start over with Table::StartBalance. */
+	          };
+
+/**
+ * enum type representing whether a command was carried out.
+ */
+enum ReplyStatus {
+	                  ReplyOk = 0,        /**< enum value ReplyOk - done. */
+	                  ReplyRefused = 1,   /**< enum value ReplyRefused - not allowed at this point of the game. */
+	                  ReplyBadCommand = 2 /**< enum value ReplyBadCommand - unknown command. */
+	              };
+
+/**
+ * Struct that holds one command sent to a table server.
+ * On the wire a request is Size bytes: the command, three zero
+ * bytes and the argument as a little endian 32-bit integer.
+ */
+struct Request
+{
+	static const size_t Size = 8; /**< bytes of a request on the wire. */
+	
+	uint8_t command;              /**< an engine::Command. */
+	int32_t argument;             /**< bet amount or VariantId, else 0. */
+	
+	void encode(uint8_t *out) const;
+	void decode(const uint8_t *in);
+};
+
+/**
+ * Struct that holds the state of a table as sent back for every request.
+ * On the wire a state is a little endian 16-bit length followed by that
+ * many bytes: status, flags, allowed actions, variant, balance, bet,
+ * extra wager, last net, rounds and advances, then the dealer's cards
+ * and each of the player's hands as a count followed by Card ids. While
+ * a round is being played the dealer's hole card is sent as HiddenCard,
+ * and a state read from the wire leaves it out of dealer.
+ */
+struct TableState
+{
+	static const size_t MaxSize = 160;       /**< most bytes of a state on the wire, length included. */
+	static const uint8_t HiddenCard = 0xff;  /**< id of a face down card. */
+	
+	/**
+	 * enum type representing the bits of flags.
+	 */
+	enum Flags {
+		           Betting = 1, /**< enum value Betting - between rounds. */
+		           CanDeal = 2  /**< enum value CanDeal - a bet is placed. */
+		       };
+	
+	/**
+	 * enum type representing the bits of handFlags.
+	 */
+	enum HandFlags {
+		               Doubled = 1,    /**< enum value Doubled - the hand was doubled. */
+		               Surrendered = 2 /**< enum value Surrendered - the hand was given up. */
+		           };
+	
+	uint8_t status;                       /**< an engine::ReplyStatus. */
+	uint8_t flags;                        /**< Flags bits. */
+	uint8_t allowed;                      /**< bit 1 << a for each engine::Action a allowed. */
+	uint8_t variant;                      /**< rules played, an engine::VariantId. */
+	int32_t balance;                      /**< money not on the table. */
+	int32_t bet;                          /**< bet on each hand. */
+	int32_t extraWager;                   /**< doubles, splits and insurance of the round. */
+	int32_t lastNet;                      /**< what the last round paid. */
+	uint32_t rounds;                      /**< rounds settled at the table. */
+	uint32_t advances;                    /**< times the player went broke and was given money. */
+	Hand dealer;                          /**< dealer's cards. */
+	bool holeHidden;                      /**< the dealer's second card is face down. */
+	uint8_t numHands;                     /**< player's hands, 0 before the first round. */
+	uint8_t current;                      /**< hand being played. */
+	Hand hands[Round::MaxHands];          /**< player's hands. */
+	uint8_t handFlags[Round::MaxHands];   /**< HandFlags bits of each hand. */
+	uint8_t outcomes[Round::MaxHands];    /**< engine::Outcome of each hand, between rounds. */
+	
+	/**
+	 * Member function that checks whether an action is allowed.
+	 * @param action An engine::Action
+	 * @return true: the table accepts it
+	 */
+	bool isAllowed(Action action) const {return (allowed & (1 << action)) != 0;}
+	
+	/**
+	 * Member function that checks whether the table is between rounds.
+	 * @return true: bets are taken
+	 */
+	bool isBetting() const {return (flags & Betting) != 0;}
+	
+	void set(const Table &table, ReplyStatus status);
+	size_t encode(uint8_t *out) const;
+	bool decode(const uint8_t *in, size_t size);
+};
+
+ReplyStatus execute(Table &table, const Request &request);
+
+} // namespace engine
+
+#endif
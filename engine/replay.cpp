@@ -0,0 +1,165 @@
+#include "replay.h"
+
+namespace engine {
+
+/**
+ * The Replay class constructor.
+ * The shoe is seeded and shuffled as the session's shoe was before its
+ * first round: the generator is seeded, jumped once per stream and used
+ * to shuffle the shoe once.
+ * @param log Open hand history, which must outlive the replay
+ * @param interval Rounds between checkpoints, at least 1
+ */
+Replay::Replay(const HandLogReader &log, size_t interval) :
+	m_log(log),
+	m_interval(interval < 1 ? 1 : interval),
+	m_shoe(log.header().numDecks, log.header().penetration),
+	m_rng(log.header().seed),
+	m_round(m_shoe, m_rng),
+	m_stand(0),
+	m_outcome(Push),
+	m_position(0)
+{
+	for(uint32_t i = 0; i < log.header().stream; ++i)
+	{
+		m_rng.jump();
+	}
+	m_shoe.shuffle(m_rng);
+	
+	int variant = log.header().variant;
+	m_stand = Variants[variant < NumVariants ? variant : 0].stand;
+	
+	Checkpoint start = {m_shoe, m_rng};
+	m_checkpoints.push_back(start);
+}
+
+/**
+ * Member function that replays the next round.
+ * A shoeId ahead of the shoe means the table reshuffled between rounds
+ * (a new game), so the shoe is shuffled to catch up before dealing. The
+ * player's recorded actions are then taken in order and the dealer plays
+ * as usual.
+ * @return true: the round matches its record; false: it differs, or there are no rounds left
+ */
+bool Replay::step()
+{
+	if(m_position >= m_log.count())
+	{
+		return false;
+	}
+	
+	if(m_position % m_interval == 0 && m_position / m_interval == m_checkpoints.size())
+	{
+		Checkpoint checkpoint = {m_shoe, m_rng};
+		m_checkpoints.push_back(checkpoint);
+	}
+	
+	const HandRecord &record = m_log.record(m_position++);
+	
+	while(m_shoe.shuffleCount() + (m_shoe.needsShuffle() ? 1 : 0) < record.shoeId)
+	{
+		m_shoe.shuffle(m_rng);
+	}
+	
+	m_round.deal();
+	uint32_t shoeId = m_shoe.shuffleCount();
+	for(int i = 0; i < record.numActions && !m_round.done(); ++i)
+	{
+		switch(record.actions[i])
+		{
+		case Hit:        m_round.hit(); break;
+		case DoubleDown: m_round.doubleDown(); break;
+		case Split:      m_round.split(); break;
+		case Surrender:  m_round.surrender(); break;
+		case Insure:     m_round.insure(); break;
+		default:         m_round.next(); break;
+		}
+	}
+	m_outcome = m_stand(m_round);
+	
+	return matches(record, shoeId);
+}
+
+/**
+ * Member function that moves the replay in front of a round.
+ * The nearest checkpoint at or before the round is restored and at most
+ * interval rounds are replayed from there. Checkpoints not yet taken
+ * are filled in on the way, so the first seek past them replays from the
+ * last one taken.
+ * @param index Index of the round step() should replay next
+ * @return true: the replay is in front of the round; false: index is past the end
+ */
+bool Replay::seek(size_t index)
+{
+	if(index > m_log.count())
+	{
+		return false;
+	}
+	
+	size_t checkpoint = index / m_interval;
+	if(checkpoint >= m_checkpoints.size())
+	{
+		checkpoint = m_checkpoints.size() - 1;
+	}
+	
+	// Restore the checkpoint unless we are already between it and the round
+	if(index < m_position || m_position < checkpoint * m_interval)
+	{
+		m_shoe = m_checkpoints[checkpoint].shoe;
+		m_rng = m_checkpoints[checkpoint].rng;
+		m_position = checkpoint * m_interval;
+	}
+	
+	while(m_position < index)
+	{
+		step();
+	}
+	
+	return true;
+}
+
+/**
+ * Helper function that compares the last replayed round with its record.
+ * @param record The record of the round
+ * @param shoeId Shuffles of the shoe once the round was dealt
+ * @return true: same shoe, cards and outcome
+ */
+bool Replay::matches(const HandRecord &record, uint32_t shoeId) const
+{
+	const Hand &dealer = m_round.dealer();
+	
+	if(record.shoeId != shoeId ||
+	   record.outcome != m_outcome ||
+	   record.numDealerCards != dealer.numCards())
+	{
+		return false;
+	}
+	
+	int n = 0;
+	for(int h = 0; h < m_round.numHands(); ++h)
+	{
+		const Hand &player = m_round.player(h);
+		for(int i = 0; i < player.numCards() && n < Hand::MaxCards; ++i, ++n)
+		{
+			if(n >= record.numPlayerCards || record.playerCards[n] != player.card(i).id())
+			{
+				return false;
+			}
+		}
+	}
+	if(n != record.numPlayerCards)
+	{
+		return false;
+	}
+	for(int i = 0; i < dealer.numCards(); ++i)
+	{
+		if(record.dealerCards[i] != dealer.card(i).id())
+		{
+			return false;
+		}
+	}
+	
+	return true;
+}
+
+} // namespace engine
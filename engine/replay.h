@@ -0,0 +1,99 @@
+#ifndef ENGINE_REPLAY_H
+#define ENGINE_REPLAY_H
+
+#include <stddef.h>
+#include <vector>
+#include "handlog.h"
+#include "rng.h"
+#include "round.h"
+#include "shoe.h"
+
+namespace engine {
+
+/**
+ * Class that re-plays a hand history bit for bit.
+ * The shoe is rebuilt from the seed in the file header and every round
+ * is played again through Round with the recorded actions, under the 
+ * RuleSet of the recorded variant, so the cards come out exactly as they 
+ * did at the table. Each replayed round is
+ * checked against its record.
+ *
+ * The state of the shoe and its random number generator is saved every
+ * interval rounds, so seek() never replays more than interval rounds.
+ */
+class Replay
+{
+public:
+	static const size_t DefaultInterval = 4096; /**< rounds between checkpoints. */
+	
+	explicit Replay(const HandLogReader &log, size_t interval = DefaultInterval);
+	
+	bool step();
+	bool seek(size_t index);
+	
+	/**
+	 * Member function that returns the number of rounds in the history.
+	 * @return Number of records
+	 */
+	size_t count() const {return m_log.count();}
+	
+	/**
+	 * Member function that returns the index of the next round to replay.
+	 * @return Index of the next record
+	 */
+	size_t position() const {return m_position;}
+	
+	/**
+	 * Member function that returns the last replayed round.
+	 * @return The round, with all the player's hands
+	 */
+	const Round &round() const {return m_round;}
+	
+	/**
+	 * Member function that returns the player's first hand of the last replayed round.
+	 * @return The player's hand
+	 */
+	const Hand &player() const {return m_round.player();}
+	
+	/**
+	 * Member function that returns the dealer's hand of the last replayed round.
+	 * @return The dealer's hand
+	 */
+	const Hand &dealer() const {return m_round.dealer();}
+	
+	/**
+	 * Member function that returns the outcome of the last replayed round.
+	 * @return Outcome of the round
+	 */
+	Outcome outcome() const {return m_outcome;}
+
+private:
+	Replay(const Replay &);
+	Replay &operator=(const Replay &);
+	
+	bool matches(const HandRecord &record, uint32_t shoeId) const;
+
+private:
+	/**
+	 * Struct that holds the state of the table before a round.
+	 */
+	struct Checkpoint
+	{
+		Shoe shoe;
+		Rng rng;
+	};
+	
+	const HandLogReader &m_log;
+	size_t m_interval;
+	Shoe m_shoe;
+	Rng m_rng;
+	Round m_round;
+	Outcome (*m_stand)(Round &round);
+	Outcome m_outcome;
+	size_t m_position;
+	std::vector<Checkpoint> m_checkpoints;
+};
+
+} // namespace engine
+
+#endif
@@ -0,0 +1,40 @@
+#include "rng.h"
+
+namespace engine {
+
+/**
+ * Member function that advances the generator by 2^128 steps.
+ * Calling jump() once per worker on copies of one seeded generator 
+ * gives 2^128 non-overlapping streams.
+ */
+void Xoshiro256::jump()
+{
+	static const uint64_t JumpPoly[] = {
+		0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+		0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+	};
+	
+	uint64_t s[4] = {0, 0, 0, 0};
+	
+	for(int i = 0; i < 4; ++i)
+	{
+		for(int b = 0; b < 64; ++b)
+		{
+			if(JumpPoly[i] & (static_cast<uint64_t>(1) << b))
+			{
+				for(int k = 0; k < 4; ++k)
+				{
+					s[k] ^= m_s[k];
+				}
+			}
+			(*this)();
+		}
+	}
+	
+	for(int k = 0; k < 4; ++k)
+	{
+		m_s[k] = s[k];
+	}
+}
+
+} // namespace engine
@@ -0,0 +1,145 @@
+#ifndef ENGINE_RNG_H
+#define ENGINE_RNG_H
+
+#include <stdint.h>
+
+namespace engine {
+
+/**
+ * SplitMix64 random number generator.
+ * Only used to expand a 64 bit seed into the state of Xoshiro256.
+ */
+class SplitMix64
+{
+public:
+	explicit SplitMix64(uint64_t seed) : m_state(seed) {}
+	
+	/**
+	 * Member function that returns the next random number.
+	 * @return 64 random bits
+	 */
+	uint64_t operator()()
+	{
+		uint64_t z = (m_state += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		return z ^ (z >> 31);
+	}
+	
+private:
+	uint64_t m_state;
+};
+
+/**
+ * xoshiro256** random number generator by Blackman and Vigna.
+ * 32 bytes of state, a period of 2^256 - 1 and a jump() that advances 
+ * the generator by 2^128 steps, so that streams handed out to parallel 
+ * workers never overlap. Satisfies the standard UniformRandomBitGenerator 
+ * requirements.
+ */
+class Xoshiro256
+{
+public:
+	typedef uint64_t result_type;
+	
+	explicit Xoshiro256(uint64_t seed = 0) {this->seed(seed);}
+	
+	/**
+	 * Member function that reseeds the generator.
+	 * @param seed Any 64 bit value, including 0
+	 */
+	void seed(uint64_t seed)
+	{
+		SplitMix64 sm(seed);
+		for(int i = 0; i < 4; ++i)
+		{
+			m_s[i] = sm();
+		}
+	}
+	
+	/**
+	 * Member function that returns the next random number.
+	 * @return 64 random bits
+	 */
+	uint64_t operator()()
+	{
+		uint64_t result = rotl(m_s[1] * 5, 7) * 9;
+		uint64_t t = m_s[1] << 17;
+		
+		m_s[2] ^= m_s[0];
+		m_s[3] ^= m_s[1];
+		m_s[1] ^= m_s[2];
+		m_s[0] ^= m_s[3];
+		m_s[2] ^= t;
+		m_s[3] = rotl(m_s[3], 45);
+		
+		return result;
+	}
+	
+	void jump();
+	
+	static uint64_t min() {return 0;}
+	static uint64_t max() {return ~static_cast<uint64_t>(0);}
+	
+private:
+	static uint64_t rotl(uint64_t x, int k) {return (x << k) | (x >> (64 - k));}
+	
+private:
+	uint64_t m_s[4];
+};
+
+/**
+ * Random number generator used by the engine to shuffle shoes.
+ */
+typedef Xoshiro256 Rng;
+
+/**
+ * Function that draws an unbiased random number in [0, n).
+ * Uses Lemire's multiply-and-reject method on the high 32 bits of the 
+ * generator output, so there is no modulo bias and almost never a 
+ * division.
+ * @param rng Generator returning 64 random bits
+ * @param n Upper bound, must be greater than 0
+ * @return Uniformly distributed number in [0, n)
+ */
+template<class Generator>
+inline uint32_t uniformBelow(Generator &rng, uint32_t n)
+{
+	uint64_t m = static_cast<uint64_t>(static_cast<uint32_t>(rng() >> 32)) * n;
+	uint32_t low = static_cast<uint32_t>(m);
+	
+	if(low < n)
+	{
+		uint32_t threshold = (0u - n) % n;
+		while(low < threshold)
+		{
+			m = static_cast<uint64_t>(static_cast<uint32_t>(rng() >> 32)) * n;
+			low = static_cast<uint32_t>(m);
+		}
+	}
+	
+	return static_cast<uint32_t>(m >> 32);
+}
+
+/**
+ * Function that shuffles an array in place.
+ * An exact Fisher-Yates shuffle - every permutation is equally likely.
+ * @param items The array to shuffle
+ * @param count Number of items in the array
+ * @param rng Generator returning 64 random bits
+ */
+template<class T, class Generator>
+void fisherYates(T *items, int count, Generator &rng)
+{
+	for(int i = count - 1; i > 0; --i)
+	{
+		int j = static_cast<int>(uniformBelow(rng, static_cast<uint32_t>(i + 1)));
+		T tmp = items[i];
+		items[i] = items[j];
+		items[j] = tmp;
+	}
+}
+
+} // namespace engine
+
+#endif
@@ -0,0 +1,215 @@
+#include "round.h"
+
+namespace engine {
+
+/**
+ * The Round class constructor.
+ * @param shoe Shoe to deal from, shared by all rounds of a table
+ * @param rng Random number generator used to reshuffle the shoe
+ */
+Round::Round(Shoe &shoe, Rng &rng) : 
+m_shoe(shoe), m_rng(rng), m_numHands(1), m_current(0), m_insured(false), m_numActions(0)
+{
+	m_flags[0] = 0;
+	m_outcomes[0] = Push;
+}
+
+/**
+ * Member function that deals a new round.
+ * The player is back to one hand and the shoe is reshuffled first if the 
+ * cut card has come out, as Blackjack::deal() does.
+ */
+void Round::deal()
+{
+	m_dealer.clear();
+	m_hands[0].clear();
+	m_flags[0] = 0;
+	m_numHands = 1;
+	m_current = 0;
+	m_insured = false;
+	m_numActions = 0;
+	
+	if(m_shoe.needsShuffle())
+	{
+		m_shoe.shuffle(m_rng);
+	}
+	
+	m_dealer << draw() << draw();
+	m_hands[0] << draw() << draw();
+}
+
+/**
+ * Member function that deals one more card to the current hand.
+ */
+void Round::hit()
+{
+	m_hands[m_current] << draw();
+	record(Hit);
+}
+
+/**
+ * Member function that ends the current hand and moves to the next one.
+ */
+void Round::next()
+{
+	record(Stand);
+	advance();
+}
+
+/**
+ * Member function that doubles the wager on the current hand.
+ * The hand gets exactly one more card and is finished.
+ * @see canDouble()
+ */
+void Round::doubleDown()
+{
+	m_flags[m_current] |= Doubled;
+	m_hands[m_current] << draw();
+	record(DoubleDown);
+	advance();
+}
+
+/**
+ * Member function that splits the current hand into two.
+ * The second card starts a new hand at the end, which gets its second 
+ * card once it is played; the current hand gets its second card now. 
+ * Split Aces get one card each.
+ * @see canSplit()
+ */
+void Round::split()
+{
+	Hand &hand = m_hands[m_current];
+	Card first = hand.card(0);
+	Card second = hand.card(1);
+	uint8_t flags = first.isAce() ? SplitAces : 0;
+	
+	m_hands[m_numHands].clear();
+	m_hands[m_numHands] << second;
+	m_flags[m_numHands] = flags;
+	++m_numHands;
+	
+	hand.clear();
+	hand << first << draw();
+	m_flags[m_current] = flags;
+	record(Split);
+}
+
+/**
+ * Member function that gives up the hand for half the wager.
+ * This ends the player's turn.
+ * @see canSurrender()
+ */
+void Round::surrender()
+{
+	m_flags[m_current] |= Surrendered;
+	record(Surrender);
+	advance();
+}
+
+/**
+ * Member function that places an insurance bet of half the wager.
+ * @see canInsure()
+ */
+void Round::insure()
+{
+	m_insured = true;
+	record(Insure);
+}
+
+/**
+ * Member function that checks whether the current hand may double.
+ * Any two cards may be doubled, except split Aces.
+ * @param doubleAfterSplit Split hands may be doubled
+ * @return true: doubleDown() is allowed
+ */
+bool Round::canDouble(bool doubleAfterSplit) const
+{
+	return !done() && m_hands[m_current].numCards() == 2 &&
+	       (m_flags[m_current] & SplitAces) == 0 && 
+	       (m_numHands == 1 || doubleAfterSplit);
+}
+
+/**
+ * Member function that checks whether the current hand may split.
+ * Two cards of the same value, e.g. a Jack and a King, may be split until 
+ * there are MaxHands hands.
+ * @param resplitAces Split Aces may be split again
+ * @return true: split() is allowed
+ */
+bool Round::canSplit(bool resplitAces) const
+{
+	if(done() || m_numHands >= MaxHands)
+	{
+		return false;
+	}
+	
+	const Hand &hand = m_hands[m_current];
+	return hand.numCards() == 2 && hand.card(0).points() == hand.card(1).points() &&
+	       ((m_flags[m_current] & SplitAces) == 0 || resplitAces);
+}
+
+/**
+ * Member function that checks whether the player may surrender.
+ * Only the first two cards may be surrendered, before any other action 
+ * than insurance. The dealer must have checked for Blackjack already.
+ * @param lateSurrender The variant allows late surrender
+ * @return true: surrender() is allowed
+ */
+bool Round::canSurrender(bool lateSurrender) const
+{
+	return lateSurrender && m_numHands == 1 && m_current == 0 &&
+	       m_hands[0].numCards() == 2 && m_flags[0] == 0;
+}
+
+/**
+ * Member function that checks whether the player may take insurance.
+ * Insurance is offered on the first two cards when the dealer shows an 
+ * Ace; with a Blackjack it is even money.
+ * @return true: insure() is allowed
+ */
+bool Round::canInsure() const
+{
+	return upcard().isAce() && !m_insured && m_numActions == 0;
+}
+
+/**
+ * Helper function that draws one card.
+ * The shoe is reshuffled if it runs out in the middle of a round.
+ * @return The card drawn
+ */
+Card Round::draw()
+{
+	if(m_shoe.cardsLeft() == 0)
+	{
+		m_shoe.shuffle(m_rng);
+	}
+	return m_shoe.deal();
+}
+
+/**
+ * Helper function that moves on to the next hand.
+ * A hand from a split gets its second card when it comes up.
+ */
+void Round::advance()
+{
+	if(++m_current < m_numHands && m_hands[m_current].numCards() == 1)
+	{
+		m_hands[m_current] << draw();
+	}
+}
+
+/**
+ * Helper function that records an action.
+ * MaxActions covers every round that can be played; the check only 
+ * keeps a broken caller from writing past the array.
+ * @param action The action taken
+ */
+void Round::record(Action action)
+{
+	if(m_numActions < MaxActions)
+	{
+		m_actions[m_numActions++] = static_cast<uint8_t>(action);
+	}
+}
+
+} // namespace engine
@@ -0,0 +1,266 @@
+#ifndef ENGINE_ROUND_H
+#define ENGINE_ROUND_H
+
+#include <stdint.h>
+#include "hand.h"
+#include "rng.h"
+#include "rules.h"
+#include "ruleset.h"
+#include "shoe.h"
+
+namespace engine {
+
+/**
+ * Class that plays rounds of Blackjack without any UI.
+ * It follows the same sequence as the Blackjack window: deal() gives two
+ * cards to the dealer then two to the player, the player acts on one hand
+ * at a time and stand() lets the dealer play and resolves every hand.
+ * The rules come in as a RuleSet on the member templates, so one shoe can
+ * be played under any variant without run time rule checks.
+ *
+ * Splitting gives the player up to MaxHands hands, held in a fixed array
+ * together with their wagers, so a round never allocates. Every action is
+ * recorded in the order it was taken, which is all a replay needs.
+ */
+class Round
+{
+public:
+	static const int MaxHands = 4;                /**< hands a player can split into. */
+	/** Actions a round can take: the hits, the split and the stand or double of each hand, and insurance. */
+	static const int MaxActions = MaxHands * (Hand::MaxCards + 1) + 1;
+	
+	Round(Shoe &shoe, Rng &rng);
+	
+	void deal();
+	void hit();
+	void next();
+	void doubleDown();
+	void split();
+	void surrender();
+	void insure();
+	
+	/**
+	 * Member function that checks whether the current hand may take a card.
+	 * Doubled hands, split Aces and hands of 21 or more are finished.
+	 * @return true: hit() is allowed
+	 */
+	bool canHit() const
+	{
+		return !done() && m_hands[m_current].score() < 21 &&
+		       (m_flags[m_current] & (Doubled | SplitAces)) == 0;
+	}
+	
+	bool canDouble(bool doubleAfterSplit) const;
+	bool canSplit(bool resplitAces) const;
+	bool canSurrender(bool lateSurrender) const;
+	bool canInsure() const;
+	
+	/**
+	 * Member function that checks doubling under a variant's rules.
+	 * @tparam Rules RuleSet of the variant played
+	 * @return true: doubleDown() is allowed
+	 */
+	template<class Rules>
+	bool canDouble() const {return canDouble(Rules::DoubleAfterSplit);}
+	
+	/**
+	 * Member function that checks splitting under a variant's rules.
+	 * @tparam Rules RuleSet of the variant played
+	 * @return true: split() is allowed
+	 */
+	template<class Rules>
+	bool canSplit() const {return canSplit(Rules::ResplitAces);}
+	
+	/**
+	 * Member function that checks surrendering under a variant's rules.
+	 * @tparam Rules RuleSet of the variant played
+	 * @return true: surrender() is allowed
+	 */
+	template<class Rules>
+	bool canSurrender() const {return canSurrender(Rules::LateSurrender);}
+	
+	/**
+	 * Member function that lets the dealer play and resolves the round.
+	 * Every hand still being played stands. The dealer plays even if the
+	 * player has busted, as in Blackjack::dealerPlays().
+	 * @tparam Rules RuleSet of the variant played
+	 * @return Outcome of the first hand
+	 */
+	template<class Rules = HouseRules>
+	Outcome stand()
+	{
+		while(!done())
+		{
+			next();
+		}
+		
+		while(Rules::dealerMustHit(m_dealer))
+		{
+			m_dealer << draw();
+		}
+		
+		bool split = m_numHands > 1;
+		for(int i = 0; i < m_numHands; ++i)
+		{
+			m_outcomes[i] = (m_flags[i] & Surrendered) ? DealerWins :
+			                Rules::resolve(m_hands[i], m_dealer, split);
+		}
+		
+		return m_outcomes[0];
+	}
+	
+	/**
+	 * Member function that returns what the round paid, after stand().
+	 * This resolves every wager of the round: each hand's, doubled if it
+	 * was, the half a surrender loses, and the insurance bet of half the
+	 * bet, which pays 2:1. A Blackjack only pays its bonus if the hand was
+	 * never split. Halves of an odd bet round in the house's favour.
+	 * @tparam Rules RuleSet of the variant played
+	 * @param bet Bet on each hand
+	 * @return Amount won by the player, negative if lost
+	 */
+	template<class Rules = HouseRules>
+	int net(int bet) const
+	{
+		int total = 0;
+		
+		if(m_insured)
+		{
+			total += m_dealer.isBlackjack() ? 2 * (bet / 2) : -(bet / 2);
+		}
+		
+		for(int i = 0; i < m_numHands; ++i)
+		{
+			int wager = (m_flags[i] & Doubled) ? 2 * bet : bet;
+			
+			if(m_flags[i] & Surrendered)
+			{
+				total -= bet - bet / 2;
+			}
+			else if(m_outcomes[i] == PlayerWins)
+			{
+				total += Rules::win(wager, m_numHands == 1 && m_hands[i].isBlackjack());
+			}
+			else if(m_outcomes[i] == DealerWins)
+			{
+				total -= wager;
+			}
+		}
+		
+		return total;
+	}
+	
+	/**
+	 * Member function that returns the player's first hand.
+	 * @return The player's hand
+	 */
+	const Hand &player() const {return m_hands[0];}
+	
+	/**
+	 * Member function that returns one of the player's hands.
+	 * @param i Index of the hand, less than numHands()
+	 * @return The player's hand
+	 */
+	const Hand &player(int i) const {return m_hands[i];}
+	
+	/**
+	 * Member function that returns the dealer's hand.
+	 * @return The dealer's hand
+	 */
+	const Hand &dealer() const {return m_dealer;}
+	
+	/**
+	 * Member function that returns the dealer's face up card.
+	 * @return The first card dealt to the dealer
+	 */
+	Card upcard() const {return m_dealer.card(0);}
+	
+	/**
+	 * Member function that returns the number of player hands.
+	 * @return 1, or more after splitting
+	 */
+	int numHands() const {return m_numHands;}
+	
+	/**
+	 * Member function that returns the hand being played.
+	 * @return Index of the current hand, numHands() once all are finished
+	 */
+	int current() const {return m_current;}
+	
+	/**
+	 * Member function that checks whether the player has finished.
+	 * @return true: every hand has been played
+	 */
+	bool done() const {return m_current >= m_numHands;}
+	
+	/**
+	 * Member function that checks whether a hand was doubled.
+	 * @param i Index of the hand
+	 * @return true: the hand's wager is doubled
+	 */
+	bool isDoubled(int i) const {return (m_flags[i] & Doubled) != 0;}
+	
+	/**
+	 * Member function that checks whether a hand was surrendered.
+	 * @param i Index of the hand
+	 * @return true: the hand was given up for half its wager
+	 */
+	bool isSurrendered(int i) const {return (m_flags[i] & Surrendered) != 0;}
+	
+	/**
+	 * Member function that checks whether the player took insurance.
+	 * @return true: an insurance bet of half the wager is on the table
+	 */
+	bool isInsured() const {return m_insured;}
+	
+	/**
+	 * Member function that returns the outcome of a hand, after stand().
+	 * @param i Index of the hand
+	 * @return Outcome of the hand
+	 */
+	Outcome outcome(int i) const {return m_outcomes[i];}
+	
+	/**
+	 * Member function that returns the number of actions taken.
+	 * @return Number of recorded actions, at most MaxActions
+	 */
+	int numActions() const {return m_numActions;}
+	
+	/**
+	 * Member function that returns one recorded action.
+	 * @param i Index of the action, less than numActions()
+	 * @return The action, an engine::Action
+	 */
+	Action action(int i) const {return static_cast<Action>(m_actions[i]);}
+
+private:
+	/**
+	 * enum type representing the state of a player hand.
+	 */
+	enum Flags {
+		           Doubled = 1,     /**< enum value Doubled. */
+		           SplitAces = 2,   /**< enum value SplitAces - one card only. */
+		           Surrendered = 4  /**< enum value Surrendered. */
+		       };
+	
+	Card draw();
+	void advance();
+	void record(Action action);
+
+private:
+	Shoe &m_shoe;
+	Rng &m_rng;
+	Hand m_dealer;
+	Hand m_hands[MaxHands];
+	uint8_t m_flags[MaxHands];
+	Outcome m_outcomes[MaxHands];
+	int m_numHands;
+	int m_current;
+	bool m_insured;
+	uint8_t m_actions[MaxActions];
+	int m_numActions;
+};
+
+} // namespace engine
+
+#endif
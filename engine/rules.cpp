@@ -0,0 +1,97 @@
+#include "rules.h"
+
+namespace engine {
+
+/**
+ * Function that determines who wins a round.
+ * Must be called after the dealer has finished his play. A busted player 
+ * only pushes if the dealer busts as well; a Blackjack beats any other 21 
+ * and is paid even money. Two cards to 21 after a split are not a 
+ * Blackjack.
+ * @param player The player's hand
+ * @param dealer The dealer's hand
+ * @param split The player's hand comes from a split
+ * @return Outcome of the round
+ */
+Outcome resolve(const Hand &player, const Hand &dealer, bool split)
+{
+	int playerScore = player.score();
+	int dealerScore = dealer.score();
+	bool dealerBusted = dealerScore > 21;
+	bool dealerBlackjack = dealer.isBlackjack();
+	
+	if(playerScore > 21)
+	{
+		return dealerBusted ? Push : DealerWins;
+	}
+	if(player.isBlackjack() && !split)
+	{
+		return dealerBlackjack ? Push : PlayerWins;
+	}
+	if(dealerBusted)
+	{
+		return PlayerWins;
+	}
+	if(dealerBlackjack)
+	{
+		return DealerWins;
+	}
+	if(playerScore > dealerScore)
+	{
+		return PlayerWins;
+	}
+	if(playerScore < dealerScore)
+	{
+		return DealerWins;
+	}
+	return Push;
+}
+
+/**
+ * Function that updates bet and balance according to the outcome.
+ * The bet has already been taken from the balance and stays on the table 
+ * for the next round. A win pays into the balance. A loss takes 
+ * the bet again from the balance for the next round; if the balance is 
+ * short the bet shrinks to what is left, and it drops to 0 once the 
+ * balance is empty.
+ * @param outcome Outcome of the round
+ * @param win What the bet pays if the player wins, e.g. RuleSet::win()
+ * @param bet Bet on the table, updated in place
+ * @param balance Player's balance, updated in place
+ */
+void settle(Outcome outcome, int win, int &bet, int &balance)
+{
+	if(outcome == PlayerWins)
+	{
+		settleNet(win, bet, balance);
+	}
+	else if(outcome == DealerWins)
+	{
+		settleNet(-bet, bet, balance);
+	}
+}
+
+/**
+ * Function that updates bet and balance by the net result of a round.
+ * This is settle() for rounds with more than one wager: doubles, splits, 
+ * surrender and insurance all end up in one net amount. A loss the 
+ * balance cannot cover comes out of the bet on the table.
+ * @param net Amount won by the player, negative if lost
+ * @param bet Bet on the table, updated in place
+ * @param balance Player's balance, updated in place
+ */
+void settleNet(int net, int &bet, int &balance)
+{
+	balance += net;
+	if(balance < 0)
+	{
+		bet += balance;
+		balance = 0;
+		if(bet < 0)
+		{
+			bet = 0;
+		}
+	}
+}
+
+} // namespace engine
@@ -0,0 +1,58 @@
+#ifndef ENGINE_RULES_H
+#define ENGINE_RULES_H
+
+#include "hand.h"
+
+namespace engine {
+
+/**
+ * enum type representing the result of a round.
+ */
+enum Outcome {
+	             PlayerWins = 0, /**< enum value PlayerWins. */
+	             DealerWins = 1, /**< enum value DealerWins. */
+	             Push = 2        /**< enum value Push - nobody wins. */
+	         };
+
+/**
+ * enum type representing a player action.
+ */
+enum Action {
+	            Stand = 0,      /**< enum value Stand - end the current hand. */
+	            Hit = 1,        /**< enum value Hit - one more card. */
+	            DoubleDown = 2, /**< enum value DoubleDown - double the wager, one card, end the hand. */
+	            Split = 3,      /**< enum value Split - split a pair into two hands. */
+	            Surrender = 4,  /**< enum value Surrender - give up half the wager. */
+	            Insure = 5      /**< enum value Insure - side bet against a dealer Blackjack. */
+	        };
+
+static const int DealerStandsOn = 17; /**< dealer stands on all 17s. */
+
+/**
+ * Function that checks whether the dealer has to take another card.
+ * @param dealer The dealer's hand
+ * @return true: dealer must hit; false: dealer must stand
+ */
+inline bool dealerMustHit(const Hand &dealer)
+{
+	return dealer.score() < DealerStandsOn;
+}
+
+Outcome resolve(const Hand &player, const Hand &dealer, bool split = false);
+void settle(Outcome outcome, int win, int &bet, int &balance);
+void settleNet(int net, int &bet, int &balance);
+
+/**
+ * Function that updates bet and balance for a win paying even money.
+ * @param outcome Outcome of the round
+ * @param bet Bet on the table, updated in place
+ * @param balance Player's balance, updated in place
+ */
+inline void settle(Outcome outcome, int &bet, int &balance)
+{
+	settle(outcome, bet, bet, balance);
+}
+
+} // namespace engine
+
+#endif
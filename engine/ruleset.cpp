@@ -0,0 +1,74 @@
+#include <string.h>
+#include "round.h"
+#include "ruleset.h"
+
+namespace engine {
+
+/**
+ * Helper function that plays out a round under one variant's rules.
+ * @param round The round
+ * @return Outcome of the first hand
+ */
+template<class Rules>
+static Outcome standAs(Round &round)
+{
+	return round.stand<Rules>();
+}
+
+/**
+ * Helper function that returns what a round paid under one variant's rules.
+ * @param round The round, after it was played out
+ * @param bet Bet on each hand
+ * @return Amount won by the player, negative if lost
+ */
+template<class Rules>
+static int netAs(const Round &round, int bet)
+{
+	return round.net<Rules>(bet);
+}
+
+/**
+ * Helper function that describes a RuleSet at run time.
+ * @param name Short name of the variant
+ * @param description One line summary of the rules
+ * @return The description, pointing at Round instantiated for the RuleSet
+ */
+template<class Rules>
+static Variant describe(const char *name, const char *description)
+{
+	Variant variant = {name, description, Rules::NumDecks, Rules::HitSoft17, 
+	                   Rules::BlackjackNum, Rules::BlackjackDen, Rules::LateSurrender, 
+	                   Rules::DoubleAfterSplit, Rules::ResplitAces, Rules::BustPush, 
+	                   &standAs<Rules>, &netAs<Rules>};
+	return variant;
+}
+
+/**
+ * The pre-instantiated variants, indexed by VariantId.
+ */
+const Variant Variants[NumVariants] = {
+	describe<HouseRules>("house", "Dealer stands on all 17s"),
+	describe<StripRules>("strip", "4 decks, dealer stands on all 17s, Blackjack pays 3:2"),
+	describe<DowntownRules>("downtown", "2 decks, dealer hits soft 17, Blackjack pays 3:2"),
+	describe<AtlanticCityRules>("atlantic", "8 decks, dealer stands on all 17s, Blackjack pays 3:2"),
+	describe<SixToFiveRules>("6to5", "6 decks, dealer hits soft 17, Blackjack pays 6:5")
+};
+
+/**
+ * Function that looks up a variant by its short name.
+ * @param name Short name, e.g. "strip"
+ * @return A VariantId, or -1 if there is no such variant
+ */
+int findVariant(const char *name)
+{
+	for(int i = 0; i < NumVariants; ++i)
+	{
+		if(strcmp(Variants[i].name, name) == 0)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+} // namespace engine
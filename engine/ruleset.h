@@ -0,0 +1,150 @@
+#ifndef ENGINE_RULESET_H
+#define ENGINE_RULESET_H
+
+#include "hand.h"
+#include "rules.h"
+
+namespace engine {
+
+class Round;
+
+/**
+ * Policy class that describes the rules of a Blackjack variant.
+ * Every rule is a template parameter, so code templated on a RuleSet
+ * (Round::stand(), the simulator's worker loop) has the rules folded into
+ * constants and carries no branches on rule flags at run time.
+ * @tparam H17 The dealer hits soft 17 instead of standing on all 17s
+ * @tparam Decks Number of decks in the shoe
+ * @tparam BjNum Numerator of the Blackjack payout
+ * @tparam BjDen Denominator of the Blackjack payout
+ * @tparam Das The player may double after splitting
+ * @tparam Rsa The player may resplit Aces
+ * @tparam Ls The player may surrender late, after the dealer checked for Blackjack
+ * @tparam Bp A busted player pushes a busted dealer instead of losing
+ */
+template<bool H17, int Decks, int BjNum, int BjDen, bool Das, bool Rsa, bool Ls, bool Bp>
+struct RuleSet
+{
+	static const bool HitSoft17 = H17;         /**< dealer hits soft 17. */
+	static const int NumDecks = Decks;         /**< decks in the shoe. */
+	static const int BlackjackNum = BjNum;     /**< Blackjack pays BlackjackNum ... */
+	static const int BlackjackDen = BjDen;     /**< ... to BlackjackDen. */
+	static const bool DoubleAfterSplit = Das;  /**< double after split allowed. */
+	static const bool ResplitAces = Rsa;       /**< resplitting Aces allowed. */
+	static const bool LateSurrender = Ls;      /**< late surrender allowed. */
+	static const bool BustPush = Bp;           /**< busted hands push each other. */
+	
+	/**
+	 * Function that checks whether the dealer has to take another card.
+	 * @param dealer The dealer's hand
+	 * @return true: dealer must hit; false: dealer must stand
+	 */
+	static bool dealerMustHit(const Hand &dealer)
+	{
+		return dealer.score() < DealerStandsOn ||
+		       (HitSoft17 && dealer.score() == DealerStandsOn && dealer.isSoft());
+	}
+	
+	/**
+	 * Function that determines who wins a round.
+	 * @param player The player's hand
+	 * @param dealer The dealer's hand, after the dealer has played
+	 * @param split The player's hand comes from a split
+	 * @return Outcome of the round
+	 * @see engine::resolve()
+	 */
+	static Outcome resolve(const Hand &player, const Hand &dealer, bool split = false)
+	{
+		if(!BustPush && player.busted())
+		{
+			return DealerWins;
+		}
+		return engine::resolve(player, dealer, split);
+	}
+	
+	/**
+	 * Function that returns what a winning bet pays.
+	 * @param bet The bet
+	 * @param blackjack The winning hand is a Blackjack
+	 * @return Amount won, rounded down
+	 */
+	static int win(int bet, bool blackjack)
+	{
+		return blackjack ? bet * BlackjackNum / BlackjackDen : bet;
+	}
+};
+
+/** The game as the Blackjack window has always played it. */
+typedef RuleSet<false, 1, 1, 1, false, false, false, true> HouseRules;
+/** Las Vegas Strip: 4 decks, S17, 3:2, DAS, resplit Aces, late surrender. */
+typedef RuleSet<false, 4, 3, 2, true, true, true, false> StripRules;
+/** Downtown Las Vegas: 2 decks, H17, 3:2, DAS. */
+typedef RuleSet<true, 2, 3, 2, true, false, false, false> DowntownRules;
+/** Atlantic City: 8 decks, S17, 3:2, DAS, late surrender. */
+typedef RuleSet<false, 8, 3, 2, true, false, true, false> AtlanticCityRules;
+/** Low-limit shoe game: 6 decks, H17, 6:5, DAS. */
+typedef RuleSet<true, 6, 6, 5, true, false, false, false> SixToFiveRules;
+
+/**
+ * enum type representing the pre-instantiated variants, in the order of
+ * engine::Variants.
+ */
+enum VariantId {
+	               HouseVariant = 0,        /**< enum value HouseVariant - HouseRules. */
+	               StripVariant = 1,        /**< enum value StripVariant - StripRules. */
+	               DowntownVariant = 2,     /**< enum value DowntownVariant - DowntownRules. */
+	               AtlanticCityVariant = 3, /**< enum value AtlanticCityVariant - AtlanticCityRules. */
+	               SixToFiveVariant = 4,    /**< enum value SixToFiveVariant - SixToFiveRules. */
+	               NumVariants = 5
+	           };
+
+/**
+ * Struct that describes a pre-instantiated variant at run time.
+ * The function pointers are Round's member templates instantiated for the
+ * variant, for callers that pick the variant at run time and are not in a
+ * hot loop, like the GUI.
+ */
+struct Variant
+{
+	const char *name;                           /**< short name, e.g. "strip". */
+	const char *description;                    /**< one line summary of the rules. */
+	int numDecks;                               /**< decks in the shoe. */
+	bool hitSoft17;                             /**< dealer hits soft 17. */
+	int blackjackNum;                           /**< Blackjack pays blackjackNum ... */
+	int blackjackDen;                           /**< ... to blackjackDen. */
+	bool lateSurrender;                         /**< late surrender allowed. */
+	bool doubleAfterSplit;                      /**< double after split allowed. */
+	bool resplitAces;                           /**< resplitting Aces allowed. */
+	bool bustPush;                              /**< busted hands push each other. */
+	Outcome (*stand)(Round &round);             /**< Round::stand(). */
+	int (*net)(const Round &round, int bet);    /**< Round::net(). */
+};
+
+extern const Variant Variants[NumVariants];
+
+int findVariant(const char *name);
+
+/**
+ * Function that calls a visitor with the RuleSet of a variant.
+ * This is the one place a run time variant index is turned into a type;
+ * the visitor's visit<Rules>() then runs fully specialized.
+ * @param index A VariantId; anything else visits HouseRules
+ * @param visitor Object with a template member function visit<Rules>()
+ * @return What visit() returns
+ */
+template<class Visitor>
+typename Visitor::Result visitVariant(int index, Visitor &visitor)
+{
+	switch(index)
+	{
+	case StripVariant:        return visitor.template visit<StripRules>();
+	case DowntownVariant:     return visitor.template visit<DowntownRules>();
+	case AtlanticCityVariant: return visitor.template visit<AtlanticCityRules>();
+	case SixToFiveVariant:    return visitor.template visit<SixToFiveRules>();
+	default:                  return visitor.template visit<HouseRules>();
+	}
+}
+
+} // namespace engine
+
+#endif
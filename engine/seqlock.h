@@ -0,0 +1,111 @@
+#ifndef ENGINE_SEQLOCK_H
+#define ENGINE_SEQLOCK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <type_traits>
+
+namespace engine {
+
+/**
+ * Class template of a value one thread publishes and any thread reads.
+ * The writer never waits: it bumps a sequence number to odd, copies the
+ * value in and bumps it to even again. A reader copies the value out
+ * between two reads of the sequence and tries again if a store overlapped
+ * the copy, so neither side ever takes a lock. The value is kept as
+ * atomic words, which makes the racing copies well defined.
+ * @tparam T Value type, trivially copyable
+ */
+template<class T>
+class SeqLock
+{
+	static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+public:
+	/**
+	 * The SeqLock class constructor.
+	 * @param value Value readers see until the first store()
+	 */
+	explicit SeqLock(const T &value = T()) : m_sequence(0)
+	{
+		uint64_t words[Words] = {};
+		memcpy(words, &value, sizeof(T));
+		for(size_t i = 0; i < Words; ++i)
+		{
+			m_words[i].store(words[i], std::memory_order_relaxed);
+		}
+	}
+	
+	/**
+	 * Member function that publishes a value, from the writer thread.
+	 * @param value The value
+	 */
+	void store(const T &value)
+	{
+		uint64_t words[Words] = {};
+		memcpy(words, &value, sizeof(T));
+		
+		uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+		m_sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for(size_t i = 0; i < Words; ++i)
+		{
+			m_words[i].store(words[i], std::memory_order_relaxed);
+		}
+		m_sequence.store(sequence + 2, std::memory_order_release);
+	}
+	
+	/**
+	 * Member function that reads the latest value, from any thread.
+	 * @return The value
+	 */
+	T load() const
+	{
+		uint64_t words[Words];
+		for(;;)
+		{
+			uint32_t before = m_sequence.load(std::memory_order_acquire);
+			if(before & 1)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			for(size_t i = 0; i < Words; ++i)
+			{
+				words[i] = m_words[i].load(std::memory_order_relaxed);
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if(m_sequence.load(std::memory_order_relaxed) == before)
+			{
+				break;
+			}
+		}
+		
+		T value;
+		memcpy(&value, words, sizeof(T));
+		return value;
+	}
+	
+	/**
+	 * Member function that returns how many values were published.
+	 * @return Stores so far
+	 */
+	uint32_t version() const {return m_sequence.load(std::memory_order_acquire) / 2;}
+
+private:
+	SeqLock(const SeqLock &);
+	SeqLock &operator=(const SeqLock &);
+
+private:
+	static const size_t Words = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+	
+	std::atomic<uint32_t> m_sequence;
+	std::atomic<uint64_t> m_words[Words];
+};
+
+} // namespace engine
+
+#endif
@@ -0,0 +1,112 @@
+#include <math.h>
+#include "sessionstats.h"
+
+namespace engine {
+
+/**
+ * The SessionStats struct constructor.
+ * No round has been played.
+ */
+SessionStats::SessionStats() : hands(0), wins(0), losses(0), pushes(0), blackjacks(0), net(0),
+meanEv(0.0), sumSquares(0.0), streak(0), longestWinStreak(0), longestLossStreak(0)
+{}
+
+/**
+ * Member function that adds a settled round.
+ * @param net What the round paid, negative if lost
+ * @param bet Bet the round was dealt for
+ * @param blackjack Whether the player was dealt a Blackjack
+ */
+void SessionStats::add(int net, int bet, bool blackjack)
+{
+	++hands;
+	this->net += net;
+	if(blackjack)
+	{
+		++blackjacks;
+	}
+	
+	if(net > 0)
+	{
+		++wins;
+		streak = streak > 0 ? streak + 1 : 1;
+		if(streak > longestWinStreak)
+		{
+			longestWinStreak = streak;
+		}
+	}
+	else if(net < 0)
+	{
+		++losses;
+		streak = streak < 0 ? streak - 1 : -1;
+		if(-streak > longestLossStreak)
+		{
+			longestLossStreak = -streak;
+		}
+	}
+	else
+	{
+		++pushes;
+	}
+	
+	double ev = bet > 0 ? static_cast<double>(net) / bet : 0.0;
+	double delta = ev - meanEv;
+	meanEv += delta / hands;
+	sumSquares += delta * (ev - meanEv);
+}
+
+/**
+ * Member function that returns the fraction of rounds won.
+ * @return Rate between 0 and 1
+ */
+double SessionStats::winRate() const
+{
+	return hands == 0 ? 0.0 : static_cast<double>(wins) / hands;
+}
+
+/**
+ * Member function that returns the fraction of rounds lost.
+ * @return Rate between 0 and 1
+ */
+double SessionStats::lossRate() const
+{
+	return hands == 0 ? 0.0 : static_cast<double>(losses) / hands;
+}
+
+/**
+ * Member function that returns the fraction of rounds pushed.
+ * @return Rate between 0 and 1
+ */
+double SessionStats::pushRate() const
+{
+	return hands == 0 ? 0.0 : static_cast<double>(pushes) / hands;
+}
+
+/**
+ * Member function that returns the fraction of rounds dealt a Blackjack.
+ * @return Rate between 0 and 1
+ */
+double SessionStats::blackjackRate() const
+{
+	return hands == 0 ? 0.0 : static_cast<double>(blackjacks) / hands;
+}
+
+/**
+ * Member function that returns the sample variance of a round per unit bet.
+ * @return Variance, 0 before two rounds
+ */
+double SessionStats::variance() const
+{
+	return hands < 2 ? 0.0 : sumSquares / (hands - 1);
+}
+
+/**
+ * Member function that returns the sample standard deviation of a round per unit bet.
+ * @return Standard deviation, 0 before two rounds
+ */
+double SessionStats::standardDeviation() const
+{
+	return sqrt(variance());
+}
+
+} // namespace engine
@@ -0,0 +1,44 @@
+#ifndef ENGINE_SESSIONSTATS_H
+#define ENGINE_SESSIONSTATS_H
+
+#include <stdint.h>
+
+namespace engine {
+
+/**
+ * Struct that holds the running statistics of a session.
+ * Every settled round is added in constant time and memory: the mean and
+ * variance of what a round paid per unit bet are kept with Welford's
+ * update, which stays accurate over any number of rounds, and streaks
+ * are tracked as they happen. A round counts as won, lost or pushed by
+ * whether it paid the player, cost them or neither, split hands and
+ * insurance included; a push leaves a streak as it is.
+ */
+struct SessionStats
+{
+	uint64_t hands;               /**< rounds settled. */
+	uint64_t wins;                /**< rounds that paid the player. */
+	uint64_t losses;              /**< rounds that cost the player. */
+	uint64_t pushes;              /**< rounds nobody won. */
+	uint64_t blackjacks;          /**< rounds the player was dealt a Blackjack. */
+	int64_t net;                  /**< money won by the player. */
+	double meanEv;                /**< mean result of a round per unit bet. */
+	double sumSquares;            /**< sum of squared deviations from meanEv. */
+	int32_t streak;               /**< current run, wins positive and losses negative. */
+	int32_t longestWinStreak;     /**< most rounds won in a row. */
+	int32_t longestLossStreak;    /**< most rounds lost in a row. */
+	
+	SessionStats();
+	
+	void add(int net, int bet, bool blackjack);
+	double winRate() const;
+	double lossRate() const;
+	double pushRate() const;
+	double blackjackRate() const;
+	double variance() const;
+	double standardDeviation() const;
+};
+
+} // namespace engine
+
+#endif
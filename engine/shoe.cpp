@@ -0,0 +1,102 @@
+#include "shoe.h"
+
+namespace engine {
+
+const double Shoe::DefaultPenetration = 0.8;
+
+/**
+ * The Shoe class constructor.
+ * The shoe is filled with unshuffled cards.
+ * @param numDecks Number of decks, clamped to 1 to MaxDecks
+ * @param penetration Fraction of the shoe dealt before the cut card
+ */
+Shoe::Shoe(int numDecks, double penetration) : m_shuffleCount(0)
+{
+	configure(numDecks, penetration);
+}
+
+/**
+ * Member function that changes the number of decks and the penetration.
+ * The shoe is reset afterwards.
+ * @param numDecks Number of decks, clamped to 1 to MaxDecks
+ * @param penetration Fraction of the shoe dealt before the cut card, 
+ * clamped to 0 to 1
+ */
+void Shoe::configure(int numDecks, double penetration)
+{
+	if(numDecks < 1) numDecks = 1;
+	if(numDecks > MaxDecks) numDecks = MaxDecks;
+	if(penetration < 0.0) penetration = 0.0;
+	if(penetration > 1.0) penetration = 1.0;
+	
+	m_numDecks = numDecks;
+	m_penetration = penetration;
+	m_size = numDecks * Card::NumCards;
+	m_cutCard = static_cast<int>(penetration * m_size);
+	reset();
+}
+
+/**
+ * Member function that resets the shoe.
+ * The shoe is reset to an untouched state i.e. having all its cards, 
+ * deck after deck, unshuffled.
+ */
+void Shoe::reset()
+{
+	for(int i = 0; i < m_size; ++i)
+	{
+		m_cards[i] = Card(i % Card::NumCards);
+	}
+	restart();
+}
+
+/**
+ * Member function that returns the running count of the cards dealt.
+ * The count is the sum of the tags of the cards dealt since the last 
+ * shuffle, taken from the cards left per rank.
+ * @param system The counting system
+ * @return Running count since the last shuffle
+ */
+int Shoe::runningCount(CountSystem system) const
+{
+	int full = m_numDecks * Card::NumSuits;
+	int count = initialCount(system, m_numDecks);
+	
+	for(int r = 0; r < Card::NumRanks; ++r)
+	{
+		count += CountTags[system][r] * (full - m_rankLeft[r]);
+	}
+	
+	return count;
+}
+
+/**
+ * Member function that returns the true count of the cards dealt.
+ * The true count is the running count per deck left in the shoe.
+ * @param system The counting system
+ * @return Running count divided by the decks left, 0 if the shoe is empty
+ */
+double Shoe::trueCount(CountSystem system) const
+{
+	int left = cardsLeft();
+	if(left == 0)
+	{
+		return 0.0;
+	}
+	return runningCount(system) * static_cast<double>(Card::NumCards) / left;
+}
+
+/**
+ * Helper function that puts every card back in front of the cursor.
+ * The per-rank counts go back to full decks.
+ */
+void Shoe::restart()
+{
+	m_next = 0;
+	for(int r = 0; r < Card::NumRanks; ++r)
+	{
+		m_rankLeft[r] = static_cast<uint16_t>(m_numDecks * Card::NumSuits);
+	}
+}
+
+} // namespace engine
@@ -0,0 +1,129 @@
+#ifndef ENGINE_SHOE_H
+#define ENGINE_SHOE_H
+
+#include "card.h"
+#include "counting.h"
+#include "rng.h"
+
+namespace engine {
+
+/**
+ * Class that represents a shoe of one or more card decks without any UI 
+ * attached.
+ * The cards are held by value in a fixed-size array. Dealing only advances 
+ * a cursor and reshuffling permutes the array in place, so the shoe never 
+ * allocates. A cut card placed at the configured penetration tells when 
+ * the shoe is due for a reshuffle.
+ * 
+ * Dealing also keeps the cards left per rank up to date, so the counts 
+ * of every CountSystem and the remaining composition are worked out from 
+ * 13 numbers instead of the undealt cards.
+ */
+class Shoe
+{
+public:
+	static const int MaxDecks = 8;                         /**< largest shoe supported. */
+	static const int MaxCards = MaxDecks * Card::NumCards; /**< cards in the largest shoe. */
+	static const double DefaultPenetration;                /**< fraction dealt before the cut card. */
+	
+	explicit Shoe(int numDecks = 1, double penetration = DefaultPenetration);
+	
+	void configure(int numDecks, double penetration = DefaultPenetration);
+	
+	/**
+	 * Member function that returns the number of decks in the shoe.
+	 * @return Number of decks, 1 to MaxDecks
+	 */
+	int numDecks() const {return m_numDecks;}
+	
+	/**
+	 * Member function that returns the number of cards in the full shoe.
+	 * @return Number of cards in the full shoe
+	 */
+	int size() const {return m_size;}
+	
+	/**
+	 * Member function that returns the number of cards left in the shoe.
+	 * @return Number of cards left in the shoe
+	 */
+	int cardsLeft() const {return m_size - m_next;}
+	
+	/**
+	 * Member function that checks whether the cut card has come out.
+	 * @return true: the shoe should be reshuffled before the next round
+	 */
+	bool needsShuffle() const {return m_next >= m_cutCard;}
+	
+	/**
+	 * Member function that returns how many times the shoe was shuffled.
+	 * @return Number of calls to shuffle()
+	 */
+	uint32_t shuffleCount() const {return m_shuffleCount;}
+	
+	/**
+	 * Member function that returns the cut card position.
+	 * @return Fraction of the shoe dealt before the cut card
+	 */
+	double penetration() const {return m_penetration;}
+	
+	/**
+	 * Member function that returns the number of cards of one rank left.
+	 * @param rank A Card::Rank
+	 * @return Number of such cards left in the shoe
+	 */
+	int rankLeft(int rank) const {return m_rankLeft[rank];}
+	
+	int runningCount(CountSystem system = HiLo) const;
+	double trueCount(CountSystem system = HiLo) const;
+	
+	/**
+	 * Member function that deals one card from the shoe.
+	 * The shoe must not be empty.
+	 * @return The card dealt
+	 */
+	Card deal()
+	{
+		Card card = m_cards[m_next++];
+		--m_rankLeft[card.rank()];
+		return card;
+	}
+	
+	/**
+	 * Member function that looks at a card without dealing it.
+	 * @param offset Position from the top of the shoe, less than cardsLeft()
+	 * @return The card
+	 */
+	Card peek(int offset) const {return m_cards[m_next + offset];}
+	
+	/**
+	 * Member function that shuffles all cards back into the shoe.
+	 * @param rng Generator returning 64 random bits, e.g. engine::Rng
+	 * @see fisherYates()
+	 */
+	template<class Generator>
+	void shuffle(Generator &rng)
+	{
+		++m_shuffleCount;
+		fisherYates(m_cards, m_size, rng);
+		restart();
+	}
+	
+	void reset();
+	
+private:
+	void restart();
+	
+private:
+	Card m_cards[MaxCards];
+	int m_numDecks;
+	int m_size;
+	int m_next;
+	int m_cutCard;
+	double m_penetration;
+	uint32_t m_shuffleCount;
+	uint16_t m_rankLeft[Card::NumRanks];
+};
+
+} // namespace engine
+
+#endif
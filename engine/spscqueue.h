@@ -0,0 +1,101 @@
+#ifndef ENGINE_SPSCQUEUE_H
+#define ENGINE_SPSCQUEUE_H
+
+#include <stddef.h>
+#include <atomic>
+
+namespace engine {
+
+/**
+ * Class template of a bounded lock-free queue between two threads.
+ * One thread only pushes and the other only pops; neither ever blocks or
+ * allocates. Each side keeps its own copy of the other side's index and
+ * reads the shared one only when that copy says the queue is full or
+ * empty, so the indices bounce between the two cores as seldom as
+ * possible. They sit on cache lines of their own.
+ * @tparam T Element type, copied in and out
+ * @tparam Capacity Number of slots, a power of two
+ */
+template<class T, size_t Capacity>
+class SpscQueue
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	SpscQueue() : m_head(0), m_tailCache(0), m_tail(0), m_headCache(0) {}
+	
+	/**
+	 * Member function that appends an element, from the producer thread.
+	 * @param value The element
+	 * @return true: appended; false: the queue is full
+	 */
+	bool push(const T &value)
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+		if(tail - m_headCache == Capacity)
+		{
+			m_headCache = m_head.load(std::memory_order_acquire);
+			if(tail - m_headCache == Capacity) return false;
+		}
+		m_slots[tail & (Capacity - 1)] = value;
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+	
+	/**
+	 * Member function that takes the oldest element, from the consumer thread.
+	 * @param value Where to store the element
+	 * @return true: taken; false: the queue is empty
+	 */
+	bool pop(T &value)
+	{
+		size_t head = m_head.load(std::memory_order_relaxed);
+		if(head == m_tailCache)
+		{
+			m_tailCache = m_tail.load(std::memory_order_acquire);
+			if(head == m_tailCache) return false;
+		}
+		value = m_slots[head & (Capacity - 1)];
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+	
+	/**
+	 * Member function that checks whether a push would fail, from the producer thread.
+	 * @return true: no slot is free
+	 */
+	bool full() const
+	{
+		return m_tail.load(std::memory_order_relaxed) - m_head.load(std::memory_order_acquire) == Capacity;
+	}
+	
+	/**
+	 * Member function that checks whether a pop would fail, from the consumer thread.
+	 * @return true: nothing is queued
+	 */
+	bool empty() const
+	{
+		return m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_acquire);
+	}
+
+private:
+	SpscQueue(const SpscQueue &);
+	SpscQueue &operator=(const SpscQueue &);
+
+private:
+	static const size_t CacheLine = 64;
+	
+	// Consumer side
+	std::atomic<size_t> m_head;
+	size_t m_tailCache;
+	char m_consumerPad[CacheLine - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+	// Producer side
+	std::atomic<size_t> m_tail;
+	size_t m_headCache;
+	char m_producerPad[CacheLine - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+	T m_slots[Capacity];
+};
+
+} // namespace engine
+
+#endif
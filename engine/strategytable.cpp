@@ -0,0 +1,210 @@
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "strategytable.h"
+
+namespace engine {
+
+static_assert(sizeof(StrategyTable::Header) == 16, "StrategyTable::Header must have a fixed layout");
+static_assert(sizeof(StrategyTable::Cell) == 12, "StrategyTable::Cell must have a fixed layout");
+
+/**
+ * The StrategyTable class constructor.
+ * Every cell starts as Stand with an EV of 0.
+ * @param numDecks Decks the table is computed for
+ * @param variant Rules the table is computed for, a VariantId
+ */
+StrategyTable::StrategyTable(int numDecks, int variant)
+{
+	memcpy(m_header.magic, "BJST", 4);
+	m_header.version = Version;
+	m_header.numDecks = static_cast<uint16_t>(numDecks);
+	m_header.rules = static_cast<uint32_t>(variant);
+	m_header.numCells = NumCells;
+	memset(m_cells, 0, sizeof(m_cells));
+}
+
+/**
+ * Member function that looks up the best action.
+ * @param score Player's best score
+ * @param soft Whether an Ace is counted as 11
+ * @param upcard Value index of the dealer's upcard, 0 (Ace) to 9
+ * @return Best action, Stand for totals without a decision
+ */
+StrategyTable::Action StrategyTable::action(int score, bool soft, int upcard) const
+{
+	int r = row(score, soft);
+	
+	if(r < 0)
+	{
+		return Stand;
+	}
+	return static_cast<Action>(cell(r, upcard).action);
+}
+
+/**
+ * Member function that writes the table in its binary format.
+ * @param path File to write
+ * @return true: the file was written; false: an error occurred
+ */
+bool StrategyTable::save(const char *path) const
+{
+	FILE *file = fopen(path, "wb");
+	
+	if(file == 0)
+	{
+		return false;
+	}
+	
+	bool ok = fwrite(&m_header, sizeof(m_header), 1, file) == 1 && 
+	          fwrite(m_cells, sizeof(m_cells), 1, file) == 1;
+	
+	return fclose(file) == 0 && ok;
+}
+
+/**
+ * Member function that prints the table as text.
+ * Upcards are printed in the usual 2 to A order, "H" is hit, "S" is stand.
+ * @param out Stream to print to
+ * @param withEv Whether to print the EV of both actions under each row
+ */
+void StrategyTable::dump(FILE *out, bool withEv) const
+{
+	static const int Columns[NumUpcards] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 0};
+	
+	const Variant &rules = Variants[variant() < NumVariants ? variant() : HouseVariant];
+	fprintf(out, "# %s rules, %d deck%s, dealer %s\n", rules.name, numDecks(), 
+	        numDecks() == 1 ? "" : "s", rules.hitSoft17 ? "hits soft 17" : "stands on all 17s");
+	
+	for(int r = 0; r < NumRows; ++r)
+	{
+		if(r == 0 || r == NumHardRows)
+		{
+			fprintf(out, "%s      2      3      4      5      6      7      8      9      T      A\n", 
+			        r == 0 ? "Hard" : "Soft");
+		}
+		
+		int total = r < NumHardRows ? MinHard + r : MinSoft + r - NumHardRows;
+		fprintf(out, "%4d", total);
+		for(int c = 0; c < NumUpcards; ++c)
+		{
+			fprintf(out, "      %c", cell(r, Columns[c]).action == Hit ? 'H' : 'S');
+		}
+		fprintf(out, "\n");
+		
+		if(withEv)
+		{
+			fprintf(out, "   S");
+			for(int c = 0; c < NumUpcards; ++c)
+			{
+				fprintf(out, " %+.3f", cell(r, Columns[c]).evStand);
+			}
+			fprintf(out, "\n   H");
+			for(int c = 0; c < NumUpcards; ++c)
+			{
+				fprintf(out, " %+.3f", cell(r, Columns[c]).evHit);
+			}
+			fprintf(out, "\n");
+		}
+	}
+}
+
+/**
+ * The StrategyTableReader class constructor.
+ */
+StrategyTableReader::StrategyTableReader() : m_map(0), m_size(0), m_cells(0)
+{}
+
+/**
+ * The StrategyTableReader class destructor.
+ * The file is unmapped.
+ */
+StrategyTableReader::~StrategyTableReader()
+{
+	close();
+}
+
+/**
+ * Member function that maps a file.
+ * Any file already open is closed first.
+ * @param path File written by StrategyTable::save()
+ * @return true: the table is mapped; false: missing, unreadable or not a table
+ */
+bool StrategyTableReader::open(const char *path)
+{
+	close();
+	
+	int fd = ::open(path, O_RDONLY);
+	if(fd < 0)
+	{
+		return false;
+	}
+	
+	size_t expected = sizeof(StrategyTable::Header) + StrategyTable::NumCells * sizeof(StrategyTable::Cell);
+	struct stat st;
+	if(fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != expected)
+	{
+		::close(fd);
+		return false;
+	}
+	
+	m_size = expected;
+	m_map = mmap(0, m_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	
+	if(m_map == MAP_FAILED)
+	{
+		m_map = 0;
+		m_size = 0;
+		return false;
+	}
+	
+	const StrategyTable::Header &h = header();
+	if(memcmp(h.magic, "BJST", 4) != 0 || h.version != StrategyTable::Version || 
+	   h.rules >= static_cast<uint32_t>(NumVariants) || h.numCells != static_cast<uint32_t>(StrategyTable::NumCells))
+	{
+		close();
+		return false;
+	}
+	
+	m_cells = reinterpret_cast<const StrategyTable::Cell *>(static_cast<const char *>(m_map) + 
+	                                                        sizeof(StrategyTable::Header));
+	return true;
+}
+
+/**
+ * Member function that unmaps the file.
+ */
+void StrategyTableReader::close()
+{
+	if(m_map != 0)
+	{
+		munmap(m_map, m_size);
+	}
+	
+	m_map = 0;
+	m_size = 0;
+	m_cells = 0;
+}
+
+/**
+ * Member function that looks up the cell of a hand.
+ * @param score Player's best score
+ * @param soft Whether an Ace is counted as 11
+ * @param upcard Value index of the dealer's upcard, 0 (Ace) to 9
+ * @return The cell, 0 if no table is open or the total has no decision
+ */
+const StrategyTable::Cell *StrategyTableReader::find(int score, bool soft, int upcard) const
+{
+	int r = StrategyTable::row(score, soft);
+	
+	if(m_map == 0 || r < 0)
+	{
+		return 0;
+	}
+	return &cell(r, upcard);
+}
+
+} // namespace engine
@@ -0,0 +1,166 @@
+#ifndef ENGINE_STRATEGYTABLE_H
+#define ENGINE_STRATEGYTABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "composition.h"
+#include "ruleset.h"
+
+namespace engine {
+
+/**
+ * Class that holds a basic strategy table.
+ * There is one cell per player total and dealer upcard: hard 4 to 20 and 
+ * soft 12 to 20 against each upcard value index (0 is the Ace). Totals of 
+ * 21 or more have no decision - the player always stands. Each cell keeps 
+ * the best action and the EV of both actions under the rules of one 
+ * variant, once the dealer has checked for Blackjack.
+ *
+ * The binary file is the Header followed by the NumCells cells in row 
+ * order, all in host byte order.
+ */
+class StrategyTable
+{
+public:
+	/**
+	 * enum type representing a player action.
+	 */
+	enum Action {
+		            Stand = 0, /**< enum value Stand. */
+		            Hit = 1    /**< enum value Hit. */
+		        };
+	
+	static const int MinHard = 4;                           /**< first hard row. */
+	static const int MinSoft = 12;                          /**< first soft row. */
+	static const int MaxTotal = 20;                         /**< last row of each kind. */
+	static const int NumHardRows = MaxTotal - MinHard + 1;  /**< hard 4 to 20. */
+	static const int NumSoftRows = MaxTotal - MinSoft + 1;  /**< soft 12 to 20. */
+	static const int NumRows = NumHardRows + NumSoftRows;   /**< all rows. */
+	static const int NumUpcards = Composition::NumValues;   /**< dealer upcard values. */
+	static const int NumCells = NumRows * NumUpcards;       /**< all cells. */
+	static const uint16_t Version = 2;                      /**< file format version. */
+	
+	/**
+	 * Struct that holds one cell of the table.
+	 */
+	struct Cell
+	{
+		uint8_t action;      /**< best action, an Action. */
+		uint8_t reserved[3]; /**< always 0. */
+		float evStand;       /**< EV of standing. */
+		float evHit;         /**< EV of hitting. */
+	};
+	
+	/**
+	 * Struct that holds the file header.
+	 */
+	struct Header
+	{
+		char magic[4];      /**< always "BJST". */
+		uint16_t version;   /**< file format version. */
+		uint16_t numDecks;  /**< decks the table was computed for. */
+		uint32_t rules;     /**< rules the table was computed for, an engine::VariantId. */
+		uint32_t numCells;  /**< always NumCells. */
+	};
+	
+	explicit StrategyTable(int numDecks = 1, int variant = HouseVariant);
+	
+	/**
+	 * Function that maps a player total to a row.
+	 * @param score Player's best score
+	 * @param soft Whether an Ace is counted as 11
+	 * @return Row index, -1 if the total has no decision
+	 */
+	static int row(int score, bool soft)
+	{
+		if(score > MaxTotal) return -1;
+		if(soft) return score >= MinSoft ? NumHardRows + score - MinSoft : -1;
+		return score >= MinHard ? score - MinHard : -1;
+	}
+	
+	/**
+	 * Member function that returns one cell.
+	 * @param row Row index from row()
+	 * @param upcard Value index of the dealer's upcard, 0 (Ace) to 9
+	 * @return The cell
+	 */
+	const Cell &cell(int row, int upcard) const {return m_cells[row * NumUpcards + upcard];}
+	Cell &cell(int row, int upcard) {return m_cells[row * NumUpcards + upcard];}
+	
+	Action action(int score, bool soft, int upcard) const;
+	
+	/**
+	 * Member function that returns the number of decks.
+	 * @return Decks the table was computed for
+	 */
+	int numDecks() const {return m_header.numDecks;}
+	
+	/**
+	 * Member function that returns the rules.
+	 * @return Rules the table was computed for, an engine::VariantId
+	 */
+	int variant() const {return static_cast<int>(m_header.rules);}
+	
+	bool save(const char *path) const;
+	void dump(FILE *out, bool withEv) const;
+	
+private:
+	Header m_header;
+	Cell m_cells[NumCells];
+};
+
+/**
+ * Class that reads a basic strategy table file in place.
+ * The file written by StrategyTable::save() is memory-mapped, so a look-up 
+ * is an index into the mapping and opening a table costs no parsing.
+ */
+class StrategyTableReader
+{
+public:
+	StrategyTableReader();
+	~StrategyTableReader();
+	
+	bool open(const char *path);
+	void close();
+	
+	/**
+	 * Member function that checks whether a table is mapped.
+	 * @return true: cells can be looked up
+	 */
+	bool isOpen() const {return m_map != 0;}
+	
+	/**
+	 * Member function that returns the file header.
+	 * The file must be open.
+	 * @return The header
+	 */
+	const StrategyTable::Header &header() const {return *static_cast<const StrategyTable::Header *>(m_map);}
+	
+	/**
+	 * Member function that returns one cell.
+	 * The file must be open.
+	 * @param row Row index from StrategyTable::row()
+	 * @param upcard Value index of the dealer's upcard, 0 (Ace) to 9
+	 * @return The cell
+	 */
+	const StrategyTable::Cell &cell(int row, int upcard) const
+	{
+		return m_cells[row * StrategyTable::NumUpcards + upcard];
+	}
+	
+	const StrategyTable::Cell *find(int score, bool soft, int upcard) const;
+	
+private:
+	StrategyTableReader(const StrategyTableReader &);
+	StrategyTableReader &operator=(const StrategyTableReader &);
+	
+private:
+	void *m_map;
+	size_t m_size;
+	const StrategyTable::Cell *m_cells;
+};
+
+} // namespace engine
+
+#endif
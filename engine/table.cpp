@@ -0,0 +1,337 @@
+#include "table.h"
+
+namespace engine {
+
+/**
+ * The Table class constructor.
+ * The shoe holds as many decks as the variant is played with and is
+ * shuffled at once.
+ * @param variant Rules played, a VariantId; anything else plays HouseVariant
+ * @param seed Seed of the table's random number stream
+ * @param balance Money the player sits down with
+ * @param penetration Fraction of the shoe dealt before reshuffling
+ */
+Table::Table(int variant, uint64_t seed, int balance, double penetration) :
+m_variant(variant >= 0 && variant < NumVariants ? variant : static_cast<int>(HouseVariant)),
+m_shoe(Variants[m_variant].numDecks, penetration), m_rng(seed), m_round(m_shoe, m_rng),
+m_balance(balance), m_currentBet(0), m_extraWager(0), m_lastNet(0), m_advances(0),
+m_rounds(0), m_isBetting(true), m_peeked(false), m_hasCards(false)
+{
+	m_shoe.shuffle(m_rng);
+}
+
+/**
+ * Member function that starts the game over.
+ * This is Blackjack::resetGame(): any round being played is abandoned,
+ * the table is cleared, the player gets StartBalance and the shoe is
+ * reshuffled.
+ */
+void Table::newGame()
+{
+	m_shoe.shuffle(m_rng);
+	m_balance = StartBalance;
+	m_currentBet = 0;
+	m_extraWager = 0;
+	m_isBetting = true;
+	m_hasCards = false;
+}
+
+/**
+ * Member function that places chips on the bet, or takes the bet back.
+ * This is Blackjack::updateBet().
+ * @param amount Chips to add to the bet, 0 to clear it
+ * @return true: done; false: a round is being played or the balance
+ * does not cover the chips
+ */
+bool Table::bet(int amount)
+{
+	if(!m_isBetting || amount < 0)
+	{
+		return false;
+	}
+	
+	if(amount == 0)
+	{
+		m_balance += m_currentBet;
+		m_currentBet = 0;
+	}
+	else
+	{
+		if(m_balance < amount) return false;
+		
+		m_currentBet += amount;
+		m_balance -= amount;
+	}
+	return true;
+}
+
+/**
+ * Member function that checks whether a round can be dealt.
+ * @return true: deal() is allowed
+ */
+bool Table::canDeal() const
+{
+	return m_isBetting && m_currentBet > 0;
+}
+
+/**
+ * Member function that deals a round.
+ * The dealer checks a ten for Blackjack at once; under an Ace the check
+ * waits until the player has decided on insurance.
+ * @return true: dealt; false: not betting or no bet placed
+ */
+bool Table::deal()
+{
+	if(!canDeal())
+	{
+		return false;
+	}
+	
+	m_isBetting = false;
+	m_extraWager = 0;
+	m_peeked = false;
+	m_hasCards = true;
+	m_round.deal();
+	
+	if(!m_round.upcard().isAce() && peek())
+	{
+		return true;
+	}
+	advance();
+	return true;
+}
+
+/**
+ * Member function that deals one more card to the current hand.
+ * @return true: done; false: the hand may not take a card
+ */
+bool Table::hit()
+{
+	if(!canHit())
+	{
+		return false;
+	}
+	
+	if(!peek())
+	{
+		m_round.hit();
+		advance();
+	}
+	return true;
+}
+
+/**
+ * Member function that finishes the current hand.
+ * @return true: done; false: no round is being played
+ */
+bool Table::stand()
+{
+	if(m_isBetting)
+	{
+		return false;
+	}
+	
+	if(!peek())
+	{
+		m_round.next();
+		advance();
+	}
+	return true;
+}
+
+/**
+ * Member function that checks whether the current hand may be doubled.
+ * @return true: the rules allow it and the balance covers it
+ */
+bool Table::canDouble() const
+{
+	return !m_isBetting && m_round.canDouble(Variants[m_variant].doubleAfterSplit) &&
+	       canAfford(m_currentBet);
+}
+
+/**
+ * Member function that doubles the bet on the current hand.
+ * The hand gets one more card and is finished.
+ * @return true: done; false: not allowed
+ */
+bool Table::doubleDown()
+{
+	if(!canDouble())
+	{
+		return false;
+	}
+	
+	if(!peek())
+	{
+		m_extraWager += m_currentBet;
+		m_round.doubleDown();
+		advance();
+	}
+	return true;
+}
+
+/**
+ * Member function that checks whether the current hand may be split.
+ * @return true: the rules allow it and the balance covers it
+ */
+bool Table::canSplit() const
+{
+	return !m_isBetting && m_round.canSplit(Variants[m_variant].resplitAces) &&
+	       canAfford(m_currentBet);
+}
+
+/**
+ * Member function that splits the current hand into two.
+ * @return true: done; false: not allowed
+ */
+bool Table::split()
+{
+	if(!canSplit())
+	{
+		return false;
+	}
+	
+	if(!peek())
+	{
+		m_extraWager += m_currentBet;
+		m_round.split();
+		advance();
+	}
+	return true;
+}
+
+/**
+ * Member function that checks whether the hand may be surrendered.
+ * @return true: the rules allow it
+ */
+bool Table::canSurrender() const
+{
+	return !m_isBetting && m_round.canSurrender(Variants[m_variant].lateSurrender);
+}
+
+/**
+ * Member function that gives up the hand for half the bet.
+ * @return true: done; false: not allowed
+ */
+bool Table::surrender()
+{
+	if(!canSurrender())
+	{
+		return false;
+	}
+	
+	if(!peek())
+	{
+		m_round.surrender();
+		advance();
+	}
+	return true;
+}
+
+/**
+ * Member function that checks whether insurance is on offer.
+ * @return true: the dealer shows an Ace and the balance covers half the bet
+ */
+bool Table::canInsure() const
+{
+	return !m_isBetting && m_round.canInsure() && canAfford(m_currentBet / 2);
+}
+
+/**
+ * Member function that places an insurance bet of half the bet.
+ * The dealer then checks for Blackjack.
+ * @return true: done; false: not allowed
+ */
+bool Table::insure()
+{
+	if(!canInsure())
+	{
+		return false;
+	}
+	
+	m_extraWager += m_currentBet / 2;
+	m_round.insure();
+	if(!peek())
+	{
+		advance();
+	}
+	return true;
+}
+
+/**
+ * Helper function that checks whether the player can cover another wager.
+ * The bet is already off the balance; the extra wagers of the round are
+ * only taken off when it is settled.
+ * @param amount The extra wager
+ * @return true: the balance covers it
+ */
+bool Table::canAfford(int amount) const
+{
+	return amount > 0 && m_balance - m_extraWager >= amount;
+}
+
+/**
+ * Helper function that lets the dealer check the hole card for Blackjack.
+ * This is done once per round. With a Blackjack the dealer plays at once
+ * and the round is over.
+ * @return true: the dealer had Blackjack and the round is over
+ */
+bool Table::peek()
+{
+	if(m_peeked)
+	{
+		return false;
+	}
+	
+	m_peeked = true;
+	if(m_round.dealer().isBlackjack())
+	{
+		dealerPlays();
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Helper function that moves play on after each of the player's actions.
+ * Hands that cannot take another card are finished for the player, unless
+ * insurance is still on offer. Once every hand is finished the dealer plays.
+ */
+void Table::advance()
+{
+	while(!m_round.done() && !m_round.canHit() && !m_round.canInsure())
+	{
+		m_round.next();
+	}
+	
+	if(m_round.done())
+	{
+		dealerPlays();
+	}
+}
+
+/**
+ * Helper function that lets the dealer play and settles the round.
+ * Every hand, double, surrender and insurance is paid out together. A
+ * player left without a bet is advanced StartBalance on a fresh shoe.
+ */
+void Table::dealerPlays()
+{
+	const Variant &rules = Variants[m_variant];
+	rules.stand(m_round);
+	
+	m_lastNet = rules.net(m_round, m_currentBet);
+	settleNet(m_lastNet, m_currentBet, m_balance);
+	m_extraWager = 0;
+	m_isBetting = true;
+	++m_rounds;
+	
+	if(m_currentBet == 0)
+	{
+		m_balance = StartBalance;
+		m_shoe.shuffle(m_rng);
+		++m_advances;
+	}
+}
+
+} // namespace engine
@@ -0,0 +1,146 @@
+#ifndef ENGINE_TABLE_H
+#define ENGINE_TABLE_H
+
+#include <stdint.h>
+#include "rng.h"
+#include "round.h"
+#include "ruleset.h"
+#include "shoe.h"
+
+namespace engine {
+
+/**
+ * Class that runs one seat of the game without any UI.
+ * This is the game flow of the Blackjack window's slots: the bet is taken
+ * off the balance as chips are placed, deal() starts a round, the player's
+ * actions are only accepted when the buttons would be enabled, the dealer
+ * checks for Blackjack once, and the round is settled as soon as the
+ * player has finished. A player who goes broke is advanced StartBalance
+ * again, as the game does.
+ *
+ * Every action returns false and changes nothing when it is not allowed,
+ * so a remote client cannot get the table into a state the game could not.
+ */
+class Table
+{
+public:
+	static const int StartBalance = 1000; /**< money a new player is given. */
+	
+	explicit Table(int variant = HouseVariant, uint64_t seed = 0, int balance = StartBalance,
+	               double penetration = Shoe::DefaultPenetration);
+	
+	void newGame();
+	bool bet(int amount);
+	bool deal();
+	bool hit();
+	bool stand();
+	bool doubleDown();
+	bool split();
+	bool surrender();
+	bool insure();
+	
+	bool canDeal() const;
+	bool canDouble() const;
+	bool canSplit() const;
+	bool canSurrender() const;
+	bool canInsure() const;
+	
+	/**
+	 * Member function that checks whether the player may take a card.
+	 * @return true: hit() is allowed
+	 */
+	bool canHit() const {return !m_isBetting && m_round.canHit();}
+	
+	/**
+	 * Member function that checks whether the table is between rounds.
+	 * The dealer's hole card is face down while this is false.
+	 * @return true: bets are taken; false: a round is being played
+	 */
+	bool isBetting() const {return m_isBetting;}
+	
+	/**
+	 * Member function that checks whether there are cards on the table.
+	 * @return true: a round has been dealt since the game started
+	 */
+	bool hasCards() const {return m_hasCards;}
+	
+	/**
+	 * Member function that returns the player's balance.
+	 * @return Money not on the table
+	 */
+	int balance() const {return m_balance;}
+	
+	/**
+	 * Member function that returns the player's bet.
+	 * @return Bet on each hand
+	 */
+	int currentBet() const {return m_currentBet;}
+	
+	/**
+	 * Member function that returns the doubles, splits and insurance of
+	 * the round being played.
+	 * @return Money wagered on top of the bet
+	 */
+	int extraWager() const {return m_extraWager;}
+	
+	/**
+	 * Member function that returns what the last round paid.
+	 * @return Amount won by the player, negative if lost
+	 */
+	int lastNet() const {return m_lastNet;}
+	
+	/**
+	 * Member function that returns how often the player went broke.
+	 * @return Number of times StartBalance was advanced
+	 */
+	int advances() const {return m_advances;}
+	
+	/**
+	 * Member function that returns the number of rounds settled.
+	 * @return Rounds played at this table
+	 */
+	uint32_t rounds() const {return m_rounds;}
+	
+	/**
+	 * Member function that returns the rules played.
+	 * @return A VariantId
+	 */
+	int variant() const {return m_variant;}
+	
+	/**
+	 * Member function that returns the round being played, or the last one.
+	 * @return The round
+	 */
+	const Round &round() const {return m_round;}
+	
+	/**
+	 * Member function that returns the shoe.
+	 * @return The shoe the table deals from
+	 */
+	const Shoe &shoe() const {return m_shoe;}
+
+private:
+	bool canAfford(int amount) const;
+	bool peek();
+	void advance();
+	void dealerPlays();
+
+private:
+	int m_variant;
+	Shoe m_shoe;
+	Rng m_rng;
+	Round m_round;
+	int m_balance;
+	int m_currentBet;
+	int m_extraWager;
+	int m_lastNet;
+	int m_advances;
+	uint32_t m_rounds;
+	bool m_isBetting;
+	bool m_peeked;
+	bool m_hasCards;
+};
+
+} // namespace engine
+
+#endif
@@ -0,0 +1,471 @@
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include "handlog.h"
+#include "seqlock.h"
+#include "spscqueue.h"
+#include "tablethread.h"
+
+namespace engine {
+
+static const size_t CommandSlots = 64;  /**< commands a seat can have queued. */
+static const size_t SnapshotSlots = 64; /**< snapshots a seat can have queued. */
+static const int SpinRounds = 2000;     /**< idle passes before the engine thread sleeps. */
+static const int SleepMs = 100;         /**< longest sleep before every seat is checked again. */
+
+/**
+ * The SeatOptions struct constructor.
+ * A seat plays the house rules with StartBalance, no hand history and no 
+ * journal.
+ */
+SeatOptions::SeatOptions() :
+variant(HouseVariant), seed(0), balance(Table::StartBalance), penetration(Shoe::DefaultPenetration),
+journalSyncEvents(Journal::DefaultSyncEvents), journalSyncMs(Journal::DefaultSyncMs)
+{}
+
+/**
+ * Struct that holds one seat: its table, its two queues and its hand
+ * history. Only the engine thread touches the table once it is running.
+ */
+struct TableThread::Seat
+{
+	SeatOptions options;                                /**< how the current table was set up. */
+	std::unique_ptr<Table> table;                       /**< the table. */
+	SpscQueue<Request, CommandSlots> commands;          /**< owner to engine. */
+	SpscQueue<TableSnapshot, SnapshotSlots> snapshots;  /**< engine to owner. */
+	HandLogWriter handLog;                              /**< hand history, if any. */
+	HandRecord record;                                  /**< the round being written. */
+	Journal journal;                                    /**< session journal, if any. */
+	SessionStats stats;                                 /**< statistics of the session. */
+	SeqLock<SessionStats> published;                    /**< the statistics, for any thread. */
+	uint32_t sequence;                                  /**< commands carried out. */
+	uint32_t shoeId;                                    /**< shuffles once the round was dealt. */
+	int wager;                                          /**< bet of the round being played. */
+	bool handLogFailed;                                 /**< the hand history could not be opened. */
+	bool journalFailed;                                 /**< the session journal could not be opened. */
+	bool journalFull;                                   /**< a group of journal events awaits its commit. */
+	
+	explicit Seat(const SeatOptions &seatOptions);
+	
+	void sit();
+	ReplyStatus join(int variant);
+	ReplyStatus play(const Request &request);
+	void writeJournal(const Request &request, ReplyStatus status, uint32_t rounds, int advances);
+	void snapshot(ReplyStatus status);
+};
+
+/**
+ * The Seat struct constructor.
+ * @param seatOptions How the table is set up
+ */
+TableThread::Seat::Seat(const SeatOptions &seatOptions) :
+options(seatOptions), sequence(0), shoeId(0), wager(0), handLogFailed(false),
+journalFailed(false), journalFull(false)
+{
+	sit();
+	if(!options.journalPath.empty())
+	{
+		journalFailed = !journal.open(options.journalPath.c_str(), options.journalSyncEvents,
+		                              options.journalSyncMs);
+	}
+}
+
+/**
+ * Member function that sets up a new table from the options.
+ * Every round is appended to DIR/SEED.bjhl, so the table can be replayed
+ * from the file alone.
+ */
+void TableThread::Seat::sit()
+{
+	table.reset(new Table(options.variant, options.seed, options.balance, options.penetration));
+	handLog.close();
+	handLogFailed = false;
+	if(options.handLogDir.empty())
+	{
+		return;
+	}
+	
+	char path[4096];
+	snprintf(path, sizeof(path), "%s/%llu.bjhl", options.handLogDir.c_str(),
+	         static_cast<unsigned long long>(options.seed));
+	handLogFailed = !handLog.open(path, options.seed, 0, table->shoe().numDecks(),
+	                              table->shoe().penetration(), table->variant());
+}
+
+/**
+ * Member function that moves the player to a table of other rules.
+ * This is only possible between rounds. The player's money, bet included,
+ * goes along; the new table has a seed of its own and a hand history of
+ * its own, as each file is played under one set of rules.
+ * @param variant The rules, a VariantId
+ * @return Whether the player moved
+ */
+ReplyStatus TableThread::Seat::join(int variant)
+{
+	if(variant < 0 || variant >= NumVariants || !table->isBetting())
+	{
+		return ReplyRefused;
+	}
+	
+	options.variant = variant;
+	options.seed = SplitMix64(options.seed)();
+	options.balance = table->balance() + table->currentBet();
+	sit();
+	journalFull = journal.append(JournalJoin, true, 0, table->balance(), table->currentBet());
+	return ReplyOk;
+}
+
+/**
+ * Member function that carries out a command, logs and tallies a settled 
+ * round and journals what the command did to the money. A new game 
+ * starts the statistics over.
+ * @param request The command
+ * @return Whether it was carried out
+ */
+ReplyStatus TableThread::Seat::play(const Request &request)
+{
+	if(request.command == CommandJoin)
+	{
+		return join(request.argument);
+	}
+	
+	uint32_t rounds = table->rounds();
+	int advances = table->advances();
+	int bet = table->currentBet();
+	ReplyStatus status = execute(*table, request);
+	
+	// A round the deal settles may already have taken the bet
+	if(request.command == CommandDeal && status == ReplyOk)
+	{
+		shoeId = table->shoe().shuffleCount();
+		wager = bet;
+	}
+	
+	// The balance logged is the one the round left, before any advance
+	if(table->rounds() != rounds && handLog.isOpen())
+	{
+		int balance = table->advances() != advances ? 0 : table->balance();
+		record.set(shoeId, rounds, wager, balance, table->round().outcome(0), table->round());
+		handLog.append(record);
+	}
+	
+	if(table->rounds() != rounds)
+	{
+		const Round &round = table->round();
+		stats.add(table->lastNet(), wager, round.numHands() == 1 && round.player().isBlackjack());
+		published.store(stats);
+	}
+	else if(request.command == CommandNewGame && status == ReplyOk)
+	{
+		stats = SessionStats();
+		published.store(stats);
+	}
+	
+	writeJournal(request, status, rounds, advances);
+	return status;
+}
+
+/**
+ * Member function that journals what a command did to the money.
+ * Hits and stands change nothing until the round is settled; a round 
+ * settled by the deal itself, on a dealer Blackjack, is journaled as 
+ * settled. A full group of events is left for serve() to commit.
+ * @param request The command
+ * @param status Whether it was carried out
+ * @param rounds Rounds settled before the command
+ * @param advances Advances before the command
+ */
+void TableThread::Seat::writeJournal(const Request &request, ReplyStatus status, uint32_t rounds, int advances)
+{
+	if(!journal.isOpen() || status != ReplyOk)
+	{
+		return;
+	}
+	
+	if(table->rounds() != rounds)
+	{
+		bool advanced = table->advances() != advances;
+		journalFull = journal.append(JournalSettle, true, table->lastNet(), advanced ? 0 : table->balance(),
+		                             advanced ? 0 : table->currentBet());
+		if(advanced)
+		{
+			journalFull = journal.append(JournalAdvance, true, Table::StartBalance, table->balance(), table->currentBet());
+		}
+	}
+	else if(request.command == CommandDeal)
+	{
+		journalFull = journal.append(JournalDeal, false, table->currentBet(), table->balance(), table->currentBet());
+	}
+	else if(request.command == CommandBet)
+	{
+		journalFull = journal.append(JournalBet, true, request.argument, table->balance(), table->currentBet());
+	}
+	else if(request.command == CommandNewGame)
+	{
+		journalFull = journal.append(JournalNewGame, true, 0, table->balance(), table->currentBet());
+	}
+}
+
+/**
+ * Member function that queues the seat's snapshot for its owner.
+ * @param status Whether the last command was carried out
+ */
+void TableThread::Seat::snapshot(ReplyStatus status)
+{
+	TableSnapshot out;
+	out.state.set(*table, status);
+	out.sequence = sequence;
+	out.cardsLeft = table->shoe().cardsLeft();
+	out.runningCount = table->shoe().runningCount(HiLo);
+	out.trueCount = table->shoe().trueCount(HiLo);
+	out.unseen = Composition::remaining(table->shoe());
+	if(out.state.holeHidden)
+	{
+		out.unseen.add(Composition::indexOf(table->round().dealer().card(1)));
+	}
+	out.seed = options.seed;
+	out.handLogFailed = handLogFailed;
+	out.journalFailed = journalFailed || journal.failed();
+	snapshots.push(out);
+}
+
+/**
+ * The TableThread class constructor.
+ * The thread is not started until start().
+ */
+TableThread::TableThread() : m_running(false), m_sleeping(false)
+{}
+
+/**
+ * The TableThread class destructor.
+ * The thread is stopped and the hand histories are flushed.
+ */
+TableThread::~TableThread()
+{
+	stop();
+}
+
+/**
+ * Member function that adds a seat.
+ * This is only possible before start(). The seat's first snapshot is
+ * ready to be polled at once.
+ * @param options How the seat's table is set up
+ * @return Index of the seat
+ */
+int TableThread::addSeat(const SeatOptions &options)
+{
+	m_seats.push_back(std::unique_ptr<Seat>(new Seat(options)));
+	m_seats.back()->snapshot(ReplyOk);
+	return static_cast<int>(m_seats.size()) - 1;
+}
+
+/**
+ * Member function that starts the engine thread.
+ */
+void TableThread::start()
+{
+	if(m_running.load())
+	{
+		return;
+	}
+	m_running.store(true);
+	m_thread = std::thread(&TableThread::run, this);
+}
+
+/**
+ * Member function that stops the engine thread.
+ * Commands still queued are dropped. The hand histories are flushed and 
+ * the journals committed.
+ */
+void TableThread::stop()
+{
+	if(!m_running.load())
+	{
+		return;
+	}
+	
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_running.store(false);
+	}
+	m_wake.notify_one();
+	m_thread.join();
+	
+	for(size_t i = 0; i < m_seats.size(); ++i)
+	{
+		m_seats[i]->handLog.flush();
+		m_seats[i]->journal.commit();
+	}
+}
+
+/**
+ * Member function that queues a command for a seat.
+ * Only the seat's owner may call this; the engine thread is woken if it
+ * sleeps.
+ * @param seat Index of the seat
+ * @param request The command
+ * @return true: queued; false: too many commands are waiting
+ */
+bool TableThread::post(int seat, const Request &request)
+{
+	if(!m_seats[seat]->commands.push(request))
+	{
+		return false;
+	}
+	
+	// Pairs with the fence in run(): either the engine sees the command or
+	// the poster sees it sleeping
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(m_sleeping.load(std::memory_order_relaxed))
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_wake.notify_one();
+	}
+	return true;
+}
+
+/**
+ * Member function that takes the oldest snapshot of a seat.
+ * Only the seat's owner may call this.
+ * @param seat Index of the seat
+ * @param snapshot Where to store the snapshot
+ * @return true: taken; false: nothing has happened since the last one
+ */
+bool TableThread::poll(int seat, TableSnapshot &snapshot)
+{
+	return m_seats[seat]->snapshots.pop(snapshot);
+}
+
+/**
+ * Member function that returns the statistics of a seat's session.
+ * This may be called from any thread, any number of times; it never 
+ * waits for the engine thread.
+ * @param seat Seat number returned by addSeat()
+ * @return Statistics as of the last settled round
+ */
+SessionStats TableThread::stats(int seat) const
+{
+	return m_seats[seat]->published.load();
+}
+
+/**
+ * Member function that serves one command of a seat.
+ * Nothing is taken while the seat's snapshots are not being polled. The 
+ * snapshot goes out before a full group of journal events is committed, 
+ * so the owner never waits for the disk.
+ * @param seat The seat
+ * @return true: a command was carried out
+ */
+bool TableThread::serve(Seat &seat)
+{
+	Request request;
+	if(seat.snapshots.full() || !seat.commands.pop(request))
+	{
+		return false;
+	}
+	
+	ReplyStatus status = seat.play(request);
+	++seat.sequence;
+	seat.snapshot(status);
+	if(seat.journalFull)
+	{
+		seat.journal.commit();
+		seat.journalFull = false;
+	}
+	return true;
+}
+
+/**
+ * Member function that checks whether no seat has a command to serve.
+ * @return true: the engine thread may sleep
+ */
+bool TableThread::idle() const
+{
+	for(size_t i = 0; i < m_seats.size(); ++i)
+	{
+		if(!m_seats[i]->commands.empty() && !m_seats[i]->snapshots.full())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Member function that returns when the next journal commit is due.
+ * @return The earliest deadline of any seat, Clock::time_point::max() if none
+ */
+Journal::Clock::time_point TableThread::nextCommit() const
+{
+	Journal::Clock::time_point deadline = Journal::Clock::time_point::max();
+	for(size_t i = 0; i < m_seats.size(); ++i)
+	{
+		if(m_seats[i]->journal.deadline() < deadline)
+		{
+			deadline = m_seats[i]->journal.deadline();
+		}
+	}
+	return deadline;
+}
+
+/**
+ * Engine thread body.
+ * Seats are served in turn, one command each, and journal commits that 
+ * are due are made between them. An idle thread spins for a while, as 
+ * the next click usually follows soon, then sleeps until a command is 
+ * posted or the next commit is due.
+ */
+void TableThread::run()
+{
+	int spins = 0;
+	
+	while(m_running.load(std::memory_order_acquire))
+	{
+		bool busy = false;
+		for(size_t i = 0; i < m_seats.size(); ++i)
+		{
+			busy = serve(*m_seats[i]) || busy;
+		}
+		
+		Journal::Clock::time_point deadline = nextCommit();
+		if(deadline != Journal::Clock::time_point::max())
+		{
+			Journal::Clock::time_point now = Journal::Clock::now();
+			for(size_t i = 0; i < m_seats.size() && now >= deadline; ++i)
+			{
+				m_seats[i]->journal.commitDue(now);
+			}
+		}
+		
+		if(busy)
+		{
+			spins = 0;
+			continue;
+		}
+		if(++spins < SpinRounds)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		spins = 0;
+		
+		// Rounds are on their way to disk before the thread sleeps
+		for(size_t i = 0; i < m_seats.size(); ++i)
+		{
+			m_seats[i]->handLog.flush();
+		}
+		
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_sleeping.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(idle() && m_running.load(std::memory_order_relaxed))
+		{
+			Journal::Clock::time_point wakeAt = std::min(nextCommit(), Journal::Clock::now() +
+			                                    std::chrono::milliseconds(SleepMs));
+			m_wake.wait_until(lock, wakeAt);
+		}
+		m_sleeping.store(false, std::memory_order_relaxed);
+	}
+}
+
+} // namespace engine
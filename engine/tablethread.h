@@ -0,0 +1,107 @@
+#ifndef ENGINE_TABLETHREAD_H
+#define ENGINE_TABLETHREAD_H
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "composition.h"
+#include "journal.h"
+#include "protocol.h"
+#include "sessionstats.h"
+#include "table.h"
+
+namespace engine {
+
+/**
+ * Struct that holds how a seat of a TableThread is set up.
+ */
+struct SeatOptions
+{
+	int variant;                  /**< rules played, an engine::VariantId. */
+	uint64_t seed;                /**< seed of the table's random number stream. */
+	int balance;                  /**< money the player sits down with. */
+	double penetration;           /**< fraction of the shoe dealt before reshuffling. */
+	std::string handLogDir;       /**< directory of the hand history, empty for none. */
+	std::string journalPath;      /**< session journal, empty for none. */
+	int journalSyncEvents;        /**< events the journal commits together at most. */
+	int journalSyncMs;            /**< milliseconds an event waits to be committed at most. */
+	
+	SeatOptions();
+};
+
+/**
+ * Struct that holds what a seat looks like after one of its commands.
+ * The state is the one the table server would send back, with the
+ * dealer's hole card kept and holeHidden set while it is face down.
+ */
+struct TableSnapshot
+{
+	TableState state;             /**< the table, after the command. */
+	uint32_t sequence;            /**< commands carried out at the seat so far. */
+	int cardsLeft;                /**< cards left in the shoe. */
+	int runningCount;             /**< Hi-Lo running count of the shoe. */
+	double trueCount;             /**< Hi-Lo true count of the shoe. */
+	Composition unseen;           /**< the shoe, and the hole card while face down. */
+	uint64_t seed;                /**< seed of the table, names the hand history file. */
+	bool handLogFailed;           /**< the hand history could not be opened. */
+	bool journalFailed;           /**< the session journal could not be opened or written. */
+};
+
+/**
+ * Class that plays one or more seats of the game on a thread of its own.
+ * Each seat is an engine::Table driven by one thread, its owner, which
+ * posts Requests and polls TableSnapshots; the two meet in a pair of
+ * lock-free queues, so the owner never waits for the game and never takes
+ * a lock while the engine is busy. A window can post a click and go on
+ * painting, and a bot can play another seat of the same thread at full
+ * speed alongside it.
+ *
+ * The engine thread answers every command with a snapshot. It stops
+ * taking a seat's commands while that seat's snapshots are not being
+ * polled, and sleeps once every seat has been idle for a while. It also
+ * writes each seat's session journal, so the commits never hold up the
+ * owner, and tallies each seat's SessionStats, which any thread can read
+ * without a lock.
+ */
+class TableThread
+{
+public:
+	TableThread();
+	~TableThread();
+	
+	int addSeat(const SeatOptions &options);
+	void start();
+	void stop();
+	
+	bool post(int seat, const Request &request);
+	bool poll(int seat, TableSnapshot &snapshot);
+	SessionStats stats(int seat) const;
+
+private:
+	struct Seat;
+	
+	TableThread(const TableThread &);
+	TableThread &operator=(const TableThread &);
+	
+	void run();
+	bool serve(Seat &seat);
+	bool idle() const;
+	Journal::Clock::time_point nextCommit() const;
+
+private:
+	std::vector<std::unique_ptr<Seat> > m_seats;
+	std::thread m_thread;
+	std::atomic<bool> m_running;
+	std::atomic<bool> m_sleeping;
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+};
+
+} // namespace engine
+
+#endif
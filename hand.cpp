@@ -4,125 +4,73 @@
  * Default constructor for the Hand class.
  * The function does nothing so the hand will be empty.
  */
-Hand::Hand(QObject *parent) : QObject(parent)
-{}
-
-/**
- * Hand class constuctor.
- * This constuctor takes a card list to initialize the hand.
- * @param cards A card list to initialize the hand
- */
-Hand::Hand(QList<Card *> cards, QObject *parent) : 
-QObject(parent), m_cards(cards)
+Hand::Hand(QObject *parent) : QObject(parent), m_faceDown(0)
 {}
 
 /**
  * Member function that adds a card to the hand.
+ * The card is added facing up.
  * @param card Card to be added to the hand
  * @return Reference to the hand object
  */
-Hand& Hand::operator<<(Card *card)
+Hand& Hand::operator<<(engine::Card card)
 {
-	m_cards << card;
+	m_model << card;
 	emit handChanged();
 	return *this;
 }
 
 /**
- * Member function that calculates the best score of the hand.
- * This function calculates the score of the hand. It has some 
- * intelligence to determine whether an Ace should be counted as 10 or 1.
- * @return Best possible score of the hand
+ * Member function that sets a card face down or up.
+ * @param i Index of the card, must be less than numCards()
+ * @param wantFacedown = true: set the card face down; wantFacedown = false: set the card face up
  */
-int Hand::score() const
+void Hand::setFacedown(int i, bool wantFacedown)
 {
-	int score = 0;
-	int numcards = m_cards.count();
-	bool hasAce = false;
-	
-	// All Aces (if any) are counted as 1 first
-	for(int i = 0; i < numcards; ++i)
-	{
-		if(m_cards[i]->isAce())
-		{
-			hasAce = true;
-		}
-		score += cardPoints(m_cards[i]);
-	}
+	quint32 bit = static_cast<quint32>(1) << i;
+	quint32 faceDown = wantFacedown ? (m_faceDown | bit) : (m_faceDown & ~bit);
 	
-	// If the hand does contains Aces and the score is less than 11,
-	// then changes one Ace's from 1 to 11.
-	if(hasAce && score<=11)
+	if(faceDown != m_faceDown)
 	{
-		score += 10;
+		m_faceDown = faceDown;
+		emit handChanged();
 	}
-
-	return score;
 }
 
 /**
- * Member function that check whether is hand is a Blackjack.
- * @return true: the hand is a Blackjack; false: the hand is not a Blackjack
+ * Member function that makes the hand show the cards of an engine hand.
+ * Cards already shown are kept, with their faces, and only the new ones 
+ * are added; if the hand was rebuilt, as splitting does, it starts over.
+ * @param model The engine hand to follow
  */
-bool Hand::isBlackjack() const
+void Hand::sync(const engine::Hand &model)
 {
-	if((m_cards.count()==2) && (score()==21))
+	int same = 0;
+	while(same < m_model.numCards() && same < model.numCards() && 
+	      m_model.card(same) == model.card(same))
 	{
-		return true;
+		++same;
 	}
-	return false;
-}
-
-/**
- * Member function that check whether is hand has busted.
- * @return true: the hand has busted; false: the hand has not busted
- */
-bool Hand::busted() const
-{
-	if(score() > 21)
-	{
-		return true;
-	}
-	return false;
-}
 	
-/**
- * Helper function to check a card's point.
- * Note Aces are always counted as 1 in here.
- * @param cd A Card pointer
- * @return Score of the card
- */
-int Hand::cardPoints(Card *cd) const
-{
-	QChar c = cd->value();
-	
-	if(c.isDigit())
+	if(same < m_model.numCards())
 	{
-		return c.digitValue();
+		clear();
+		same = 0;
 	}
-	else if(c == 'a')
-	{
-		return 1;
-	}
-	else
+	
+	for(int i = same; i < model.numCards(); ++i)
 	{
-		return 10;
+		*this << model.card(i);
 	}
 }
 
 /**
- * Member function that deletes all cards in the hand.
+ * Member function that removes all cards from the hand.
  */
 void Hand::clear()
 {
-	int numCards = m_cards.count();
-	
-	for(int i = 0; i < numCards; ++i)
-	{
-		delete m_cards[i];
-	}
-	
-	m_cards.clear();
+	m_model.clear();
+	m_faceDown = 0;
 	emit handChanged();
 }
 
@@ -1,11 +1,14 @@
 #ifndef HAND_H
 #define HAND_H
 
-#include "card.h"
+#include <QObject>
+#include "engine/hand.h"
 
 /**
  * Class that represents a hand of cards.
- * This class only has one data member - a Card list.
+ * This class is the model of a hand: it holds the engine::Hand that 
+ * scores the cards and which cards are facing down, but no widgets. 
+ * HandView shows it.
  */
 class Hand : public QObject
 {
@@ -13,24 +16,56 @@ class Hand : public QObject
 	
 public:
 	Hand(QObject *parent = 0);
-	Hand(QList<Card *> cards, QObject *parent = 0);
 	
-	Hand& operator<<(Card *card);
-	int score() const;
-	bool isBlackjack() const;
-	bool busted() const;
+	Hand& operator<<(engine::Card card);
 	
 	/**
-	 * Member function that returns the hand.
-	 * @return The card list of the hand
+	 * Member function that returns the best score of the hand.
+	 * @return Best possible score of the hand
+	 * @see engine::Hand::score()
 	 */
-	QList<Card *> cards() const {return m_cards;}
+	int score() const {return m_model.score();}
+	
+	/**
+	 * Member function that check whether is hand is a Blackjack.
+	 * @return true: the hand is a Blackjack; false: the hand is not a Blackjack
+	 */
+	bool isBlackjack() const {return m_model.isBlackjack();}
+	
+	/**
+	 * Member function that check whether is hand has busted.
+	 * @return true: the hand has busted; false: the hand has not busted
+	 */
+	bool busted() const {return m_model.busted();}
+	
+	/**
+	 * Member function that returns one card of the hand.
+	 * @param i Index of the card, must be less than numCards()
+	 * @return The card
+	 */
+	engine::Card card(int i) const {return m_model.card(i);}
+	
+	/**
+	 * Member function that checks whether a card is facing down.
+	 * @param i Index of the card, must be less than numCards()
+	 * @return true: card is facing down; false: card is facing up
+	 */
+	bool isFaceDown(int i) const {return (m_faceDown >> i) & 1;}
+	
+	void setFacedown(int i, bool wantFacedown);
 	
 	/**
 	 * Member function that returns the number of cards in the hand.
 	 * @return Number of cards in the hand
 	 */
-	int numCards() const {return m_cards.count();}
+	int numCards() const {return m_model.numCards();}
+	
+	/**
+	 * Member function that returns the UI-free model of the hand.
+	 * @return The engine hand used for scoring and resolving rounds
+	 */
+	const engine::Hand &model() const {return m_model;}
+	void sync(const engine::Hand &model);
 	void clear();
 	
 signals:
@@ -42,10 +77,8 @@ signals:
 	void handChanged();
 	
 private:
-	int cardPoints(Card *c) const;
-
-private:
-	QList<Card *> m_cards;
+	engine::Hand m_model;
+	quint32 m_faceDown;
 };
 
 #endif
@@ -1,4 +1,5 @@
-#include <QDebug>
+#include <QEvent>
+#include <QTimer>
 
 #include "handview.h"
 
@@ -8,28 +9,119 @@
  * @see refresh()
  */
 HandView::HandView(Hand *hand, QWidget *parent) :
-QWidget(parent), m_hand(hand), m_numCards(hand->numCards())
+QWidget(parent), m_hand(hand), m_numPooled(0), m_numCards(0), m_step(-1), 
+m_layoutPending(false)
 {
-	setFixedSize(200, 120);
+	setMinimumSize(200, 120);
+	
+	if(parent != 0)
+	{
+		resize(qMax(200, parent->width()), 120);
+		parent->installEventFilter(this);
+	}
+	
 	refresh();
 }
 
 /**
  * Hand view refresh slot.
- * This slot is called when the hand is changed.
+ * This slot is called when the hand is changed. The cards are laid out 
+ * once control gets back to the event loop, so all changes made to the 
+ * hand by one action end up in a single layout and repaint.
  * @see Hand::handchanged()
  */
 void HandView::refresh()
 {
-	QList<Card *> cards = m_hand->cards();
-	m_numCards = m_hand->numCards();
+	if(!m_layoutPending)
+	{
+		m_layoutPending = true;
+		QTimer::singleShot(0, this, SLOT(layoutCards()));
+	}
+}
+
+/**
+ * Event filter that keeps the view as wide as its parent.
+ * @param watched The object the event is for
+ * @param event The event
+ * @return Always false, the event is passed on
+ */
+bool HandView::eventFilter(QObject *watched, QEvent *event)
+{
+	if(watched == parentWidget() && event->type() == QEvent::Resize)
+	{
+		resize(qMax(200, parentWidget()->width()), height());
+	}
+	
+	return QWidget::eventFilter(watched, event);
+}
+
+/**
+ * Overloaded resize event handler.
+ * The spacing of the cards depends on the width, so they are laid out 
+ * again.
+ */
+void HandView::resizeEvent(QResizeEvent *event)
+{
+	QWidget::resizeEvent(event);
+	m_step = -1;
+	refresh();
+}
+
+/**
+ * Slot that shows the cards of the hand.
+ * Every shown widget is re-bound to its card, which costs nothing unless 
+ * the card has changed. Only widgets that were hidden are placed, unless 
+ * the spacing has changed; widgets past the end of the hand are hidden.
+ */
+void HandView::layoutCards()
+{
+	m_layoutPending = false;
 	
-	for(int i = 0; i < m_numCards; ++i)
+	int numCards = m_hand->numCards();
+	int step = cardStep(numCards);
+	int first = (step == m_step) ? m_numCards : 0;
+	
+	for(int i = 0; i < numCards; ++i)
+	{
+		if(i == m_numPooled)
+		{
+			m_cards[m_numPooled++] = new Card(engine::Card(), Card::CardFaceUp, this);
+		}
+		
+		Card *c = m_cards[i];
+		c->bind(m_hand->card(i), m_hand->isFaceDown(i) ? Card::CardFaceDown : Card::CardFaceUp);
+		
+		if(i >= first)
+		{
+			c->setGeometry(step*i, 20, CardWidth, CardHeight);
+			c->show();
+		}
+	}
+	
+	for(int i = numCards; i < m_numCards; ++i)
 	{
-		Card *c = cards[i];
-					
-		c->setParent(this);
-		c->setGeometry(20*i, 20, 72, 96);
-		c->show();
-	}		
+		m_cards[i]->hide();
+	}
+	
+	m_numCards = numCards;
+	m_step = step;
+}
+
+/**
+ * Helper function that returns the horizontal distance between cards.
+ * @param numCards Number of cards to fit into the view
+ * @return Distance between the left edges of two neighbouring cards
+ */
+int HandView::cardStep(int numCards) const
+{
+	const int maxStep = CardWidth + 4;
+	const int minStep = 12;
+	
+	if(numCards < 2)
+	{
+		return maxStep;
+	}
+	
+	int step = (width() - CardWidth) / (numCards - 1);
+	return qBound(minStep, step, maxStep);
 }
@@ -2,24 +2,48 @@
 #define HANDVIEW_H
 
 #include <QHBoxLayout>
+#include "card.h"
 #include "hand.h"
 
 /**
  * Class that represents view of a hand.
+ * The view stretches to the width of its parent. Cards are laid out side 
+ * by side and only overlap once the hand no longer fits.
+ * 
+ * The view owns a pool of Card widgets, one per card position, created the 
+ * first time a hand grows that long and re-bound to new cards afterwards. 
+ * Clearing the hand only hides them.
  */
 class HandView : public QWidget
 {
 	Q_OBJECT
 	
 public:
+	static const int CardWidth = 72;  /**< width of a card pixmap. */
+	static const int CardHeight = 96; /**< height of a card pixmap. */
+	
 	HandView(Hand *hand, QWidget *parent = 0);
 		
 public slots:
 	void refresh();
 
+protected:
+	bool eventFilter(QObject *watched, QEvent *event);
+	void resizeEvent(QResizeEvent *event);
+	
+private slots:
+	void layoutCards();
+	
+private:
+	int cardStep(int numCards) const;
+	
 private:
 	Hand *m_hand;
+	Card *m_cards[engine::Hand::MaxCards];
+	int m_numPooled;
 	int m_numCards;
+	int m_step;
+	bool m_layoutPending;
 };
 
 #endif
@@ -1,5 +1,6 @@
 #include <QApplication>
 #include "blackjack.h"
+#include "card.h"
 
 int main(int argc, char *argv[])
 {
@@ -7,6 +8,8 @@ int main(int argc, char *argv[])
 	app.setOrganizationName("pandafruits");
 	app.setApplicationName("blackjack");
 	
+	// Card images are decoded in the background while the window is built
+	Card::preloadCardImages();
 	Blackjack blackjack;
 	blackjack.show();
 	
@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include "engine/handlog.h"
+#include "engine/replay.h"
+
+/**
+ * Helper function that prints the command line usage.
+ */
+static void usage(const char *prog)
+{
+	fprintf(stderr, 
+	        "Usage: %s [-r round] [-i interval] file.bjhl\n"
+	        "  -r  print this round (0 based) instead of replaying them all\n"
+	        "  -i  rounds between checkpoints (default 4096)\n", 
+	        prog);
+}
+
+/**
+ * Helper function that prints a hand as card names.
+ */
+static void printHand(const char *who, const engine::Hand &hand)
+{
+	printf("%-8s", who);
+	for(int i = 0; i < hand.numCards(); ++i)
+	{
+		printf(" %c%c", hand.card(i).value(), hand.card(i).suitChar());
+	}
+	printf("  (%d)\n", hand.score());
+}
+
+int main(int argc, char *argv[])
+{
+	long round = -1;
+	long interval = engine::Replay::DefaultInterval;
+	int opt;
+	
+	while((opt = getopt(argc, argv, "r:i:h")) != -1)
+	{
+		switch(opt)
+		{
+		case 'r': round = atol(optarg); break;
+		case 'i': interval = atol(optarg); break;
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	
+	if(optind != argc - 1 || interval < 1)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+	
+	engine::HandLogReader log;
+	if(!log.open(argv[optind]))
+	{
+		fprintf(stderr, "cannot read hand history %s\n", argv[optind]);
+		return 1;
+	}
+	
+	engine::Replay replay(log, interval);
+	
+	// Show one round
+	if(round >= 0)
+	{
+		static const char *Outcomes[] = {"player wins", "dealer wins", "push"};
+		
+		if(static_cast<size_t>(round) >= replay.count() || !replay.seek(round))
+		{
+			fprintf(stderr, "round %ld is past the end (%zu rounds)\n", round, replay.count());
+			return 1;
+		}
+		
+		bool matched = replay.step();
+		printf("round %ld, shoe %u\n", round, log.record(round).shoeId);
+		printHand("dealer", replay.dealer());
+		const engine::Round &played = replay.round();
+		for(int h = 0; h < played.numHands(); ++h)
+		{
+			char who[16];
+			snprintf(who, sizeof(who), played.numHands() > 1 ? "hand %d" : "player", h + 1);
+			printHand(who, played.player(h));
+			if(played.isDoubled(h) || played.isSurrendered(h) || played.numHands() > 1)
+			{
+				printf("%8s %s%s\n", "", played.isSurrendered(h) ? "surrendered" : Outcomes[played.outcome(h)], 
+				       played.isDoubled(h) ? ", doubled" : "");
+			}
+		}
+		if(played.isInsured())
+		{
+			printf("insured\n");
+		}
+		printf("%s%s\n", Outcomes[replay.outcome()], matched ? "" : "  ** differs from the record **");
+		return matched ? 0 : 2;
+	}
+	
+	// Fast-forward through everything and check each round
+	size_t mismatches = 0;
+	long firstMismatch = -1;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	while(replay.position() < replay.count())
+	{
+		size_t index = replay.position();
+		if(!replay.step() && mismatches++ == 0)
+		{
+			firstMismatch = static_cast<long>(index);
+		}
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	
+	printf("rounds        %zu\n", replay.count());
+	printf("mismatches    %zu\n", mismatches);
+	if(firstMismatch >= 0)
+	{
+		printf("first         %ld\n", firstMismatch);
+	}
+	if(seconds > 0)
+	{
+		printf("rounds/sec    %.0f\n", replay.count() / seconds);
+	}
+	
+	return mismatches == 0 ? 0 : 2;
+}
@@ -0,0 +1,18 @@
+######################################################################
+# Command line hand history replayer - no Qt dependency
+######################################################################
+
+TEMPLATE = app
+CONFIG += console
+CONFIG -= qt app_bundle
+TARGET = blackjack-replay
+DEPENDPATH += .
+INCLUDEPATH += . ..
+QMAKE_CXXFLAGS += -std=c++11
+
+# Game engine static library - build ../engine/engine.pro first
+LIBS += -L../engine -lengine
+PRE_TARGETDEPS += ../engine/libengine.a
+
+# Input
+SOURCES += main.cpp
@@ -0,0 +1,69 @@
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <thread>
+#include "engine/protocol.h"
+#include "server.h"
+
+/**
+ * Helper function that prints the command line usage.
+ */
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+	        "Usage: %s [-p port] [-t threads] [-s seed]\n"
+	        "  -p  TCP port to listen on (default %d)\n"
+	        "  -t  number of worker threads (default: all cores)\n"
+	        "  -s  random seed of the tables (default: current time)\n",
+	        prog, engine::DefaultPort);
+}
+
+int main(int argc, char *argv[])
+{
+	int port = engine::DefaultPort;
+	int numThreads = std::thread::hardware_concurrency();
+	uint64_t seed = time(0);
+	int opt;
+	
+	while((opt = getopt(argc, argv, "p:t:s:h")) != -1)
+	{
+		switch(opt)
+		{
+		case 'p': port = atoi(optarg); break;
+		case 't': numThreads = atoi(optarg); break;
+		case 's': seed = strtoull(optarg, 0, 10); break;
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	
+	if(numThreads < 1) numThreads = 1;
+	
+	// The workers must not see the signals; the main thread waits for them
+	sigset_t signals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &signals, 0);
+	
+	Server server(port, numThreads, seed);
+	if(!server.start())
+	{
+		return 1;
+	}
+	printf("serving tables on port %d with %d threads, seed %llu\n", port, numThreads,
+	       static_cast<unsigned long long>(seed));
+	fflush(stdout);
+	
+	int signal;
+	sigwait(&signals, &signal);
+	server.stop();
+	server.wait();
+	
+	printf("connections   %llu\n", static_cast<unsigned long long>(server.connections()));
+	printf("requests      %llu\n", static_cast<unsigned long long>(server.requests()));
+	return 0;
+}
@@ -0,0 +1,417 @@
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <memory>
+#include "engine/protocol.h"
+#include "engine/rng.h"
+#include "engine/table.h"
+#include "server.h"
+
+// Reply bytes queued on a connection before it stops being read
+static const size_t MaxQueued = 64 * 1024;
+
+// Events taken from epoll at a time
+static const int MaxEvents = 256;
+
+/**
+ * Struct that holds a player's connection and the table he sits at.
+ */
+struct Server::Connection
+{
+	int fd;                                     /**< the socket. */
+	bool writing;                               /**< waiting for the socket to take more replies. */
+	size_t received;                            /**< bytes of a partial request in request. */
+	uint8_t request[engine::Request::Size];     /**< request being received. */
+	std::vector<uint8_t> queued;                /**< replies not yet sent. */
+	size_t sent;                                /**< bytes of queued already sent. */
+	std::unique_ptr<engine::Table> table;       /**< the player's table. */
+};
+
+/**
+ * Struct that holds the state of one worker thread.
+ * Only the counters are read by other threads.
+ */
+struct Server::Worker
+{
+	int listenFd;                               /**< the worker's listening socket. */
+	int epollFd;                                /**< the worker's epoll set. */
+	int wakeFd;                                 /**< eventfd that stop() writes to. */
+	std::vector<Connection *> connections;      /**< connections by socket. */
+	std::atomic<uint64_t> accepted;             /**< connections accepted. */
+	std::atomic<uint64_t> requests;             /**< requests handled. */
+	
+	Worker() : listenFd(-1), epollFd(-1), wakeFd(-1), accepted(0), requests(0) {}
+};
+
+/**
+ * The Server class constructor.
+ * @param port TCP port to listen on
+ * @param numThreads Number of worker threads, at least 1
+ * @param seed Seed of the tables; table i is seeded from it and i
+ */
+Server::Server(int port, int numThreads, uint64_t seed) :
+m_port(port), m_numThreads(numThreads < 1 ? 1 : numThreads), m_seed(seed), m_nextTable(0)
+{}
+
+/**
+ * The Server class destructor.
+ * Stops the workers if they are running.
+ */
+Server::~Server()
+{
+	stop();
+	wait();
+	
+	for(size_t i = 0; i < m_workers.size(); ++i)
+	{
+		Worker *worker = m_workers[i];
+		if(worker->listenFd >= 0) ::close(worker->listenFd);
+		if(worker->epollFd >= 0) ::close(worker->epollFd);
+		if(worker->wakeFd >= 0) ::close(worker->wakeFd);
+		delete worker;
+	}
+}
+
+/**
+ * Member function that opens the sockets and starts the workers.
+ * @return true: serving; false: a socket could not be opened
+ */
+bool Server::start()
+{
+	for(int i = 0; i < m_numThreads; ++i)
+	{
+		Worker *worker = new Worker;
+		m_workers.push_back(worker);
+		
+		int one = 1;
+		sockaddr_in address;
+		memset(&address, 0, sizeof(address));
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_ANY);
+		address.sin_port = htons(static_cast<uint16_t>(m_port));
+		
+		worker->listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		if(worker->listenFd < 0 ||
+		   setsockopt(worker->listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) < 0 ||
+		   setsockopt(worker->listenFd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) < 0 ||
+		   bind(worker->listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+		   listen(worker->listenFd, SOMAXCONN) < 0)
+		{
+			perror("listen");
+			return false;
+		}
+		
+		worker->epollFd = epoll_create1(EPOLL_CLOEXEC);
+		worker->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if(worker->epollFd < 0 || worker->wakeFd < 0)
+		{
+			perror("epoll");
+			return false;
+		}
+		
+		epoll_event event;
+		event.events = EPOLLIN;
+		event.data.fd = worker->listenFd;
+		epoll_ctl(worker->epollFd, EPOLL_CTL_ADD, worker->listenFd, &event);
+		event.data.fd = worker->wakeFd;
+		epoll_ctl(worker->epollFd, EPOLL_CTL_ADD, worker->wakeFd, &event);
+	}
+	
+	for(int i = 0; i < m_numThreads; ++i)
+	{
+		m_threads.push_back(std::thread(&Server::work, this, m_workers[i]));
+	}
+	return true;
+}
+
+/**
+ * Member function that tells the workers to stop.
+ * Safe to call from any thread; open connections are closed.
+ */
+void Server::stop()
+{
+	uint64_t one = 1;
+	for(size_t i = 0; i < m_workers.size(); ++i)
+	{
+		if(m_workers[i]->wakeFd >= 0 && write(m_workers[i]->wakeFd, &one, sizeof(one)) < 0)
+		{
+			perror("stop");
+		}
+	}
+}
+
+/**
+ * Member function that waits for the workers to stop.
+ */
+void Server::wait()
+{
+	for(size_t i = 0; i < m_threads.size(); ++i)
+	{
+		m_threads[i].join();
+	}
+	m_threads.clear();
+}
+
+/**
+ * Member function that returns the number of connections accepted.
+ * @return Connections accepted by all workers so far
+ */
+uint64_t Server::connections() const
+{
+	uint64_t total = 0;
+	for(size_t i = 0; i < m_workers.size(); ++i)
+	{
+		total += m_workers[i]->accepted.load(std::memory_order_relaxed);
+	}
+	return total;
+}
+
+/**
+ * Member function that returns the number of requests handled.
+ * @return Requests handled by all workers so far
+ */
+uint64_t Server::requests() const
+{
+	uint64_t total = 0;
+	for(size_t i = 0; i < m_workers.size(); ++i)
+	{
+		total += m_workers[i]->requests.load(std::memory_order_relaxed);
+	}
+	return total;
+}
+
+/**
+ * Worker thread body.
+ * Waits for sockets to become ready and serves them until stop() is called.
+ * @param worker The worker's state
+ */
+void Server::work(Worker *worker)
+{
+	epoll_event events[MaxEvents];
+	bool running = true;
+	
+	while(running)
+	{
+		int n = epoll_wait(worker->epollFd, events, MaxEvents, -1);
+		if(n < 0)
+		{
+			if(errno == EINTR) continue;
+			perror("epoll_wait");
+			break;
+		}
+		
+		for(int i = 0; i < n; ++i)
+		{
+			int fd = events[i].data.fd;
+			if(fd == worker->wakeFd)
+			{
+				running = false;
+			}
+			else if(fd == worker->listenFd)
+			{
+				accept(worker);
+			}
+			else if(static_cast<size_t>(fd) < worker->connections.size() && worker->connections[fd] != 0)
+			{
+				Connection *connection = worker->connections[fd];
+				if(events[i].events & (EPOLLERR | EPOLLHUP))
+				{
+					close(worker, connection);
+				}
+				else if(connection->writing)
+				{
+					send(worker, connection);
+				}
+				else
+				{
+					receive(worker, connection);
+				}
+			}
+		}
+	}
+	
+	for(size_t fd = 0; fd < worker->connections.size(); ++fd)
+	{
+		if(worker->connections[fd] != 0)
+		{
+			close(worker, worker->connections[fd]);
+		}
+	}
+}
+
+/**
+ * Member function that accepts every pending connection.
+ * Each player gets a new table with the house rules until he joins another.
+ * @param worker The worker that accepts them
+ */
+void Server::accept(Worker *worker)
+{
+	for(;;)
+	{
+		int fd = accept4(worker->listenFd, 0, 0, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if(fd < 0)
+		{
+			if(errno == EINTR) continue;
+			if(errno != EAGAIN && errno != EWOULDBLOCK) perror("accept");
+			return;
+		}
+		
+		int one = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+		
+		Connection *connection = new Connection;
+		connection->fd = fd;
+		connection->writing = false;
+		connection->received = 0;
+		connection->sent = 0;
+		connection->table.reset(new engine::Table(engine::HouseVariant,
+		                        m_seed ^ engine::SplitMix64(m_nextTable++)()));
+		
+		if(static_cast<size_t>(fd) >= worker->connections.size())
+		{
+			worker->connections.resize(fd + 1, 0);
+		}
+		worker->connections[fd] = connection;
+		
+		epoll_event event;
+		event.events = EPOLLIN;
+		event.data.fd = fd;
+		epoll_ctl(worker->epollFd, EPOLL_CTL_ADD, fd, &event);
+		worker->accepted.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+/**
+ * Member function that reads requests from a connection and answers them.
+ * Reading stops once MaxQueued bytes of replies wait to be sent; the rest
+ * stays in the socket until the player has taken them.
+ * @param worker The worker that owns the connection
+ * @param connection The connection
+ */
+void Server::receive(Worker *worker, Connection *connection)
+{
+	uint8_t buffer[4096];
+	
+	while(connection->queued.size() - connection->sent < MaxQueued)
+	{
+		ssize_t n = recv(connection->fd, buffer, sizeof(buffer), 0);
+		if(n <= 0)
+		{
+			if(n < 0 && errno == EINTR) continue;
+			if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+			close(worker, connection);
+			return;
+		}
+		
+		for(ssize_t i = 0; i < n; )
+		{
+			size_t take = engine::Request::Size - connection->received;
+			if(take > static_cast<size_t>(n - i)) take = n - i;
+			memcpy(connection->request + connection->received, buffer + i, take);
+			connection->received += take;
+			i += take;
+			
+			if(connection->received < engine::Request::Size)
+			{
+				break;
+			}
+			connection->received = 0;
+			
+			engine::Request request;
+			request.decode(connection->request);
+			engine::Table &table = *connection->table;
+			engine::ReplyStatus status;
+			if(request.command == engine::CommandJoin)
+			{
+				// The money, bet included, moves to the new table
+				status = request.argument >= 0 && request.argument < engine::NumVariants && table.isBetting() ?
+				         engine::ReplyOk : engine::ReplyRefused;
+				if(status == engine::ReplyOk)
+				{
+					connection->table.reset(new engine::Table(request.argument,
+					                        m_seed ^ engine::SplitMix64(m_nextTable++)(),
+					                        table.balance() + table.currentBet()));
+				}
+			}
+			else
+			{
+				status = engine::execute(table, request);
+			}
+			
+			engine::TableState state;
+			state.set(*connection->table, status);
+			size_t end = connection->queued.size();
+			connection->queued.resize(end + engine::TableState::MaxSize);
+			end += state.encode(&connection->queued[end]);
+			connection->queued.resize(end);
+			worker->requests.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	
+	send(worker, connection);
+}
+
+/**
+ * Member function that sends the replies queued on a connection.
+ * What the socket cannot take is sent once it is writable again.
+ * @param worker The worker that owns the connection
+ * @param connection The connection
+ */
+void Server::send(Worker *worker, Connection *connection)
+{
+	while(connection->sent < connection->queued.size())
+	{
+		ssize_t n = ::send(connection->fd, &connection->queued[connection->sent],
+		                   connection->queued.size() - connection->sent, MSG_NOSIGNAL);
+		if(n < 0)
+		{
+			if(errno == EINTR) continue;
+			if(errno == EAGAIN || errno == EWOULDBLOCK)
+			{
+				if(!connection->writing) watch(worker, connection, true);
+				return;
+			}
+			close(worker, connection);
+			return;
+		}
+		connection->sent += n;
+	}
+	
+	connection->queued.clear();
+	connection->sent = 0;
+	if(connection->writing) watch(worker, connection, false);
+}
+
+/**
+ * Member function that closes a connection and gives up its table.
+ * @param worker The worker that owns the connection
+ * @param connection The connection, deleted
+ */
+void Server::close(Worker *worker, Connection *connection)
+{
+	worker->connections[connection->fd] = 0;
+	::close(connection->fd);
+	delete connection;
+}
+
+/**
+ * Member function that switches a connection between reading and writing.
+ * A connection is not read while its replies wait for the socket.
+ * @param worker The worker that owns the connection
+ * @param connection The connection
+ * @param writing true: wait until writable; false: wait for requests
+ */
+void Server::watch(Worker *worker, Connection *connection, bool writing)
+{
+	epoll_event event;
+	event.events = writing ? EPOLLOUT : EPOLLIN;
+	event.data.fd = connection->fd;
+	epoll_ctl(worker->epollFd, EPOLL_CTL_MOD, connection->fd, &event);
+	connection->writing = writing;
+}
@@ -0,0 +1,56 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/**
+ * Class that hosts game tables for remote players.
+ * Every connection is a seat at its own engine::Table. Each worker
+ * thread has its own listening socket on the port (SO_REUSEPORT, so the
+ * kernel spreads new connections over the workers) and its own epoll set,
+ * and owns every connection it accepts: a table is only ever touched by
+ * one thread, so there are no locks. Sockets are non-blocking and
+ * requests are handled as they come in; replies are queued per
+ * connection when the socket cannot take them, and a connection stops
+ * being read while too much is queued.
+ *
+ * The protocol is in engine/protocol.h: fixed-size requests, each
+ * answered with the state of the table.
+ */
+class Server
+{
+public:
+	Server(int port, int numThreads, uint64_t seed);
+	~Server();
+	
+	bool start();
+	void stop();
+	void wait();
+	
+	uint64_t connections() const;
+	uint64_t requests() const;
+
+private:
+	struct Connection;
+	struct Worker;
+	
+	void work(Worker *worker);
+	void accept(Worker *worker);
+	void receive(Worker *worker, Connection *connection);
+	void send(Worker *worker, Connection *connection);
+	void close(Worker *worker, Connection *connection);
+	void watch(Worker *worker, Connection *connection, bool writing);
+
+private:
+	int m_port;
+	int m_numThreads;
+	uint64_t m_seed;
+	std::atomic<uint64_t> m_nextTable;
+	std::vector<Worker *> m_workers;
+	std::vector<std::thread> m_threads;
+};
+
+#endif
@@ -0,0 +1,19 @@
+######################################################################
+# Multi-table game server for Linux (epoll) - no Qt dependency
+######################################################################
+
+TEMPLATE = app
+CONFIG += console thread
+CONFIG -= qt app_bundle
+TARGET = blackjack-server
+DEPENDPATH += .
+INCLUDEPATH += . ..
+QMAKE_CXXFLAGS += -std=c++11
+
+# Game engine static library - build ../engine/engine.pro first
+LIBS += -L../engine -lengine -lpthread
+PRE_TARGETDEPS += ../engine/libengine.a
+
+# Input
+HEADERS += server.h
+SOURCES += main.cpp server.cpp
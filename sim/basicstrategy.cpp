@@ -0,0 +1,128 @@
+#include "basicstrategy.h"
+
+/**
+ * Helper function that decides whether to split a pair.
+ * @param pair Points of one card of the pair, 11 for Aces
+ * @param up Points of the dealer's upcard, 11 for an Ace
+ * @param doubleAfterSplit Split hands may be doubled, which makes small pairs worth splitting
+ * @return true: split
+ */
+static bool splitPair(int pair, int up, bool doubleAfterSplit)
+{
+	switch(pair)
+	{
+	case 11: return true;
+	case 10: return false;
+	case 9:  return up <= 9 && up != 7;
+	case 8:  return true;
+	case 7:  return up <= 7;
+	case 6:  return up >= (doubleAfterSplit ? 2 : 3) && up <= 6;
+	case 5:  return false;
+	case 4:  return doubleAfterSplit && (up == 5 || up == 6);
+	default: return up >= (doubleAfterSplit ? 2 : 4) && up <= 7;
+	}
+}
+
+/**
+ * Helper function that decides whether to double a soft total.
+ * @param score Soft total, 13 to 21
+ * @param up Points of the dealer's upcard, 11 for an Ace
+ * @param hitSoft17 The dealer hits soft 17
+ * @return true: double
+ */
+static bool doubleSoft(int score, int up, bool hitSoft17)
+{
+	switch(score)
+	{
+	case 13: case 14: return up == 5 || up == 6;
+	case 15: case 16: return up >= 4 && up <= 6;
+	case 17:          return up >= 3 && up <= 6;
+	case 18:          return up >= (hitSoft17 ? 2 : 3) && up <= 6;
+	case 19:          return hitSoft17 && up == 6;
+	default:          return false;
+	}
+}
+
+/**
+ * Helper function that decides whether to double a hard total.
+ * @param score Hard total
+ * @param up Points of the dealer's upcard, 11 for an Ace
+ * @param hitSoft17 The dealer hits soft 17
+ * @return true: double
+ */
+static bool doubleHard(int score, int up, bool hitSoft17)
+{
+	switch(score)
+	{
+	case 9:  return up >= 3 && up <= 6;
+	case 10: return up <= 9;
+	case 11: return up <= 10 || hitSoft17;
+	default: return false;
+	}
+}
+
+/**
+ * Helper function that decides whether to stand on a total.
+ * @param score The player's total
+ * @param soft The total counts an Ace as 11
+ * @param up Points of the dealer's upcard, 11 for an Ace
+ * @return true: stand; false: hit
+ */
+static bool standOn(int score, bool soft, int up)
+{
+	if(soft)
+	{
+		return score >= 19 || (score == 18 && up <= 8);
+	}
+	if(score >= 17) return true;
+	if(score >= 13) return up <= 6;
+	if(score == 12) return up >= 4 && up <= 6;
+	return false;
+}
+
+/**
+ * Function that returns the basic strategy action for the current hand.
+ * This is the multi-deck chart with late surrender, doubling on any two 
+ * cards and the few plays that change when the dealer hits soft 17. The 
+ * dealer is assumed to have checked for Blackjack already, and insurance 
+ * is never taken.
+ * @param round The round, with the player to act on the current hand
+ * @param rules Rules of the variant played
+ * @param mayRaise The player can afford to double or split; if not, the 
+ * hand is played as if neither were allowed
+ * @return The action to take
+ */
+engine::Action basicStrategy(const engine::Round &round, const StrategyRules &rules, 
+                             bool mayRaise)
+{
+	const engine::Hand &hand = round.player(round.current());
+	int up = round.upcard().isAce() ? 11 : round.upcard().points();
+	int pair = hand.card(0).isAce() ? 11 : hand.card(0).points();
+	int score = hand.score();
+	bool soft = hand.isSoft();
+	
+	if(!round.canHit())
+	{
+		return engine::Stand;
+	}
+	
+	if(mayRaise && round.canSplit(rules.resplitAces) && splitPair(pair, up, rules.doubleAfterSplit))
+	{
+		return engine::Split;
+	}
+	
+	if(round.canSurrender(rules.lateSurrender) && !soft && 
+	   ((score == 16 && up >= 9) || (score == 15 && up == 10) || 
+	    (rules.hitSoft17 && up == 11 && (score == 15 || score == 17))))
+	{
+		return engine::Surrender;
+	}
+	
+	if(mayRaise && round.canDouble(rules.doubleAfterSplit) && 
+	   (soft ? doubleSoft(score, up, rules.hitSoft17) : doubleHard(score, up, rules.hitSoft17)))
+	{
+		return engine::DoubleDown;
+	}
+	
+	return standOn(score, soft, up) ? engine::Stand : engine::Hit;
+}
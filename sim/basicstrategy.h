@@ -0,0 +1,35 @@
+#ifndef BASICSTRATEGY_H
+#define BASICSTRATEGY_H
+
+#include "engine/round.h"
+
+/**
+ * Struct that holds the rules basic strategy depends on.
+ */
+struct StrategyRules
+{
+	bool hitSoft17;        /**< dealer hits soft 17. */
+	bool doubleAfterSplit; /**< double after split allowed. */
+	bool resplitAces;      /**< resplitting Aces allowed. */
+	bool lateSurrender;    /**< late surrender allowed. */
+};
+
+engine::Action basicStrategy(const engine::Round &round, const StrategyRules &rules, 
+                             bool mayRaise = true);
+
+/**
+ * Function that returns the basic strategy action under a variant's rules.
+ * @tparam Rules RuleSet of the variant played
+ * @param round The round, with the player to act on the current hand
+ * @param mayRaise The player can afford to double or split
+ * @return The action to take
+ */
+template<class Rules>
+engine::Action basicStrategy(const engine::Round &round, bool mayRaise = true)
+{
+	static const StrategyRules rules = {Rules::HitSoft17, Rules::DoubleAfterSplit, 
+	                                    Rules::ResplitAces, Rules::LateSurrender};
+	return basicStrategy(round, rules, mayRaise);
+}
+
+#endif
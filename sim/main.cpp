@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <chrono>
+#include <thread>
+#include "simulator.h"
+
+/**
+ * Helper function that prints the command line usage.
+ */
+static void usage(const char *prog)
+{
+	fprintf(stderr, 
+	        "Usage: %s [-n rounds] [-t threads] [-s seed] [-p standOn] [-r rules] [-d decks] [-c penetration] [-l dir] [-k] [-b]\n"
+	        "  -n  number of rounds to play (default 1000000)\n"
+	        "  -t  number of worker threads (default: all cores)\n"
+	        "  -s  random seed (default: current time)\n"
+	        "  -p  player hits until reaching this score (default 17)\n"
+	        "  -r  rules played: house, strip, downtown, atlantic or 6to5 (default house)\n"
+	        "  -d  number of decks in the shoe, 1 to 8 (default: as the rules say)\n"
+	        "  -c  fraction of the shoe dealt before reshuffling (default 0.8)\n"
+	        "  -l  write a hand history file per worker thread into this directory\n"
+	        "  -k  print the house edge at each Hi-Lo true count\n"
+	        "  -b  play basic strategy with doubles, splits and surrender instead of -p\n", 
+	        prog);
+}
+
+int main(int argc, char *argv[])
+{
+	uint64_t rounds = 1000000;
+	int numThreads = std::thread::hardware_concurrency();
+	uint64_t seed = time(0);
+	int standOn = 17;
+	int variant = engine::HouseVariant;
+	int numDecks = 0;
+	double penetration = engine::Shoe::DefaultPenetration;
+	const char *logDir = 0;
+	bool byCount = false;
+	bool basic = false;
+	int opt;
+	
+	while((opt = getopt(argc, argv, "n:t:s:p:r:d:c:l:kbh")) != -1)
+	{
+		switch(opt)
+		{
+		case 'n': rounds = strtoull(optarg, 0, 10); break;
+		case 't': numThreads = atoi(optarg); break;
+		case 's': seed = strtoull(optarg, 0, 10); break;
+		case 'p': standOn = atoi(optarg); break;
+		case 'r': variant = engine::findVariant(optarg); break;
+		case 'd': numDecks = atoi(optarg); break;
+		case 'c': penetration = atof(optarg); break;
+		case 'l': logDir = optarg; break;
+		case 'k': byCount = true; break;
+		case 'b': basic = true; break;
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	
+	if(numThreads < 1) numThreads = 1;
+	if(variant < 0)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+	if(numDecks == 0)
+	{
+		numDecks = engine::Variants[variant].numDecks;
+	}
+	
+	Simulator simulator(standOn, variant, numDecks, penetration);
+	simulator.setBasicStrategy(basic);
+	if(logDir != 0)
+	{
+		simulator.setLogDirectory(logDir);
+	}
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	SimResult result = simulator.run(rounds, numThreads, seed);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	
+	double n = result.rounds > 0 ? static_cast<double>(result.rounds) : 1.0;
+	printf("rounds        %llu\n", static_cast<unsigned long long>(result.rounds));
+	printf("threads       %d\n", numThreads);
+	printf("rules         %s\n", engine::Variants[variant].name);
+	printf("decks         %d\n", numDecks);
+	printf("seed          %llu\n", static_cast<unsigned long long>(seed));
+	printf("player wins   %.4f%%\n", 100.0 * result.playerWins / n);
+	printf("dealer wins   %.4f%%\n", 100.0 * result.dealerWins / n);
+	printf("pushes        %.4f%%\n", 100.0 * result.pushes / n);
+	printf("blackjacks    %.4f%%\n", 100.0 * result.playerBlackjacks / n);
+	if(basic)
+	{
+		printf("doubles       %.4f%%\n", 100.0 * result.doubles / n);
+		printf("splits        %.4f%%\n", 100.0 * result.splits / n);
+		printf("surrenders    %.4f%%\n", 100.0 * result.surrenders / n);
+	}
+	printf("house edge    %.4f%% +/- %.4f%%\n", 100.0 * result.houseEdge(), 
+	                                          100.0 * result.standardError());
+	printf("rounds/sec    %.0f\n", seconds > 0 ? result.rounds / seconds : 0.0);
+	
+	if(byCount)
+	{
+		printf("\ntrue count    rounds     house edge\n");
+		for(int tc = SimResult::MinTrueCount; tc <= SimResult::MaxTrueCount; ++tc)
+		{
+			uint64_t played = result.countRounds[tc - SimResult::MinTrueCount];
+			printf("%+4d%s     %10.4f%%  %9.4f%%\n", tc, 
+			       tc == SimResult::MinTrueCount || tc == SimResult::MaxTrueCount ? "*" : " ", 
+			       100.0 * played / n, 100.0 * result.houseEdgeAt(tc));
+		}
+		printf("* includes the counts beyond\n");
+	}
+	
+	return 0;
+}
@@ -0,0 +1,19 @@
+######################################################################
+# Command line Monte Carlo simulator - no Qt dependency
+######################################################################
+
+TEMPLATE = app
+CONFIG += console thread
+CONFIG -= qt app_bundle
+TARGET = blackjack-sim
+DEPENDPATH += .
+INCLUDEPATH += . ..
+QMAKE_CXXFLAGS += -std=c++11
+
+# Game engine static library - build ../engine/engine.pro first
+LIBS += -L../engine -lengine -lpthread
+PRE_TARGETDEPS += ../engine/libengine.a
+
+# Input
+HEADERS += basicstrategy.h simulator.h
+SOURCES += basicstrategy.cpp main.cpp simulator.cpp
@@ -0,0 +1,282 @@
+#include <math.h>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+#include "engine/handlog.h"
+#include "engine/round.h"
+#include "basicstrategy.h"
+#include "simulator.h"
+
+/**
+ * The SimResult struct constructor.
+ * All tallies start at zero.
+ */
+SimResult::SimResult() : rounds(0), playerWins(0), dealerWins(0), pushes(0), doubles(0), 
+                         splits(0), surrenders(0), playerBlackjacks(0), net(0.0), netSquares(0.0)
+{
+	for(int i = 0; i < NumTrueCounts; ++i)
+	{
+		countRounds[i] = 0;
+		countNet[i] = 0;
+	}
+}
+
+/**
+ * Member function that adds another tally to this one.
+ * @param other Tally to be added
+ */
+void SimResult::merge(const SimResult &other)
+{
+	rounds += other.rounds;
+	playerWins += other.playerWins;
+	dealerWins += other.dealerWins;
+	pushes += other.pushes;
+	doubles += other.doubles;
+	splits += other.splits;
+	surrenders += other.surrenders;
+	playerBlackjacks += other.playerBlackjacks;
+	net += other.net;
+	netSquares += other.netSquares;
+	for(int i = 0; i < NumTrueCounts; ++i)
+	{
+		countRounds[i] += other.countRounds[i];
+		countNet[i] += other.countNet[i];
+	}
+}
+
+/**
+ * Member function that returns the house edge.
+ * @return Expected loss of the player per unit bet
+ */
+double SimResult::houseEdge() const
+{
+	if(rounds == 0) return 0.0;
+	return -net / rounds;
+}
+
+/**
+ * Member function that returns the standard error of the house edge.
+ * @return Standard error of houseEdge()
+ */
+double SimResult::standardError() const
+{
+	if(rounds < 2) return 0.0;
+	double meanSq = netSquares / rounds;
+	double mean = houseEdge();
+	return sqrt((meanSq - mean * mean) / (rounds - 1));
+}
+
+/**
+ * Member function that returns the house edge at one true count.
+ * The true count is the Hi-Lo count before the round's first card, 
+ * rounded down and clamped to MinTrueCount to MaxTrueCount.
+ * @param trueCount The true count
+ * @return Expected loss of the player per unit bet at that count
+ */
+double SimResult::houseEdgeAt(int trueCount) const
+{
+	int i = trueCount - MinTrueCount;
+	if(i < 0 || i >= NumTrueCounts || countRounds[i] == 0) return 0.0;
+	return -countNet[i] / countRounds[i];
+}
+
+/**
+ * The Simulator class constructor.
+ * @param standOn The player hits until his score reaches this value
+ * @param variant Rules played, an engine::VariantId
+ * @param numDecks Number of decks in each worker's shoe, 0 for the variant's
+ * @param penetration Fraction of the shoe dealt before reshuffling
+ */
+Simulator::Simulator(int standOn, int variant, int numDecks, double penetration) : 
+m_standOn(standOn), m_variant(variant), m_numDecks(numDecks), m_penetration(penetration), 
+m_basicStrategy(false)
+{}
+
+/**
+ * Struct that picks the worker body specialized for a variant.
+ */
+struct Simulator::WorkPicker
+{
+	typedef WorkFunction Result;
+	
+	template<class Rules>
+	Result visit() {return &Simulator::work<Rules>;}
+};
+
+/**
+ * Member function that runs the simulation.
+ * @param rounds Total number of rounds to play
+ * @param numThreads Number of worker threads, at least 1
+ * @param seed Seed of the simulation; worker i gets the stream that starts 
+ * i jumps of 2^128 steps after it
+ * @return Merged tally of all workers
+ */
+SimResult Simulator::run(uint64_t rounds, int numThreads, uint64_t seed) const
+{
+	if(numThreads < 1) numThreads = 1;
+	
+	std::vector<SimResult> results(numThreads);
+	std::vector<std::thread> workers;
+	engine::Rng rng(seed);
+	WorkPicker picker;
+	WorkFunction work = engine::visitVariant(m_variant, picker);
+	
+	for(int i = 0; i < numThreads; ++i)
+	{
+		// Spread the remainder over the first workers
+		uint64_t share = rounds / numThreads + (static_cast<uint64_t>(i) < rounds % numThreads ? 1 : 0);
+		workers.push_back(std::thread(work, this, share, rng, seed, i, &results[i]));
+		rng.jump();
+	}
+	
+	SimResult total;
+	for(int i = 0; i < numThreads; ++i)
+	{
+		workers[i].join();
+		total.merge(results[i]);
+	}
+	
+	return total;
+}
+
+/**
+ * Helper function that plays the player's hands by basic strategy.
+ * @param round The round, just dealt
+ * @tparam Rules RuleSet of the variant played
+ */
+template<class Rules>
+void Simulator::play(engine::Round &round)
+{
+	while(!round.done())
+	{
+		switch(basicStrategy<Rules>(round))
+		{
+		case engine::Hit:        round.hit(); break;
+		case engine::DoubleDown: round.doubleDown(); break;
+		case engine::Split:      round.split(); break;
+		case engine::Surrender:  round.surrender(); break;
+		default:                 round.next(); break;
+		}
+	}
+}
+
+/**
+ * Worker thread body.
+ * The tally is kept on the worker's own stack and written out once at 
+ * the end, so workers never share a cache line while playing.
+ * @param rounds Number of rounds to play
+ * @param rng The worker's own random number stream
+ * @param seed Seed of the simulation, for the hand history header
+ * @param stream Index of the worker, i.e. jumps applied to rng
+ * @param result Where to store the worker's tally
+ * @tparam Rules RuleSet of the variant played
+ */
+template<class Rules>
+void Simulator::work(uint64_t rounds, engine::Rng rng, uint64_t seed, int stream, 
+                     SimResult *result) const
+{
+	// Bets are in units that keep half a bet and a Blackjack payout whole; 
+	// the hand history bets the same
+	const int unit = 2 * Rules::BlackjackDen;
+	
+	engine::Shoe shoe(m_numDecks > 0 ? m_numDecks : Rules::NumDecks, m_penetration);
+	engine::Round round(shoe, rng);
+	engine::HandLogWriter log;
+	engine::HandRecord record;
+	SimResult tally;
+	int64_t net = 0;
+	
+	if(!m_logDir.empty())
+	{
+		char path[4096];
+		snprintf(path, sizeof(path), "%s/sim-%llu-%d.bjhl", m_logDir.c_str(), 
+		         static_cast<unsigned long long>(seed), stream);
+		if(!log.open(path, seed, stream, shoe.numDecks(), shoe.penetration(), m_variant))
+		{
+			fprintf(stderr, "cannot open hand history %s\n", path);
+		}
+	}
+	
+	shoe.shuffle(rng);
+	
+	for(uint64_t i = 0; i < rounds; ++i)
+	{
+		// The Hi-Lo true count the round is played at; a due reshuffle 
+		// starts it over at 0
+		int trueCount = shoe.needsShuffle() ? 0 : static_cast<int>(floor(shoe.trueCount()));
+		if(trueCount < SimResult::MinTrueCount) trueCount = SimResult::MinTrueCount;
+		if(trueCount > SimResult::MaxTrueCount) trueCount = SimResult::MaxTrueCount;
+		int bucket = trueCount - SimResult::MinTrueCount;
+		
+		round.deal();
+		uint32_t shoeId = shoe.shuffleCount();
+		
+		if(round.player().isBlackjack())
+		{
+			++tally.playerBlackjacks;
+		}
+		
+		if(!m_basicStrategy)
+		{
+			while(round.player().score() < m_standOn)
+			{
+				round.hit();
+			}
+		}
+		// The dealer checks for Blackjack under an Ace or a ten, so the 
+		// player only acts when he has none
+		else if(!round.dealer().isBlackjack())
+		{
+			play<Rules>(round);
+		}
+		
+		engine::Outcome outcome = round.stand<Rules>();
+		int won = round.net<Rules>(unit);
+		double payoff = static_cast<double>(won) / unit;
+		net += won;
+		
+		for(int h = 0; h < round.numHands(); ++h)
+		{
+			if(round.isDoubled(h))
+			{
+				++tally.doubles;
+				break;
+			}
+		}
+		if(round.numHands() > 1)
+		{
+			++tally.splits;
+		}
+		if(round.isSurrendered(0))
+		{
+			++tally.surrenders;
+		}
+		
+		if(won > 0)
+		{
+			++tally.playerWins;
+		}
+		else if(won < 0)
+		{
+			++tally.dealerWins;
+		}
+		else
+		{
+			++tally.pushes;
+		}
+		
+		tally.net += payoff;
+		tally.netSquares += payoff * payoff;
+		tally.countNet[bucket] += payoff;
+		++tally.countRounds[bucket];
+		
+		if(log.isOpen())
+		{
+			record.set(shoeId, static_cast<uint32_t>(i), unit, net, outcome, round);
+			log.append(record);
+		}
+	}
+	
+	tally.rounds = rounds;
+	*result = tally;
+}
@@ -0,0 +1,96 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include <stdint.h>
+#include <string>
+#include "engine/rng.h"
+#include "engine/round.h"
+#include "engine/ruleset.h"
+#include "engine/shoe.h"
+
+/**
+ * Struct that holds the tally of simulated rounds.
+ * Every round is played for a flat bet of one unit; a Blackjack may pay 
+ * a fraction more depending on the variant, and doubles and splits put 
+ * more units on the table. Wins, losses and pushes count rounds by 
+ * whether they paid the player, cost him or neither.
+ */
+struct SimResult
+{
+	uint64_t rounds;           /**< rounds played. */
+	uint64_t playerWins;       /**< rounds won by the player. */
+	uint64_t dealerWins;       /**< rounds won by the dealer. */
+	uint64_t pushes;           /**< rounds nobody won. */
+	uint64_t doubles;          /**< rounds with at least one hand doubled. */
+	uint64_t splits;           /**< rounds the player split. */
+	uint64_t surrenders;       /**< rounds the player surrendered. */
+	uint64_t playerBlackjacks; /**< rounds the player was dealt a Blackjack. */
+	double net;                /**< units won by the player. */
+	double netSquares;         /**< sum of the squared result of each round. */
+	
+	static const int MinTrueCount = -5;                               /**< lowest Hi-Lo true count bucket. */
+	static const int MaxTrueCount = 5;                                /**< highest Hi-Lo true count bucket. */
+	static const int NumTrueCounts = MaxTrueCount - MinTrueCount + 1; /**< true count buckets. */
+	
+	uint64_t countRounds[NumTrueCounts]; /**< rounds played at each Hi-Lo true count. */
+	double countNet[NumTrueCounts];      /**< units won by the player at each Hi-Lo true count. */
+	
+	SimResult();
+	
+	void merge(const SimResult &other);
+	double houseEdge() const;
+	double standardError() const;
+	double houseEdgeAt(int trueCount) const;
+};
+
+/**
+ * Class that runs a Monte Carlo simulation of the game.
+ * Rounds are spread over worker threads, each of which has its own random 
+ * number generator and shoe, and only touches shared state once its share 
+ * of rounds is done.
+ */
+class Simulator
+{
+public:
+	Simulator(int standOn = 17, int variant = engine::HouseVariant, int numDecks = 0, 
+	          double penetration = engine::Shoe::DefaultPenetration);
+	
+	SimResult run(uint64_t rounds, int numThreads, uint64_t seed) const;
+	
+	/**
+	 * Member function that turns on hand history logging.
+	 * Worker i writes every round to DIR/sim-SEED-i.bjhl.
+	 * @param dir Directory the files are written to, empty for no logging
+	 */
+	void setLogDirectory(const std::string &dir) {m_logDir = dir;}
+	
+	/**
+	 * Member function that makes the player follow basic strategy.
+	 * He then doubles, splits and surrenders as the chart says instead of 
+	 * hitting to standOn.
+	 * @param on true: play basic strategy; false: hit to standOn
+	 */
+	void setBasicStrategy(bool on) {m_basicStrategy = on;}
+	
+private:
+	typedef void (Simulator::*WorkFunction)(uint64_t rounds, engine::Rng rng, uint64_t seed, 
+	                                        int stream, SimResult *result) const;
+	struct WorkPicker;
+	
+	template<class Rules>
+	static void play(engine::Round &round);
+	
+	template<class Rules>
+	void work(uint64_t rounds, engine::Rng rng, uint64_t seed, int stream, 
+	          SimResult *result) const;
+	
+private:
+	int m_standOn;
+	int m_variant;
+	int m_numDecks;
+	double m_penetration;
+	bool m_basicStrategy;
+	std::string m_logDir;
+};
+
+#endif
@@ -0,0 +1,111 @@
+#include <thread>
+#include <vector>
+#include "engine/dealerodds.h"
+#include "engine/playerodds.h"
+#include "generator.h"
+
+/**
+ * The StrategyGenerator class constructor.
+ * @param numDecks Number of decks in the shoe
+ * @param variant Rules played, an engine::VariantId
+ */
+StrategyGenerator::StrategyGenerator(int numDecks, int variant) : m_numDecks(numDecks), m_variant(variant), 
+m_nextCell(0)
+{}
+
+/**
+ * Member function that fills in every cell of a table.
+ * @param table Table to fill in
+ * @param numThreads Number of worker threads, at least 1
+ */
+void StrategyGenerator::run(engine::StrategyTable &table, int numThreads)
+{
+	if(numThreads < 1) numThreads = 1;
+	
+	std::vector<std::thread> workers;
+	m_nextCell = 0;
+	
+	for(int i = 0; i < numThreads; ++i)
+	{
+		workers.push_back(std::thread(&StrategyGenerator::work, this, &table));
+	}
+	
+	for(int i = 0; i < numThreads; ++i)
+	{
+		workers[i].join();
+	}
+}
+
+/**
+ * Worker thread body.
+ * @param table Table to fill in
+ */
+void StrategyGenerator::work(engine::StrategyTable *table)
+{
+	using engine::Composition;
+	using engine::StrategyTable;
+	
+	engine::DealerOdds dealer;
+	engine::PlayerOdds player(dealer, m_variant);
+	int cell;
+	
+	while((cell = m_nextCell++) < StrategyTable::NumCells)
+	{
+		int row = cell / StrategyTable::NumUpcards;
+		int upcard = cell % StrategyTable::NumUpcards;
+		bool soft = row >= StrategyTable::NumHardRows;
+		int total = soft ? StrategyTable::MinSoft + row - StrategyTable::NumHardRows 
+		                 : StrategyTable::MinHard + row;
+		
+		Composition shoe(m_numDecks);
+		shoe.remove(upcard);
+		
+		double weight = 0.0;
+		double evStand = 0.0;
+		double evHit = 0.0;
+		
+		// Every pair of value indices i <= j that makes the total: soft 
+		// totals hold exactly one Ace counted as 11 (or two for soft 12), 
+		// hard totals hold no Ace at all
+		for(int i = 0; i < Composition::NumValues; ++i)
+		{
+			for(int j = i; j < Composition::NumValues; ++j)
+			{
+				int hardTotal = i + j + 2;
+				bool pairIsSoft = (i == 0);
+				
+				if(pairIsSoft != soft || hardTotal + (soft ? 10 : 0) != total)
+				{
+					continue;
+				}
+				
+				int n = shoe.total();
+				double p = static_cast<double>(shoe.count(i)) / n;
+				shoe.remove(i);
+				p *= static_cast<double>(shoe.count(j)) / (n - 1);
+				if(i != j) p *= 2.0;
+				
+				if(p > 0.0)
+				{
+					shoe.remove(j);
+					engine::ActionEv ev = player.evaluate(hardTotal, (i == 0) + (j == 0), 2, 
+					                                      upcard, shoe);
+					shoe.add(j);
+					
+					weight += p;
+					evStand += p * ev.stand;
+					evHit += p * ev.hit;
+				}
+				shoe.add(i);
+			}
+		}
+		
+		StrategyTable::Cell &c = table->cell(row, upcard);
+		if(weight > 0.0)
+		{
+			c.evStand = static_cast<float>(evStand / weight);
+			c.evHit = static_cast<float>(evHit / weight);
+		}
+		c.action = c.evHit > c.evStand ? StrategyTable::Hit : StrategyTable::Stand;
+	}
+}
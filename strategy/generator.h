@@ -0,0 +1,32 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <atomic>
+#include "engine/ruleset.h"
+#include "engine/strategytable.h"
+
+/**
+ * Class that computes a basic strategy table.
+ * Each cell is the probability-weighted average, over every two card 
+ * hand that makes its total, of the exact EV of hitting and standing 
+ * against the upcard from a full shoe, under the rules of one variant. 
+ * Cells are handed out to worker threads through an atomic counter; each 
+ * worker has its own odds calculators and writes only its own cells.
+ */
+class StrategyGenerator
+{
+public:
+	explicit StrategyGenerator(int numDecks = 1, int variant = engine::HouseVariant);
+	
+	void run(engine::StrategyTable &table, int numThreads);
+	
+private:
+	void work(engine::StrategyTable *table);
+	
+private:
+	int m_numDecks;
+	int m_variant;
+	std::atomic<int> m_nextCell;
+};
+
+#endif
@@ -0,0 +1,79 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include <thread>
+#include "generator.h"
+
+/**
+ * Helper function that prints the command line usage.
+ */
+static void usage(const char *prog)
+{
+	fprintf(stderr, 
+	        "Usage: %s [-r rules] [-d decks] [-t threads] [-o file] [-v]\n"
+	        "  -r  rules played: house, strip, downtown, atlantic or 6to5 (default house)\n"
+	        "  -d  number of decks in the shoe, 1 to 8 (default: as the rules say)\n"
+	        "  -t  number of worker threads (default: all cores)\n"
+	        "  -o  write the binary table to this file\n"
+	        "  -v  print the EV of both actions under each row\n", 
+	        prog);
+}
+
+int main(int argc, char *argv[])
+{
+	int variant = engine::HouseVariant;
+	int numDecks = 0;
+	int numThreads = std::thread::hardware_concurrency();
+	const char *output = 0;
+	bool verbose = false;
+	int opt;
+	
+	while((opt = getopt(argc, argv, "r:d:t:o:vh")) != -1)
+	{
+		switch(opt)
+		{
+		case 'r': variant = engine::findVariant(optarg); break;
+		case 'd': numDecks = atoi(optarg); break;
+		case 't': numThreads = atoi(optarg); break;
+		case 'o': output = optarg; break;
+		case 'v': verbose = true; break;
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	
+	if(variant < 0)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+	if(numDecks == 0)
+	{
+		numDecks = engine::Variants[variant].numDecks;
+	}
+	if(numDecks < 1 || numDecks > 8)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+	
+	engine::StrategyTable table(numDecks, variant);
+	StrategyGenerator generator(numDecks, variant);
+	
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	generator.run(table, numThreads);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	
+	table.dump(stdout, verbose);
+	fprintf(stderr, "computed %d cells in %.2f s\n", engine::StrategyTable::NumCells, seconds);
+	
+	if(output != 0 && !table.save(output))
+	{
+		fprintf(stderr, "cannot write %s\n", output);
+		return 1;
+	}
+	
+	return 0;
+}
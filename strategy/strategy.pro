@@ -0,0 +1,19 @@
+######################################################################
+# Command line basic strategy generator - no Qt dependency
+######################################################################
+
+TEMPLATE = app
+CONFIG += console thread
+CONFIG -= qt app_bundle
+TARGET = blackjack-strategy
+DEPENDPATH += .
+INCLUDEPATH += . ..
+QMAKE_CXXFLAGS += -std=c++11
+
+# Game engine static library - build ../engine/engine.pro first
+LIBS += -L../engine -lengine -lpthread
+PRE_TARGETDEPS += ../engine/libengine.a
+
+# Input
+HEADERS += generator.h
+SOURCES += generator.cpp main.cpp
@@ -0,0 +1,31 @@
+#include <stdio.h>
+#include "check.h"
+
+static int failures = 0;
+
+/**
+ * Function that records the result of one check.
+ * @param condition Result of the check
+ * @param text The condition as written
+ * @param file Source file of the check
+ * @param line Source line of the check
+ * @return condition
+ */
+bool check(bool condition, const char *text, const char *file, int line)
+{
+	if(!condition)
+	{
+		fprintf(stderr, "%s:%d: check failed: %s\n", file, line, text);
+		++failures;
+	}
+	return condition;
+}
+
+/**
+ * Function that returns the number of failed checks so far.
+ * @return Number of failed checks
+ */
+int checkFailures()
+{
+	return failures;
+}
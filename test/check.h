@@ -0,0 +1,25 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+bool check(bool condition, const char *text, const char *file, int line);
+int checkFailures();
+
+/**
+ * Macro that checks a condition and reports it with its source line when 
+ * it does not hold. The test goes on either way.
+ */
+#define CHECK(condition) check((condition), #condition, __FILE__, __LINE__)
+
+// The tests, one per engine module, run in this order by main()
+void testDealerOdds();
+void testHandBatch();
+void testHandLog();
+void testJournal();
+void testPlayerOdds();
+void testProtocol();
+void testRound();
+void testRuleSet();
+void testSessionStats();
+void testSimulator();
+
+#endif
@@ -0,0 +1,106 @@
+#include <math.h>
+#include "engine/dealerodds.h"
+#include "check.h"
+
+using engine::Composition;
+using engine::DealerDistribution;
+
+static const double Tolerance = 1e-12;
+
+/**
+ * Helper function that plays out the dealer's hand by plain recursion, 
+ * without DealerOdds' cache, to check it against.
+ * @param prob Probability of reaching this hand
+ * @param result Distribution the final hands are added to
+ */
+static void play(int hardTotal, int numAces, int numCards, bool hitSoft17, double prob, 
+                 Composition &shoe, DealerDistribution &result)
+{
+	bool soft = numAces != 0 && hardTotal <= 11;
+	int score = hardTotal + (soft ? 10 : 0);
+	
+	if(score > 21)
+	{
+		result.p[DealerDistribution::Bust] += prob;
+		return;
+	}
+	if(numCards == 2 && score == 21)
+	{
+		result.p[DealerDistribution::Blackjack] += prob;
+		return;
+	}
+	if(score > 17 || (score == 17 && !(hitSoft17 && soft)))
+	{
+		result.p[score - 17] += prob;
+		return;
+	}
+	
+	int total = shoe.total();
+	for(int i = 0; i < Composition::NumValues; ++i)
+	{
+		int count = shoe.count(i);
+		if(count == 0)
+		{
+			continue;
+		}
+		shoe.remove(i);
+		play(hardTotal + i + 1, numAces + (i == 0), numCards + 1, hitSoft17, 
+		     prob * count / total, shoe, result);
+		shoe.add(i);
+	}
+}
+
+/**
+ * Function that checks that every dealer distribution sums to 1, that a 
+ * Blackjack is exactly as likely as the hole card that makes it, and that 
+ * the cached distributions match a plain recursion on a depleted deck.
+ */
+void testDealerOdds()
+{
+	for(int h17 = 0; h17 < 2; ++h17)
+	{
+		engine::DealerOdds odds(h17 != 0);
+		
+		for(int decks = 1; decks <= 8; decks += 7)
+		{
+			for(int upcard = 0; upcard < Composition::NumValues; ++upcard)
+			{
+				Composition shoe(decks);
+				shoe.remove(upcard);
+				
+				const DealerDistribution &d = odds.distribution(upcard, shoe);
+				double sum = 0.0;
+				for(int f = 0; f < DealerDistribution::NumFinals; ++f)
+				{
+					CHECK(d.p[f] >= 0.0);
+					sum += d.p[f];
+				}
+				CHECK(fabs(sum - 1.0) < Tolerance);
+				
+				int hole = upcard == 0 ? Composition::TenIndex : upcard == Composition::TenIndex ? 0 : -1;
+				double blackjack = hole < 0 ? 0.0 : static_cast<double>(shoe.count(hole)) / shoe.total();
+				CHECK(fabs(d.p[DealerDistribution::Blackjack] - blackjack) < Tolerance);
+			}
+		}
+		
+		// One deck with a few cards gone, so the counts are uneven
+		Composition shoe(1);
+		shoe.remove(Composition::TenIndex);
+		shoe.remove(Composition::TenIndex);
+		shoe.remove(4);
+		shoe.remove(0);
+		for(int upcard = 0; upcard < Composition::NumValues; ++upcard)
+		{
+			shoe.remove(upcard);
+			DealerDistribution expected = {{0.0}};
+			play(upcard + 1, upcard == 0, 1, h17 != 0, 1.0, shoe, expected);
+			
+			const DealerDistribution &d = odds.distribution(upcard, shoe);
+			for(int f = 0; f < DealerDistribution::NumFinals; ++f)
+			{
+				CHECK(fabs(d.p[f] - expected.p[f]) < Tolerance);
+			}
+			shoe.add(upcard);
+		}
+	}
+}
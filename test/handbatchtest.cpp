@@ -0,0 +1,128 @@
+#include <stdint.h>
+#include <vector>
+#include "engine/handbatch.h"
+#include "engine/ruleset.h"
+#include "check.h"
+
+using engine::Card;
+
+// Wagers run over the whole range HandBatch::setWager() allows, a block 
+// at a time; the block size is not a multiple of 8, so the scalar tail 
+// of the vector paths is settled too
+static const int32_t MaxWager = 1 << 22;
+static const size_t BlockSize = 65541;
+
+static const int NumPlayerHands = 7;
+static const int NumDealerHands = 6;
+
+// Ranks of the player's hands: Blackjack, 20, 17, a bust, soft 16, 21
+// in three cards and a pair of Aces
+static const Card::Rank PlayerHands[NumPlayerHands][3] = {
+	{Card::Ace, Card::King, Card::Two}, {Card::King, Card::Queen, Card::Two},
+	{Card::King, Card::Seven, Card::Two}, {Card::King, Card::Six, Card::Nine},
+	{Card::Ace, Card::Five, Card::Two}, {Card::Five, Card::Six, Card::King},
+	{Card::Ace, Card::Ace, Card::Two}
+};
+static const int PlayerCards[NumPlayerHands] = {2, 2, 2, 3, 2, 3, 2};
+
+// Ranks of the dealer's hands: Blackjack, 17, 20, a bust, soft 17 and 21 
+// in three cards
+static const Card::Rank DealerHands[NumDealerHands][3] = {
+	{Card::Ace, Card::King, Card::Two}, {Card::King, Card::Seven, Card::Two},
+	{Card::King, Card::Queen, Card::Two}, {Card::King, Card::Six, Card::Nine},
+	{Card::Ace, Card::Six, Card::Two}, {Card::King, Card::Five, Card::Six}
+};
+static const int DealerCards[NumDealerHands] = {2, 2, 2, 3, 2, 3};
+
+/**
+ * Helper function that deals one of the test hands into a batch.
+ */
+static void deal(engine::HandBatch &batch, size_t i, const Card::Rank *ranks, int numCards)
+{
+	for(int c = 0; c < numCards; ++c)
+	{
+		batch.add(i, Card(ranks[c], c & 3));
+	}
+}
+
+/**
+ * Helper function that settles one block at every SimdLevel and checks 
+ * that they all agree.
+ * @return The scalar result
+ */
+static const std::vector<int32_t> &settleAll(const engine::HandBatch &players, 
+                                             const engine::HandBatch &dealers, 
+                                             const engine::BatchRules &rules)
+{
+	static std::vector<int32_t> net[3];
+	int64_t sum[3];
+	
+	for(int level = engine::SimdScalar; level <= engine::SimdAvx2; ++level)
+	{
+		net[level].assign(players.size(), 0);
+		sum[level] = engine::settleBatch(players, dealers, rules, net[level].data(), 
+		                                 static_cast<engine::SimdLevel>(level));
+	}
+	
+	CHECK(net[engine::SimdSse2] == net[engine::SimdScalar]);
+	CHECK(net[engine::SimdAvx2] == net[engine::SimdScalar]);
+	CHECK(sum[engine::SimdSse2] == sum[engine::SimdScalar]);
+	CHECK(sum[engine::SimdAvx2] == sum[engine::SimdScalar]);
+	return net[engine::SimdScalar];
+}
+
+/**
+ * Function that checks settleBatch() against itself at every SimdLevel, 
+ * for every variant and every wager, and checks the Blackjack payout 
+ * against the integer division Round::net() makes.
+ */
+void testHandBatch()
+{
+	engine::HandBatch players(BlockSize);
+	engine::HandBatch dealers(BlockSize);
+	
+	for(int v = 0; v < engine::NumVariants; ++v)
+	{
+		const engine::Variant &variant = engine::Variants[v];
+		engine::BatchRules rules = {variant.bustPush, variant.blackjackNum, variant.blackjackDen};
+		
+		for(int32_t first = 0; first < MaxWager; first += BlockSize)
+		{
+			// Every player hand a Blackjack, so every wager is paid one
+			players.clear();
+			dealers.clear();
+			for(size_t i = 0; i < BlockSize; ++i)
+			{
+				int32_t wager = (first + static_cast<int32_t>(i)) % MaxWager;
+				players.setWager(i, wager);
+				deal(players, i, PlayerHands[0], PlayerCards[0]);
+				int d = i % NumDealerHands;
+				deal(dealers, i, DealerHands[d], DealerCards[d]);
+			}
+			
+			const std::vector<int32_t> &net = settleAll(players, dealers, rules);
+			for(size_t i = 0; i < BlockSize; ++i)
+			{
+				int32_t wager = players.wagers()[i];
+				int32_t expected = i % NumDealerHands == 0 ? 0 : 
+				                   wager * variant.blackjackNum / variant.blackjackDen;
+				if(!CHECK(net[i] == expected))
+				{
+					break;
+				}
+			}
+			
+			// Every pair of player and dealer hands
+			players.clear();
+			dealers.clear();
+			for(size_t i = 0; i < BlockSize; ++i)
+			{
+				int p = i % NumPlayerHands;
+				int d = (i / NumPlayerHands) % NumDealerHands;
+				deal(players, i, PlayerHands[p], PlayerCards[p]);
+				deal(dealers, i, DealerHands[d], DealerCards[d]);
+			}
+			settleAll(players, dealers, rules);
+		}
+	}
+}
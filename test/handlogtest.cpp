@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+#include "engine/handlog.h"
+#include "engine/replay.h"
+#include "engine/ruleset.h"
+#include "check.h"
+
+static const uint64_t Seed = 20131014;
+static const uint32_t Stream = 3;
+static const size_t NumRounds = 10000;
+
+/**
+ * Helper function that plays a round with random legal actions, splits, 
+ * doubles, surrenders and insurance included.
+ * @param round The round, just dealt
+ * @param rules Rules of the variant played
+ * @param chooser Generator the actions are picked with, not the shoe's
+ */
+static void playRandomly(engine::Round &round, const engine::Variant &rules, engine::Rng &chooser)
+{
+	if(round.canInsure() && engine::uniformBelow(chooser, 2) == 0)
+	{
+		round.insure();
+	}
+	if(round.dealer().isBlackjack())
+	{
+		return;
+	}
+	
+	while(!round.done())
+	{
+		switch(engine::uniformBelow(chooser, 5))
+		{
+		case 0:
+			if(round.canSplit(rules.resplitAces))
+			{
+				round.split();
+				break;
+			}
+			// fall through
+		case 1:
+			if(round.canDouble(rules.doubleAfterSplit))
+			{
+				round.doubleDown();
+				break;
+			}
+			// fall through
+		case 2:
+			if(round.canSurrender(rules.lateSurrender))
+			{
+				round.surrender();
+				break;
+			}
+			// fall through
+		case 3:
+			if(round.canHit())
+			{
+				round.hit();
+				break;
+			}
+			// fall through
+		default:
+			round.next();
+			break;
+		}
+	}
+}
+
+/**
+ * Function that writes a session to a hand history, reads it back 
+ * through the memory map and replays it, in order and by seeking.
+ */
+void testHandLog()
+{
+	const int variant = engine::AtlanticCityVariant;
+	const engine::Variant &rules = engine::Variants[variant];
+	char path[64];
+	snprintf(path, sizeof(path), "/tmp/blackjack-test-%d.bjhl", static_cast<int>(getpid()));
+	unlink(path);
+	
+	engine::Rng rng(Seed);
+	for(uint32_t i = 0; i < Stream; ++i)
+	{
+		rng.jump();
+	}
+	engine::Rng chooser(Seed + 1);
+	engine::Shoe shoe(rules.numDecks, 0.75);
+	engine::Round round(shoe, rng);
+	engine::HandLogWriter writer;
+	std::vector<engine::HandRecord> written(NumRounds);
+	int64_t balance = 0;
+	
+	CHECK(writer.open(path, Seed, Stream, shoe.numDecks(), shoe.penetration(), variant));
+	shoe.shuffle(rng);
+	for(size_t i = 0; i < NumRounds; ++i)
+	{
+		round.deal();
+		uint32_t shoeId = shoe.shuffleCount();
+		playRandomly(round, rules, chooser);
+		engine::Outcome outcome = rules.stand(round);
+		balance += rules.net(round, 10);
+		written[i].set(shoeId, static_cast<uint32_t>(i), 10, balance, outcome, round);
+		CHECK(writer.append(written[i]));
+	}
+	writer.close();
+	
+	engine::HandLogReader reader;
+	if(!CHECK(reader.open(path)))
+	{
+		unlink(path);
+		return;
+	}
+	CHECK(reader.header().seed == Seed);
+	CHECK(reader.header().stream == Stream);
+	CHECK(reader.header().numDecks == rules.numDecks);
+	CHECK(reader.header().variant == variant);
+	CHECK(reader.count() == NumRounds);
+	CHECK(memcmp(reader.begin(), written.data(), NumRounds * sizeof(engine::HandRecord)) == 0);
+	
+	engine::Replay replay(reader, 1024);
+	size_t matched = 0;
+	while(replay.step())
+	{
+		++matched;
+	}
+	CHECK(matched == NumRounds);
+	
+	// Back to a round between two checkpoints, then forward again
+	static const size_t Seeks[] = {5000, 17, 9999, 1024};
+	for(size_t s = 0; s < sizeof(Seeks) / sizeof(Seeks[0]); ++s)
+	{
+		CHECK(replay.seek(Seeks[s]));
+		CHECK(replay.step());
+		CHECK(replay.outcome() == written[Seeks[s]].outcome);
+	}
+	CHECK(!replay.seek(NumRounds + 1));
+	reader.close();
+	
+	// A round whose cards or outcome were changed no longer replays; the 
+	// rounds after it still do
+	static const size_t Tampered[] = {4321, 8765};
+	engine::HandRecord changed[2] = {written[Tampered[0]], written[Tampered[1]]};
+	changed[0].dealerCards[0] ^= 1;
+	changed[1].outcome = changed[1].outcome == engine::PlayerWins ? engine::DealerWins : engine::PlayerWins;
+	FILE *file = fopen(path, "r+b");
+	for(int t = 0; t < 2 && CHECK(file != 0); ++t)
+	{
+		fseek(file, static_cast<long>(sizeof(engine::HandLogHeader) + Tampered[t] * sizeof(engine::HandRecord)), SEEK_SET);
+		CHECK(fwrite(&changed[t], sizeof(changed[t]), 1, file) == 1);
+	}
+	if(file != 0)
+	{
+		fclose(file);
+	}
+	CHECK(reader.open(path));
+	engine::Replay tampered(reader, 1024);
+	for(size_t i = 0; i < NumRounds; ++i)
+	{
+		bool expected = i != Tampered[0] && i != Tampered[1];
+		if(!CHECK(tampered.step() == expected))
+		{
+			break;
+		}
+	}
+	CHECK(tampered.seek(Tampered[0]));
+	CHECK(!tampered.step());
+	reader.close();
+	
+	// A record cut short by a crash is not counted
+	CHECK(truncate(path, sizeof(engine::HandLogHeader) + NumRounds * sizeof(engine::HandRecord) - 5) == 0);
+	CHECK(reader.open(path));
+	CHECK(reader.count() == NumRounds - 1);
+	reader.close();
+	unlink(path);
+}
@@ -0,0 +1,89 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include "engine/journal.h"
+#include "check.h"
+
+static const int NumEvents = 1000;
+static const int SyncEvents = 16;
+
+/**
+ * Helper function that flips one byte of a file.
+ */
+static bool corrupt(const char *path, off_t offset)
+{
+	int fd = open(path, O_RDWR);
+	uint8_t byte = 0;
+	bool done = fd >= 0 && pread(fd, &byte, 1, offset) == 1;
+	byte ^= 0x5a;
+	done = done && pwrite(fd, &byte, 1, offset) == 1;
+	if(fd >= 0)
+	{
+		close(fd);
+	}
+	return done;
+}
+
+/**
+ * Function that writes a journal and checks that recovery finds its last 
+ * whole record, also once the file ends in a record cut short or holds 
+ * a damaged one, and that full groups and due events are committed.
+ */
+void testJournal()
+{
+	char path[64];
+	snprintf(path, sizeof(path), "/tmp/blackjack-test-%d.bjj", static_cast<int>(getpid()));
+	unlink(path);
+	
+	engine::JournalRecord last;
+	CHECK(!engine::Journal::recover(path, last));
+	
+	engine::Journal journal;
+	if(!CHECK(journal.open(path, SyncEvents, 60000)))
+	{
+		return;
+	}
+	CHECK(!engine::Journal::recover(path, last));
+	
+	int groups = 0;
+	for(int i = 0; i < NumEvents; ++i)
+	{
+		if(journal.append(engine::JournalSettle, (i & 1) != 0, i, 3 * i, i % 7))
+		{
+			CHECK((i + 1) % SyncEvents == 0);
+			journal.commit();
+			++groups;
+		}
+	}
+	CHECK(groups == NumEvents / SyncEvents);
+	CHECK(journal.deadline() != engine::Journal::Clock::time_point::max());
+	CHECK(!journal.commitDue(engine::Journal::Clock::now()));
+	CHECK(journal.commitDue(journal.deadline()));
+	CHECK(journal.deadline() == engine::Journal::Clock::time_point::max());
+	journal.close();
+	CHECK(!journal.failed());
+	
+	CHECK(engine::Journal::recover(path, last));
+	CHECK(last.sequence == NumEvents - 1);
+	CHECK(last.balance == 3 * (NumEvents - 1) && last.bet == (NumEvents - 1) % 7);
+	CHECK(last.recoveredBalance() == last.balance + last.bet);
+	
+	// The last record cut short by a crash
+	const off_t RecordSize = sizeof(engine::JournalRecord);
+	CHECK(truncate(path, NumEvents * RecordSize - 10) == 0);
+	CHECK(engine::Journal::recover(path, last));
+	CHECK(last.sequence == NumEvents - 2);
+	CHECK(last.balance == 3 * (NumEvents - 2));
+	CHECK(last.recoveredBalance() == last.balance);
+	
+	// A damaged record ends the journal, whatever follows it
+	CHECK(corrupt(path, 500 * RecordSize + 9));
+	CHECK(engine::Journal::recover(path, last));
+	CHECK(last.sequence == 499);
+	
+	// Opening the journal starts it over
+	CHECK(journal.open(path));
+	CHECK(!engine::Journal::recover(path, last));
+	journal.close();
+	unlink(path);
+}
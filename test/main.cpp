@@ -0,0 +1,57 @@
+#include <stdio.h>
+#include <string.h>
+#include "check.h"
+
+/**
+ * Struct that names one test.
+ */
+struct Test
+{
+	const char *name;  /**< name given on the command line. */
+	void (*run)();     /**< function that runs the test. */
+};
+
+static const Test Tests[] = {
+	{"dealerodds", testDealerOdds},
+	{"handbatch", testHandBatch},
+	{"handlog", testHandLog},
+	{"journal", testJournal},
+	{"playerodds", testPlayerOdds},
+	{"protocol", testProtocol},
+	{"round", testRound},
+	{"ruleset", testRuleSet},
+	{"sessionstats", testSessionStats},
+	{"simulator", testSimulator}
+};
+
+int main(int argc, char *argv[])
+{
+	int numTests = sizeof(Tests) / sizeof(Tests[0]);
+	int numRun = 0;
+	
+	for(int t = 0; t < numTests; ++t)
+	{
+		// With no arguments every test runs, otherwise the named ones
+		bool selected = argc < 2;
+		for(int a = 1; a < argc; ++a)
+		{
+			selected = selected || strcmp(argv[a], Tests[t].name) == 0;
+		}
+		if(!selected)
+		{
+			continue;
+		}
+		
+		int failures = checkFailures();
+		Tests[t].run();
+		printf("%-12s %s\n", Tests[t].name, checkFailures() == failures ? "ok" : "FAILED");
+		++numRun;
+	}
+	
+	if(numRun == 0)
+	{
+		fprintf(stderr, "Usage: %s [test...]\n", argv[0]);
+		return 1;
+	}
+	return checkFailures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+#include <math.h>
+#include "engine/playerodds.h"
+#include "check.h"
+
+using engine::Composition;
+
+static const double Tolerance = 1e-9;
+
+/**
+ * Class that works out a hand by brute force, in the order the table 
+ * deals it: the hole card is drawn first and rounds with a dealer 
+ * Blackjack are left out, then the player plays knowing only the upcard 
+ * and the dealer draws to the end. Nothing is cached, so it is only fast 
+ * enough for hands that are close to standing.
+ */
+class BruteForce
+{
+public:
+	BruteForce(const engine::Variant &rules, int upcard, const Composition &shoe) : 
+	m_rules(rules), m_upcard(upcard), m_shoe(shoe)
+	{}
+	
+	/**
+	 * Member function that returns the EV of standing.
+	 */
+	double stand(int hardTotal, int numAces, int numCards)
+	{
+		int score = scoreOf(hardTotal, numAces);
+		return overHole(score, numCards == 2 && score == 21);
+	}
+	
+	/**
+	 * Member function that returns the EV of hitting once, then playing 
+	 * on optimally.
+	 */
+	double hit(int hardTotal, int numAces)
+	{
+		double noBlackjack = this->noBlackjack();
+		int total = m_shoe.total();
+		double ev = 0.0;
+		
+		// The odds of each card are those of the shoe as the player sees 
+		// it, given that the dealer turned out to have no Blackjack
+		for(int i = 0; i < Composition::NumValues; ++i)
+		{
+			int count = m_shoe.count(i);
+			if(count == 0)
+			{
+				continue;
+			}
+			m_shoe.remove(i);
+			double weight = static_cast<double>(count) / total * this->noBlackjack() / noBlackjack;
+			ev += best(hardTotal + i + 1, numAces + (i == 0)) * weight;
+			m_shoe.add(i);
+		}
+		return ev;
+	}
+	
+private:
+	static int scoreOf(int hardTotal, int numAces)
+	{
+		return hardTotal + (numAces != 0 && hardTotal <= 11 ? 10 : 0);
+	}
+	
+	double best(int hardTotal, int numAces)
+	{
+		double ev = stand(hardTotal, numAces, 3);
+		if(scoreOf(hardTotal, numAces) < 21)
+		{
+			double hit = this->hit(hardTotal, numAces);
+			ev = hit > ev ? hit : ev;
+		}
+		return ev;
+	}
+	
+	// Odds that the hole card does not make a dealer Blackjack
+	double noBlackjack() const
+	{
+		int blackjack = m_upcard == 0 ? Composition::TenIndex : m_upcard == Composition::TenIndex ? 0 : -1;
+		return blackjack < 0 ? 1.0 : 1.0 - static_cast<double>(m_shoe.count(blackjack)) / m_shoe.total();
+	}
+	
+	// Settles a final player score, 22 for a bust, over every hole card 
+	// that is not a Blackjack
+	double overHole(int score, bool blackjack)
+	{
+		int total = m_shoe.total();
+		double ev = 0.0;
+		double weight = 0.0;
+		
+		for(int i = 0; i < Composition::NumValues; ++i)
+		{
+			int count = m_shoe.count(i);
+			bool dealerBlackjack = (m_upcard == 0 && i == Composition::TenIndex) || 
+			                       (m_upcard == Composition::TenIndex && i == 0);
+			if(count == 0 || dealerBlackjack)
+			{
+				continue;
+			}
+			m_shoe.remove(i);
+			ev += dealer(m_upcard + i + 2, (m_upcard == 0) + (i == 0), score, blackjack) * count / total;
+			weight += static_cast<double>(count) / total;
+			m_shoe.add(i);
+		}
+		return ev / weight;
+	}
+	
+	// Plays out the dealer and settles against the player's score
+	double dealer(int hardTotal, int numAces, int score, bool blackjack)
+	{
+		bool soft = numAces != 0 && hardTotal <= 11;
+		int dealerScore = scoreOf(hardTotal, numAces);
+		
+		if(dealerScore > 17 || (dealerScore == 17 && !(m_rules.hitSoft17 && soft)))
+		{
+			if(score > 21)
+			{
+				return dealerScore > 21 && m_rules.bustPush ? 0.0 : -1.0;
+			}
+			if(blackjack)
+			{
+				return static_cast<double>(m_rules.blackjackNum) / m_rules.blackjackDen;
+			}
+			if(dealerScore > 21 || score > dealerScore)
+			{
+				return 1.0;
+			}
+			return score < dealerScore ? -1.0 : 0.0;
+		}
+		
+		int total = m_shoe.total();
+		double ev = 0.0;
+		for(int i = 0; i < Composition::NumValues; ++i)
+		{
+			int count = m_shoe.count(i);
+			if(count == 0)
+			{
+				continue;
+			}
+			m_shoe.remove(i);
+			ev += dealer(hardTotal + i + 1, numAces + (i == 0), score, blackjack) * count / total;
+			m_shoe.add(i);
+		}
+		return ev;
+	}
+	
+private:
+	const engine::Variant &m_rules;
+	int m_upcard;
+	Composition m_shoe;
+};
+
+/**
+ * Function that checks PlayerOdds::evaluate() against a brute force 
+ * play of the same hand, for every variant on a single deck.
+ */
+void testPlayerOdds()
+{
+	// Value indexes of the player's two cards and the upcard, 0 for an Ace
+	static const int Hands[][3] = {
+		{9, 5, 9}, {9, 5, 0}, {9, 5, 6}, {0, 5, 9}, {0, 5, 0}, {9, 1, 3}, {0, 9, 9}, {0, 9, 5}
+	};
+	
+	for(int v = 0; v < engine::NumVariants; ++v)
+	{
+		engine::DealerOdds dealer;
+		engine::PlayerOdds odds(dealer, v);
+		
+		for(size_t h = 0; h < sizeof(Hands) / sizeof(Hands[0]); ++h)
+		{
+			int first = Hands[h][0];
+			int second = Hands[h][1];
+			int upcard = Hands[h][2];
+			Composition shoe(1);
+			shoe.remove(first);
+			shoe.remove(second);
+			shoe.remove(upcard);
+			
+			int hardTotal = first + second + 2;
+			int numAces = (first == 0) + (second == 0);
+			engine::ActionEv ev = odds.evaluate(hardTotal, numAces, 2, upcard, shoe);
+			BruteForce expected(engine::Variants[v], upcard, shoe);
+			
+			CHECK(fabs(ev.stand - expected.stand(hardTotal, numAces, 2)) < Tolerance);
+			if(hardTotal + (numAces != 0 ? 10 : 0) < 21)
+			{
+				CHECK(fabs(ev.hit - expected.hit(hardTotal, numAces)) < Tolerance);
+			}
+		}
+	}
+}
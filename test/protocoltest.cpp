@@ -0,0 +1,133 @@
+#include <string.h>
+#include "engine/protocol.h"
+#include "engine/rng.h"
+#include "check.h"
+
+static const int NumRequests = 20000;
+
+/**
+ * Helper function that compares the cards of two hands.
+ * @param hidden Index of a card of expected that was sent face down, or -1
+ */
+static bool sameCards(const engine::Hand &actual, const engine::Hand &expected, int hidden = -1)
+{
+	if(actual.numCards() != expected.numCards() - (hidden >= 0 ? 1 : 0))
+	{
+		return false;
+	}
+	for(int i = 0, j = 0; i < expected.numCards(); ++i)
+	{
+		if(i != hidden && actual.card(j++).id() != expected.card(i).id())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Helper function that checks a state read back from the wire.
+ */
+static bool sameState(const engine::TableState &actual, const engine::TableState &expected)
+{
+	if(actual.status != expected.status || actual.flags != expected.flags ||
+	   actual.allowed != expected.allowed || actual.variant != expected.variant ||
+	   actual.balance != expected.balance || actual.bet != expected.bet ||
+	   actual.extraWager != expected.extraWager || actual.lastNet != expected.lastNet ||
+	   actual.rounds != expected.rounds || actual.advances != expected.advances ||
+	   actual.numHands != expected.numHands || actual.current != expected.current)
+	{
+		return false;
+	}
+	
+	// The hole card is sent face down and left out of the dealer
+	bool hidden = expected.holeHidden && expected.dealer.numCards() > 1;
+	if(actual.holeHidden != hidden || !sameCards(actual.dealer, expected.dealer, hidden ? 1 : -1))
+	{
+		return false;
+	}
+	for(int i = 0; i < expected.numHands; ++i)
+	{
+		if(actual.handFlags[i] != expected.handFlags[i] || actual.outcomes[i] != expected.outcomes[i] ||
+		   !sameCards(actual.hands[i], expected.hands[i]))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Function that plays a table with random requests, sends the state of 
+ * the table after each through encode() and decode() and checks that it 
+ * reads back the same, and that messages that are cut short, too long or 
+ * out of range are rejected.
+ */
+void testProtocol()
+{
+	engine::Rng chooser(7);
+	engine::Table table(engine::StripVariant, 11);
+	engine::TableState state;
+	engine::TableState read;
+	uint8_t wire[engine::TableState::MaxSize + 1];
+	
+	for(int r = 0; r < NumRequests; ++r)
+	{
+		// Mostly bets and plays, so that rounds get dealt and finished
+		engine::Request request;
+		uint8_t bytes[engine::Request::Size];
+		request.command = static_cast<uint8_t>(engine::CommandBet + engine::uniformBelow(chooser, 9));
+		request.argument = request.command == engine::CommandBet ? static_cast<int32_t>(engine::uniformBelow(chooser, 50)) : 0;
+		request.encode(bytes);
+		
+		engine::Request decoded;
+		decoded.decode(bytes);
+		CHECK(decoded.command == request.command && decoded.argument == request.argument);
+		
+		state.set(table, execute(table, decoded));
+		size_t size = state.encode(wire);
+		if(!CHECK(size <= engine::TableState::MaxSize) ||
+		   !CHECK(wire[0] + (wire[1] << 8) == static_cast<int>(size) - 2))
+		{
+			break;
+		}
+		if(!CHECK(read.decode(wire + 2, size - 2)) || !CHECK(sameState(read, state)))
+		{
+			break;
+		}
+		
+		// Cut short anywhere, or with a byte too many
+		bool rejected = true;
+		for(size_t n = 0; n < size - 2; ++n)
+		{
+			rejected = rejected && !read.decode(wire + 2, n);
+		}
+		CHECK(rejected);
+		wire[size] = 0;
+		CHECK(!read.decode(wire + 2, size - 1));
+	}
+	CHECK(table.rounds() > NumRequests / 100);
+	
+	// A state of a round being played, to corrupt one field at a time
+	table.newGame();
+	table.bet(10);
+	table.deal();
+	state.set(table, engine::ReplyOk);
+	size_t size = state.encode(wire);
+	const size_t DealerCount = 30;
+	uint8_t corrupt[engine::TableState::MaxSize];
+	
+	CHECK(read.decode(wire + 2, size - 2));
+	
+	memcpy(corrupt, wire, size);
+	corrupt[DealerCount + 1] = engine::Card::NumCards;
+	CHECK(!read.decode(corrupt + 2, size - 2));
+	
+	memcpy(corrupt, wire, size);
+	corrupt[DealerCount] = engine::Hand::MaxCards + 1;
+	CHECK(!read.decode(corrupt + 2, size - 2));
+	
+	memcpy(corrupt, wire, size);
+	corrupt[DealerCount + 1 + wire[DealerCount]] = engine::Round::MaxHands + 1;
+	CHECK(!read.decode(corrupt + 2, size - 2));
+}
@@ -0,0 +1,141 @@
+#include "engine/rng.h"
+#include "engine/round.h"
+#include "engine/ruleset.h"
+#include "check.h"
+
+static const int NumRounds = 50000;
+static const int Bet = 10;
+
+/**
+ * Helper function that works out what a played round pays from its hands, 
+ * the way the table pays them out.
+ */
+static int expectedNet(const engine::Round &round, const engine::Variant &rules)
+{
+	int net = 0;
+	
+	if(round.isInsured())
+	{
+		net += round.dealer().isBlackjack() ? Bet : -Bet / 2;
+	}
+	for(int h = 0; h < round.numHands(); ++h)
+	{
+		int wager = round.isDoubled(h) ? 2 * Bet : Bet;
+		bool blackjack = round.numHands() == 1 && round.player(h).isBlackjack();
+		
+		if(round.isSurrendered(h))
+		{
+			net -= Bet / 2;
+		}
+		else if(round.outcome(h) == engine::PlayerWins)
+		{
+			net += blackjack ? wager * rules.blackjackNum / rules.blackjackDen : wager;
+		}
+		else if(round.outcome(h) == engine::DealerWins)
+		{
+			net -= wager;
+		}
+	}
+	return net;
+}
+
+/**
+ * Function that plays rounds of every variant with random legal actions 
+ * and checks the hands they leave and what they pay: split hands start 
+ * with one card of the pair each, doubled hands get one card, surrendered 
+ * hands lose half, a Blackjack after a split pays even money and every 
+ * card of the round comes from the shoe.
+ */
+void testRound()
+{
+	engine::Rng rng(3);
+	engine::Rng chooser(4);
+	int splits = 0;
+	int fullSplits = 0;
+	int doubles = 0;
+	int surrenders = 0;
+	int insured = 0;
+	
+	for(int v = 0; v < engine::NumVariants; ++v)
+	{
+		const engine::Variant &rules = engine::Variants[v];
+		engine::Shoe shoe(rules.numDecks);
+		engine::Round round(shoe, rng);
+		shoe.shuffle(rng);
+		
+		for(int r = 0; r < NumRounds; ++r)
+		{
+			round.deal();
+			uint32_t shuffles = shoe.shuffleCount();
+			int cardsLeft = shoe.cardsLeft();
+			int pairPoints = round.player().card(0).points();
+			bool pair = pairPoints == round.player().card(1).points();
+			
+			if(round.canInsure() && engine::uniformBelow(chooser, 4) == 0)
+			{
+				round.insure();
+			}
+			while(!round.dealer().isBlackjack() && !round.done())
+			{
+				int numCards = round.player(round.current()).numCards();
+				int pick = static_cast<int>(engine::uniformBelow(chooser, 6));
+				if(pick <= 1 && round.canSplit(rules.resplitAces))
+				{
+					round.split();
+				}
+				else if(pick == 2 && round.canDouble(rules.doubleAfterSplit))
+				{
+					round.doubleDown();
+					CHECK(round.player(round.current() - 1).numCards() == numCards + 1);
+				}
+				else if(pick == 3 && round.canSurrender(rules.lateSurrender))
+				{
+					round.surrender();
+				}
+				else if(pick == 4 && round.canHit())
+				{
+					round.hit();
+				}
+				else
+				{
+					round.next();
+				}
+			}
+			int playerDrew = cardsLeft - shoe.cardsLeft();
+			cardsLeft = shoe.cardsLeft();
+			rules.stand(round);
+			int dealerDrew = cardsLeft - shoe.cardsLeft();
+			CHECK(rules.net(round, Bet) == expectedNet(round, rules));
+			
+			CHECK(round.numHands() <= engine::Round::MaxHands);
+			CHECK(round.numActions() <= engine::Round::MaxActions);
+			CHECK(round.numHands() == 1 || pair);
+			int numCards = 0;
+			for(int h = 0; h < round.numHands(); ++h)
+			{
+				const engine::Hand &hand = round.player(h);
+				numCards += hand.numCards();
+				CHECK(round.numHands() == 1 || hand.card(0).points() == pairPoints);
+				CHECK(!round.isDoubled(h) || hand.numCards() == 3);
+				CHECK(!round.isSurrendered(h) || round.outcome(h) == engine::DealerWins);
+				CHECK(!hand.busted() || rules.bustPush || round.outcome(h) == engine::DealerWins);
+			}
+			// Splitting moves a card instead of dealing one, so the hands 
+			// hold the two cards dealt and one for every card drawn since
+			if(shoe.shuffleCount() == shuffles)
+			{
+				CHECK(numCards == 2 + playerDrew);
+				CHECK(round.dealer().numCards() == 2 + dealerDrew);
+			}
+			
+			splits += round.numHands() > 1;
+			fullSplits += round.numHands() == engine::Round::MaxHands;
+			doubles += round.isDoubled(0);
+			surrenders += round.isSurrendered(0);
+			insured += round.isInsured();
+		}
+	}
+	
+	// The random play reached every rule
+	CHECK(splits > 0 && fullSplits > 0 && doubles > 0 && surrenders > 0 && insured > 0);
+}
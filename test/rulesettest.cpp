@@ -0,0 +1,82 @@
+#include "engine/ruleset.h"
+#include "check.h"
+
+using engine::Card;
+using engine::Hand;
+
+/**
+ * Helper function that builds a hand from ranks.
+ */
+static Hand handOf(Card::Rank first, Card::Rank second, int third = -1)
+{
+	Hand hand;
+	hand << Card(first, 0) << Card(second, 1);
+	if(third >= 0)
+	{
+		hand << Card(third, 2);
+	}
+	return hand;
+}
+
+/**
+ * Struct that checks one variant's RuleSet when visited.
+ */
+struct RuleSetCheck
+{
+	typedef void Result;
+	
+	int index;
+	
+	template<class Rules>
+	void visit()
+	{
+		const engine::Variant &variant = engine::Variants[index];
+		
+		// The run time description matches the compile time rules
+		CHECK(variant.numDecks == Rules::NumDecks);
+		CHECK(variant.hitSoft17 == Rules::HitSoft17);
+		CHECK(variant.blackjackNum == Rules::BlackjackNum);
+		CHECK(variant.blackjackDen == Rules::BlackjackDen);
+		CHECK(variant.lateSurrender == Rules::LateSurrender);
+		CHECK(variant.doubleAfterSplit == Rules::DoubleAfterSplit);
+		CHECK(variant.resplitAces == Rules::ResplitAces);
+		CHECK(variant.bustPush == Rules::BustPush);
+		CHECK(engine::findVariant(variant.name) == index);
+		
+		// The dealer always hits 16, and hits soft 17 only where the rules 
+		// say so
+		CHECK(Rules::dealerMustHit(handOf(Card::Ten, Card::Six)));
+		CHECK(!Rules::dealerMustHit(handOf(Card::Ten, Card::Seven)));
+		CHECK(Rules::dealerMustHit(handOf(Card::Ace, Card::Six)) == Rules::HitSoft17);
+		CHECK(Rules::dealerMustHit(handOf(Card::Ace, Card::Two, Card::Four)) == Rules::HitSoft17);
+		CHECK(!Rules::dealerMustHit(handOf(Card::Ace, Card::Seven)));
+		
+		// Two busts push only where the rules say so; a Blackjack pays 
+		// the variant's odds, rounded down, but not after a split
+		Hand bust = handOf(Card::Ten, Card::Six, Card::King);
+		Hand blackjack = handOf(Card::Ace, Card::King);
+		Hand twenty = handOf(Card::Ten, Card::Queen);
+		CHECK(Rules::resolve(bust, bust) == (Rules::BustPush ? engine::Push : engine::DealerWins));
+		CHECK(Rules::resolve(bust, twenty) == engine::DealerWins);
+		CHECK(Rules::resolve(blackjack, twenty) == engine::PlayerWins);
+		CHECK(Rules::resolve(blackjack, twenty, true) == engine::PlayerWins);
+		CHECK(Rules::win(25, true) == 25 * Rules::BlackjackNum / Rules::BlackjackDen);
+		CHECK(Rules::win(25, false) == 25);
+	}
+};
+
+/**
+ * Function that checks every variant's RuleSet against its run time 
+ * description and the rules it stands for.
+ */
+void testRuleSet()
+{
+	for(int v = 0; v < engine::NumVariants; ++v)
+	{
+		RuleSetCheck check = {v};
+		engine::visitVariant(v, check);
+	}
+	CHECK(engine::findVariant("blackjack") == -1);
+	CHECK(engine::SixToFiveRules::win(10, true) == 12);
+	CHECK(engine::StripRules::win(10, true) == 15);
+}
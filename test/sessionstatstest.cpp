@@ -0,0 +1,70 @@
+#include <math.h>
+#include <vector>
+#include "engine/rng.h"
+#include "engine/sessionstats.h"
+#include "check.h"
+
+/**
+ * Helper function that works out the sample mean and variance in two 
+ * passes, in long double, to check the running ones against.
+ */
+static void twoPass(const std::vector<double> &values, double &mean, double &variance)
+{
+	long double sum = 0.0;
+	for(size_t i = 0; i < values.size(); ++i)
+	{
+		sum += values[i];
+	}
+	long double m = sum / values.size();
+	long double squares = 0.0;
+	for(size_t i = 0; i < values.size(); ++i)
+	{
+		squares += (values[i] - m) * (values[i] - m);
+	}
+	mean = static_cast<double>(m);
+	variance = static_cast<double>(squares / (values.size() - 1));
+}
+
+/**
+ * Function that checks the counts and streaks of a short session, and 
+ * the running mean and variance of long ones against two passes, also 
+ * when every result is far from 0. There summing squares in double is 
+ * off by a factor of four; Welford's update stays within 1e-7.
+ */
+void testSessionStats()
+{
+	engine::SessionStats stats;
+	CHECK(stats.variance() == 0.0 && stats.winRate() == 0.0);
+	
+	// Won, won, Blackjack, lost three, pushed, won
+	static const int Nets[] = {10, 10, 15, -10, -20, -10, 0, 10};
+	for(size_t i = 0; i < sizeof(Nets) / sizeof(Nets[0]); ++i)
+	{
+		stats.add(Nets[i], 10, Nets[i] == 15);
+	}
+	CHECK(stats.hands == 8 && stats.wins == 4 && stats.losses == 3 && stats.pushes == 1);
+	CHECK(stats.blackjacks == 1 && stats.net == 5);
+	CHECK(stats.longestWinStreak == 3 && stats.longestLossStreak == 3 && stats.streak == 1);
+	CHECK(fabs(stats.winRate() - 0.5) < 1e-15);
+	CHECK(fabs(stats.meanEv - 0.0625) < 1e-15);
+	
+	engine::Rng rng(5);
+	for(int offset = 0; offset <= 100000000; offset += 100000000)
+	{
+		engine::SessionStats session;
+		std::vector<double> values;
+		for(int i = 0; i < 1000000; ++i)
+		{
+			int net = offset + static_cast<int>(engine::uniformBelow(rng, 7)) - 3;
+			session.add(net, 2, false);
+			values.push_back(net / 2.0);
+		}
+		
+		double mean;
+		double variance;
+		twoPass(values, mean, variance);
+		CHECK(fabs(session.meanEv - mean) <= 1e-9 * fabs(mean) + 1e-12);
+		CHECK(fabs(session.variance() - variance) < 1e-6 * variance);
+		CHECK(fabs(session.standardDeviation() - sqrt(variance)) < 1e-6 * sqrt(variance));
+	}
+}
@@ -0,0 +1,54 @@
+#include <math.h>
+#include "sim/simulator.h"
+#include "check.h"
+
+static const uint64_t NumRounds = 400000;
+
+/**
+ * Helper function that checks that a tally adds up.
+ */
+static void checkTally(const SimResult &result, uint64_t rounds)
+{
+	uint64_t counted = 0;
+	for(int i = 0; i < SimResult::NumTrueCounts; ++i)
+	{
+		counted += result.countRounds[i];
+	}
+	CHECK(result.rounds == rounds);
+	CHECK(result.playerWins + result.dealerWins + result.pushes == rounds);
+	CHECK(counted == rounds);
+}
+
+/**
+ * Function that checks that a simulation is the same for the same seed 
+ * and number of threads, that its tallies add up and that basic strategy 
+ * gives the known house edge, far below that of hitting to 17.
+ */
+void testSimulator()
+{
+	Simulator hitTo17(17, engine::StripVariant);
+	Simulator basic(17, engine::StripVariant);
+	basic.setBasicStrategy(true);
+	
+	SimResult first = basic.run(NumRounds, 4, 42);
+	SimResult second = basic.run(NumRounds, 4, 42);
+	checkTally(first, NumRounds);
+	CHECK(first.net == second.net && first.netSquares == second.netSquares);
+	CHECK(first.playerWins == second.playerWins && first.splits == second.splits);
+	CHECK(first.doubles > 0 && first.splits > 0 && first.surrenders > 0);
+	
+	// The rounds are spread over the threads, including the remainder
+	SimResult odd = basic.run(NumRounds + 3, 4, 42);
+	checkTally(odd, NumRounds + 3);
+	
+	// Hitting to 17 costs some 5% more than basic strategy, which is many
+	// standard errors at this many rounds
+	SimResult naive = hitTo17.run(NumRounds, 4, 42);
+	checkTally(naive, NumRounds);
+	CHECK(naive.doubles == 0 && naive.splits == 0 && naive.surrenders == 0);
+	CHECK(naive.houseEdge() - first.houseEdge() > 
+	      5 * sqrt(naive.standardError() * naive.standardError() + first.standardError() * first.standardError()));
+	
+	// Basic strategy gives up about 0.3% under these rules
+	CHECK(fabs(first.houseEdge() - 0.003) < 5 * first.standardError());
+}
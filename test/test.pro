@@ -0,0 +1,19 @@
+######################################################################
+# Engine tests - no Qt dependency
+######################################################################
+
+TEMPLATE = app
+CONFIG += console
+CONFIG -= qt app_bundle
+TARGET = blackjack-test
+DEPENDPATH += .
+INCLUDEPATH += . ..
+QMAKE_CXXFLAGS += -std=c++11
+
+# Game engine static library - build ../engine/engine.pro first
+LIBS += -L../engine -lengine
+PRE_TARGETDEPS += ../engine/libengine.a
+
+# Input
+HEADERS += ../sim/basicstrategy.h ../sim/simulator.h check.h
+SOURCES += ../sim/basicstrategy.cpp ../sim/simulator.cpp check.cpp dealeroddstest.cpp handbatchtest.cpp handlogtest.cpp journaltest.cpp main.cpp playeroddstest.cpp protocoltest.cpp roundtest.cpp rulesettest.cpp sessionstatstest.cpp simulatortest.cpp